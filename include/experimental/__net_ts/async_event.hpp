@@ -0,0 +1,209 @@
+//
+// async_event.hpp
+// ~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_ASYNC_EVENT_HPP
+#define NET_TS_ASYNC_EVENT_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <experimental/__net_ts/async_result.hpp>
+#include <experimental/__net_ts/io_context.hpp>
+#include <experimental/__net_ts/detail/async_event_impl.hpp>
+#include <experimental/__net_ts/detail/handler_type_requirements.hpp>
+#include <experimental/__net_ts/detail/memory.hpp>
+#include <experimental/__net_ts/detail/noncopyable.hpp>
+#include <experimental/__net_ts/detail/wait_handler.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+
+/// An event that suspends handlers rather than threads.
+/**
+ * The async_event class lets handlers wait for a condition to become true,
+ * such as a resource becoming available, without blocking a thread. The
+ * event is either set or reset. While it is set, asynchronous waits complete
+ * immediately. Setting the event wakes all waiting handlers. Waiting handlers
+ * may also be woken without setting the event, using notify_one() or
+ * notify_all(), to use the event as a condition variable.
+ *
+ * Waiting handlers are woken in the order in which they started to wait.
+ *
+ * Each wait uses the memory allocated for its handler as the waiter's queue
+ * node. The handler is invoked using its associated executor.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Safe.
+ *
+ * @par Example
+ * @code
+ * std::experimental::net::async_event ready(io_context);
+ *
+ * ...
+ *
+ * ready.async_wait(
+ *     [&](const std::error_code& error)
+ *     {
+ *       if (!error)
+ *       {
+ *         // The event was set or notified.
+ *       }
+ *     });
+ *
+ * ...
+ *
+ * ready.set();
+ * @endcode
+ */
+class async_event
+  : private noncopyable
+{
+public:
+  /// The type of the executor associated with the object.
+  typedef io_context::executor_type executor_type;
+
+  /// Constructor.
+  /**
+   * @param io_context The io_context object that the event will use to
+   * dispatch handlers.
+   *
+   * @param initially_set Whether the event is initially set.
+   */
+  explicit async_event(std::experimental::net::v1::io_context& io_context,
+      bool initially_set = false)
+    : io_context_(io_context),
+      impl_(io_context, initially_set)
+  {
+  }
+
+  /// Destructor.
+  /**
+   * The handler for each outstanding wait is invoked with the
+   * std::experimental::net::v1::error::operation_aborted error code.
+   */
+  ~async_event()
+  {
+  }
+
+  /// Get the executor associated with the object.
+  executor_type get_executor() NET_TS_NOEXCEPT
+  {
+    return io_context_.get_executor();
+  }
+
+  /// Start an asynchronous wait for the event.
+  /**
+   * This function always returns immediately.
+   *
+   * @param handler The handler to be called when the event is set or
+   * notified, or the wait is cancelled. Copies will be made of the handler as
+   * required. The function signature of the handler must be:
+   * @code void handler(
+   *   const std::error_code& error // Result of operation.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function.
+   * Invocation of the handler will be performed in a manner equivalent to
+   * using std::experimental::net::v1::io_context::post().
+   */
+  template <typename WaitHandler>
+  NET_TS_INITFN_RESULT_TYPE(WaitHandler,
+      void (std::error_code))
+  async_wait(NET_TS_MOVE_ARG(WaitHandler) handler)
+  {
+    // If you get an error on the following line it means that your handler does
+    // not meet the documented type requirements for a WaitHandler.
+    NET_TS_WAIT_HANDLER_CHECK(WaitHandler, handler) type_check;
+
+    async_completion<WaitHandler,
+      void (std::error_code)> init(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef detail::wait_handler<typename async_completion<WaitHandler,
+      void (std::error_code)>::completion_handler_type> op;
+    typename op::ptr p = { detail::addressof(init.completion_handler),
+      op::ptr::allocate(init.completion_handler), 0 };
+    p.p = new (p.v) op(init.completion_handler);
+
+    impl_.start_wait(p.p);
+    p.v = p.p = 0;
+
+    return init.result.get();
+  }
+
+  /// Set the event, waking all waiting handlers.
+  void set()
+  {
+    impl_.set();
+  }
+
+  /// Reset the event.
+  void reset()
+  {
+    impl_.reset();
+  }
+
+  /// Determine whether the event is set.
+  bool is_set() const
+  {
+    return impl_.is_set();
+  }
+
+  /// Wake the first waiting handler, if any, without setting the event.
+  /**
+   * @return The number of handlers woken. That is, either 0 or 1.
+   */
+  std::size_t notify_one()
+  {
+    return impl_.notify(1);
+  }
+
+  /// Wake all waiting handlers without setting the event.
+  /**
+   * @return The number of handlers woken.
+   */
+  std::size_t notify_all()
+  {
+    return impl_.notify(static_cast<std::size_t>(-1));
+  }
+
+  /// Cancel all outstanding waits.
+  /**
+   * The handler for each cancelled wait is invoked with the
+   * std::experimental::net::v1::error::operation_aborted error code.
+   *
+   * @return The number of asynchronous operations that were cancelled.
+   */
+  std::size_t cancel()
+  {
+    return impl_.cancel();
+  }
+
+private:
+  std::experimental::net::v1::io_context& io_context_;
+  detail::async_event_impl impl_;
+};
+
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_ASYNC_EVENT_HPP
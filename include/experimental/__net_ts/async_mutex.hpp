@@ -0,0 +1,192 @@
+//
+// async_mutex.hpp
+// ~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_ASYNC_MUTEX_HPP
+#define NET_TS_ASYNC_MUTEX_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <experimental/__net_ts/async_result.hpp>
+#include <experimental/__net_ts/io_context.hpp>
+#include <experimental/__net_ts/detail/assert.hpp>
+#include <experimental/__net_ts/detail/async_semaphore_impl.hpp>
+#include <experimental/__net_ts/detail/handler_type_requirements.hpp>
+#include <experimental/__net_ts/detail/memory.hpp>
+#include <experimental/__net_ts/detail/noncopyable.hpp>
+#include <experimental/__net_ts/detail/wait_handler.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+
+/// A mutual exclusion lock that suspends handlers rather than threads.
+/**
+ * The async_mutex class serialises handlers that use a shared resource
+ * without blocking a thread while they wait. An asynchronous lock completes
+ * once the mutex has been locked on the handler's behalf. The handler must
+ * later call unlock(), possibly from a different handler.
+ *
+ * Waiting handlers acquire the lock in the order in which they started to
+ * wait. When the mutex is unlocked with handlers waiting, ownership passes
+ * directly to the first of them, so a later call to async_lock() or
+ * try_lock() cannot overtake it.
+ *
+ * Each wait uses the memory allocated for its handler as the waiter's queue
+ * node. The handler is invoked using its associated executor.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Safe.
+ *
+ * @par Example
+ * @code
+ * std::experimental::net::async_mutex mutex(io_context);
+ *
+ * ...
+ *
+ * mutex.async_lock(
+ *     [&](const std::error_code& error)
+ *     {
+ *       if (!error)
+ *       {
+ *         // Use the resource, then call mutex.unlock().
+ *       }
+ *     });
+ * @endcode
+ */
+class async_mutex
+  : private noncopyable
+{
+public:
+  /// The type of the executor associated with the object.
+  typedef io_context::executor_type executor_type;
+
+  /// Constructor.
+  /**
+   * @param io_context The io_context object that the mutex will use to
+   * dispatch handlers.
+   */
+  explicit async_mutex(std::experimental::net::v1::io_context& io_context)
+    : io_context_(io_context),
+      impl_(io_context, 1)
+  {
+  }
+
+  /// Destructor.
+  /**
+   * The handler for each outstanding lock is invoked with the
+   * std::experimental::net::v1::error::operation_aborted error code.
+   */
+  ~async_mutex()
+  {
+  }
+
+  /// Get the executor associated with the object.
+  executor_type get_executor() NET_TS_NOEXCEPT
+  {
+    return io_context_.get_executor();
+  }
+
+  /// Start an asynchronous lock.
+  /**
+   * This function always returns immediately.
+   *
+   * @param handler The handler to be called when the mutex has been locked or
+   * the lock is cancelled. Copies will be made of the handler as required.
+   * The function signature of the handler must be:
+   * @code void handler(
+   *   const std::error_code& error // Result of operation.
+   * ); @endcode
+   * If @c error is clear the handler owns the lock. Regardless of whether the
+   * asynchronous operation completes immediately or not, the handler will not
+   * be invoked from within this function. Invocation of the handler will be
+   * performed in a manner equivalent to using
+   * std::experimental::net::v1::io_context::post().
+   */
+  template <typename LockHandler>
+  NET_TS_INITFN_RESULT_TYPE(LockHandler,
+      void (std::error_code))
+  async_lock(NET_TS_MOVE_ARG(LockHandler) handler)
+  {
+    // If you get an error on the following line it means that your handler does
+    // not meet the documented type requirements for a WaitHandler.
+    NET_TS_WAIT_HANDLER_CHECK(LockHandler, handler) type_check;
+
+    async_completion<LockHandler,
+      void (std::error_code)> init(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef detail::wait_handler<typename async_completion<LockHandler,
+      void (std::error_code)>::completion_handler_type> op;
+    typename op::ptr p = { detail::addressof(init.completion_handler),
+      op::ptr::allocate(init.completion_handler), 0 };
+    p.p = new (p.v) op(init.completion_handler);
+
+    impl_.start_acquire(p.p);
+    p.v = p.p = 0;
+
+    return init.result.get();
+  }
+
+  /// Lock the mutex without waiting.
+  /**
+   * @returns @c true if the mutex was locked.
+   */
+  bool try_lock()
+  {
+    return impl_.try_acquire();
+  }
+
+  /// Unlock the mutex.
+  /**
+   * If there are outstanding locks, ownership passes to the first of them.
+   * The mutex must be locked. Unlocking a mutex that is not locked has no
+   * effect, and fails an assertion in debug builds.
+   */
+  void unlock()
+  {
+    bool unlocked = impl_.release_one(1);
+    NET_TS_ASSERT(unlocked);
+    (void)unlocked;
+  }
+
+  /// Cancel all outstanding locks.
+  /**
+   * The handler for each cancelled lock is invoked with the
+   * std::experimental::net::v1::error::operation_aborted error code. The
+   * mutex remains locked by its current owner.
+   *
+   * @return The number of asynchronous operations that were cancelled.
+   */
+  std::size_t cancel()
+  {
+    return impl_.cancel();
+  }
+
+private:
+  std::experimental::net::v1::io_context& io_context_;
+  detail::async_semaphore_impl impl_;
+};
+
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_ASYNC_MUTEX_HPP
@@ -0,0 +1,198 @@
+//
+// async_semaphore.hpp
+// ~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_ASYNC_SEMAPHORE_HPP
+#define NET_TS_ASYNC_SEMAPHORE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <experimental/__net_ts/async_result.hpp>
+#include <experimental/__net_ts/io_context.hpp>
+#include <experimental/__net_ts/detail/async_semaphore_impl.hpp>
+#include <experimental/__net_ts/detail/handler_type_requirements.hpp>
+#include <experimental/__net_ts/detail/memory.hpp>
+#include <experimental/__net_ts/detail/noncopyable.hpp>
+#include <experimental/__net_ts/detail/wait_handler.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+
+/// A counting semaphore that suspends handlers rather than threads.
+/**
+ * The async_semaphore class limits the number of handlers that may use a
+ * shared resource, such as a pool of connections or a rate budget, at the
+ * same time. An asynchronous acquire completes once a unit of the resource
+ * has been acquired on the handler's behalf. The handler must later return
+ * the unit by calling release().
+ *
+ * Waiting handlers are served in the order in which they started to wait. A
+ * released unit is handed directly to the first waiter, so a later call to
+ * async_acquire() or try_acquire() cannot overtake it.
+ *
+ * Each wait uses the memory allocated for its handler as the waiter's queue
+ * node. The handler is invoked using its associated executor.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Safe.
+ *
+ * @par Example
+ * @code
+ * std::experimental::net::async_semaphore slots(io_context, 8);
+ *
+ * ...
+ *
+ * slots.async_acquire(
+ *     [&](const std::error_code& error)
+ *     {
+ *       if (!error)
+ *       {
+ *         // Use the resource, then call slots.release().
+ *       }
+ *     });
+ * @endcode
+ */
+class async_semaphore
+  : private noncopyable
+{
+public:
+  /// The type of the executor associated with the object.
+  typedef io_context::executor_type executor_type;
+
+  /// Constructor.
+  /**
+   * @param io_context The io_context object that the semaphore will use to
+   * dispatch handlers.
+   *
+   * @param initial_count The number of units initially available.
+   */
+  async_semaphore(std::experimental::net::v1::io_context& io_context,
+      std::size_t initial_count)
+    : io_context_(io_context),
+      impl_(io_context, initial_count)
+  {
+  }
+
+  /// Destructor.
+  /**
+   * The handler for each outstanding acquire is invoked with the
+   * std::experimental::net::v1::error::operation_aborted error code.
+   */
+  ~async_semaphore()
+  {
+  }
+
+  /// Get the executor associated with the object.
+  executor_type get_executor() NET_TS_NOEXCEPT
+  {
+    return io_context_.get_executor();
+  }
+
+  /// Start an asynchronous acquire of one unit.
+  /**
+   * This function always returns immediately.
+   *
+   * @param handler The handler to be called when a unit has been acquired or
+   * the acquire is cancelled. Copies will be made of the handler as required.
+   * The function signature of the handler must be:
+   * @code void handler(
+   *   const std::error_code& error // Result of operation.
+   * ); @endcode
+   * If @c error is clear the handler owns a unit. Regardless of whether the
+   * asynchronous operation completes immediately or not, the handler will not
+   * be invoked from within this function. Invocation of the handler will be
+   * performed in a manner equivalent to using
+   * std::experimental::net::v1::io_context::post().
+   */
+  template <typename AcquireHandler>
+  NET_TS_INITFN_RESULT_TYPE(AcquireHandler,
+      void (std::error_code))
+  async_acquire(NET_TS_MOVE_ARG(AcquireHandler) handler)
+  {
+    // If you get an error on the following line it means that your handler does
+    // not meet the documented type requirements for a WaitHandler.
+    NET_TS_WAIT_HANDLER_CHECK(AcquireHandler, handler) type_check;
+
+    async_completion<AcquireHandler,
+      void (std::error_code)> init(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef detail::wait_handler<typename async_completion<AcquireHandler,
+      void (std::error_code)>::completion_handler_type> op;
+    typename op::ptr p = { detail::addressof(init.completion_handler),
+      op::ptr::allocate(init.completion_handler), 0 };
+    p.p = new (p.v) op(init.completion_handler);
+
+    impl_.start_acquire(p.p);
+    p.v = p.p = 0;
+
+    return init.result.get();
+  }
+
+  /// Acquire one unit without waiting.
+  /**
+   * @returns @c true if a unit was acquired.
+   */
+  bool try_acquire()
+  {
+    return impl_.try_acquire();
+  }
+
+  /// Release units.
+  /**
+   * Each unit is handed to the first outstanding acquire, if any, or otherwise
+   * made available.
+   *
+   * @param n The number of units to release.
+   */
+  void release(std::size_t n = 1)
+  {
+    impl_.release(n);
+  }
+
+  /// Get the number of units available.
+  std::size_t count() const
+  {
+    return impl_.count();
+  }
+
+  /// Cancel all outstanding acquires.
+  /**
+   * The handler for each cancelled acquire is invoked with the
+   * std::experimental::net::v1::error::operation_aborted error code.
+   *
+   * @return The number of asynchronous operations that were cancelled.
+   */
+  std::size_t cancel()
+  {
+    return impl_.cancel();
+  }
+
+private:
+  std::experimental::net::v1::io_context& io_context_;
+  detail::async_semaphore_impl impl_;
+};
+
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_ASYNC_SEMAPHORE_HPP
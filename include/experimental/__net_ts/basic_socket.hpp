@@ -18,6 +18,7 @@
 #include <experimental/__net_ts/detail/config.hpp>
 #include <experimental/__net_ts/async_result.hpp>
 #include <experimental/__net_ts/basic_io_object.hpp>
+#include <experimental/__net_ts/detail/cstdint.hpp>
 #include <experimental/__net_ts/detail/handler_type_requirements.hpp>
 #include <experimental/__net_ts/detail/throw_error.hpp>
 #include <experimental/__net_ts/detail/type_traits.hpp>
@@ -25,6 +26,10 @@
 #include <experimental/__net_ts/post.hpp>
 #include <experimental/__net_ts/socket_base.hpp>
 
+#if defined(NET_TS_HAS_CHRONO)
+# include <experimental/__net_ts/detail/chrono.hpp>
+#endif // defined(NET_TS_HAS_CHRONO)
+
 #if defined(NET_TS_HAS_MOVE)
 # include <utility>
 #endif // defined(NET_TS_HAS_MOVE)
@@ -1122,6 +1127,156 @@ public:
     NET_TS_SYNC_OP_VOID_RETURN(ec);
   }
 
+  /// Gets whether operations that complete immediately invoke their handlers
+  /// inline.
+  /**
+   * @returns @c true if an asynchronous operation on the socket that is able
+   * to complete as soon as it is started invokes its handler before the
+   * initiating function returns.
+   */
+  bool inline_completion() const
+  {
+    return this->get_service().inline_completion(this->get_implementation());
+  }
+
+  /// Sets whether operations that complete immediately invoke their handlers
+  /// inline.
+  /**
+   * When enabled, an asynchronous operation on the socket that is able to
+   * complete as soon as it is started, for example a receive for which data
+   * is already available, invokes its handler before the initiating function
+   * returns, provided that the initiating function is called from a thread
+   * running the io_context. Nesting is bounded by
+   * io_context::inline_completion_depth(), beyond which handlers are queued
+   * as usual. See io_context::inline_completion() for details.
+   *
+   * @param mode @c true to enable inline completion for the socket.
+   *
+   * @throws std::system_error Thrown on failure.
+   */
+  void inline_completion(bool mode)
+  {
+    std::error_code ec;
+    this->get_service().inline_completion(
+        this->get_implementation(), mode, ec);
+    std::experimental::net::v1::detail::throw_error(ec, "inline_completion");
+  }
+
+  /// Sets whether operations that complete immediately invoke their handlers
+  /// inline.
+  /**
+   * When enabled, an asynchronous operation on the socket that is able to
+   * complete as soon as it is started, for example a receive for which data
+   * is already available, invokes its handler before the initiating function
+   * returns, provided that the initiating function is called from a thread
+   * running the io_context. Nesting is bounded by
+   * io_context::inline_completion_depth(), beyond which handlers are queued
+   * as usual. See io_context::inline_completion() for details.
+   *
+   * @param mode @c true to enable inline completion for the socket.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   */
+  NET_TS_SYNC_OP_VOID inline_completion(
+      bool mode, std::error_code& ec)
+  {
+    this->get_service().inline_completion(
+        this->get_implementation(), mode, ec);
+    NET_TS_SYNC_OP_VOID_RETURN(ec);
+  }
+
+#if defined(NET_TS_HAS_CHRONO) || defined(GENERATING_DOCUMENTATION)
+  /// Gets the timeout for asynchronous operations on the socket.
+  /**
+   * @returns The timeout set by operation_timeout(), or zero if operations on
+   * the socket do not time out.
+   */
+  chrono::microseconds operation_timeout() const
+  {
+    return chrono::microseconds(static_cast<chrono::microseconds::rep>(
+          this->get_service().operation_timeout(this->get_implementation())));
+  }
+
+  /// Sets the timeout for asynchronous operations on the socket.
+  /**
+   * An asynchronous operation on the socket, such as a receive, send, accept
+   * or connect, that is still waiting for the socket to become ready when the
+   * timeout elapses fails with the error
+   * std::experimental::net::v1::error::timed_out. Other operations on the
+   * socket are not affected. Deadlines are tracked by the io_context, so no
+   * timer object or additional handler is needed.
+   *
+   * The timeout applies to operations started after it is set. It is cleared
+   * when the socket is closed.
+   *
+   * @param timeout The timeout. A zero timeout disables it.
+   *
+   * @throws std::system_error Thrown on failure. If the platform does not
+   * support operation timeouts, the error is
+   * std::experimental::net::v1::error::operation_not_supported.
+   *
+   * @par Example
+   * @code
+   * std::experimental::net::ip::tcp::socket socket(io_context);
+   * ...
+   * socket.operation_timeout(std::chrono::seconds(30));
+   * socket.async_read_some(buffer, [](std::error_code ec, std::size_t n)
+   *     {
+   *       if (ec == std::experimental::net::error::timed_out)
+   *       {
+   *         // No data arrived within 30 seconds.
+   *       }
+   *     });
+   * @endcode
+   */
+  template <typename Rep, typename Period>
+  void operation_timeout(const chrono::duration<Rep, Period>& timeout)
+  {
+    std::error_code ec;
+    operation_timeout(timeout, ec);
+    std::experimental::net::v1::detail::throw_error(ec, "operation_timeout");
+  }
+
+  /// Sets the timeout for asynchronous operations on the socket.
+  /**
+   * An asynchronous operation on the socket, such as a receive, send, accept
+   * or connect, that is still waiting for the socket to become ready when the
+   * timeout elapses fails with the error
+   * std::experimental::net::v1::error::timed_out. Other operations on the
+   * socket are not affected. Deadlines are tracked by the io_context, so no
+   * timer object or additional handler is needed.
+   *
+   * The timeout applies to operations started after it is set. It is cleared
+   * when the socket is closed.
+   *
+   * @param timeout The timeout. A zero timeout disables it.
+   *
+   * @param ec Set to indicate what error occurred, if any. If the platform
+   * does not support operation timeouts, the error is
+   * std::experimental::net::v1::error::operation_not_supported.
+   */
+  template <typename Rep, typename Period>
+  NET_TS_SYNC_OP_VOID operation_timeout(
+      const chrono::duration<Rep, Period>& timeout, std::error_code& ec)
+  {
+    if (timeout < chrono::duration<Rep, Period>::zero())
+    {
+      ec = std::experimental::net::v1::error::invalid_argument;
+      NET_TS_SYNC_OP_VOID_RETURN(ec);
+    }
+
+    // Round up, so that a small non-zero timeout does not disable timeouts.
+    chrono::microseconds usec =
+      chrono::duration_cast<chrono::microseconds>(timeout);
+    if (usec < timeout)
+      usec += chrono::microseconds(1);
+
+    this->get_service().set_operation_timeout(this->get_implementation(),
+        static_cast<uint64_t>(usec.count()), ec);
+    NET_TS_SYNC_OP_VOID_RETURN(ec);
+  }
+#endif // defined(NET_TS_HAS_CHRONO) || defined(GENERATING_DOCUMENTATION)
+
   /// Gets the non-blocking mode of the native socket implementation.
   /**
    * This function is used to retrieve the non-blocking mode of the underlying
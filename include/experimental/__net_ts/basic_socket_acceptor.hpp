@@ -26,6 +26,7 @@
 
 #if defined(NET_TS_HAS_MOVE)
 # include <utility>
+# include <vector>
 #endif // defined(NET_TS_HAS_MOVE)
 
 #if defined(NET_TS_WINDOWS_RUNTIME)
@@ -621,6 +622,77 @@ public:
     NET_TS_SYNC_OP_VOID_RETURN(ec);
   }
 
+  /// Set whether a new connection wakes only one waiting io_context.
+  /**
+   * A listening socket may be shared by several io_contexts, each with its
+   * own acceptor for a duplicate of the socket's native handle. By default,
+   * every io_context with a pending accept is woken when a connection
+   * arrives, although only one of them can accept it. When exclusive wakeups
+   * are enabled on every acceptor, only one io_context is woken for each new
+   * connection.
+   *
+   * Unlike opening a separate listening socket per io_context with
+   * SO_REUSEPORT, connections waiting in the shared backlog are not lost when
+   * one io_context stops accepting.
+   *
+   * While exclusive wakeups are enabled, the acceptor does not support
+   * waiting for writability or for out-of-band data.
+   *
+   * The kernel may choose any io_context registered for the socket, whether
+   * or not it has an accept pending. An io_context woken without a pending
+   * accept consumes the wakeup, and the connection stays in the backlog until
+   * that acceptor next starts an accept or another connection arrives. Every
+   * acceptor sharing the socket must therefore keep an accept outstanding
+   * at all times, for example by starting the next accept from the handler
+   * of the previous one. To stop accepting on one io_context, disable
+   * exclusive wakeups on its acceptor or close it.
+   *
+   * @param enable Whether exclusive wakeups are to be enabled.
+   *
+   * @throws std::system_error Thrown on failure. Exclusive wakeups require
+   * epoll on Linux 4.5 or later. On other platforms, the error is
+   * std::experimental::net::v1::error::operation_not_supported.
+   *
+   * @par Example
+   * @code
+   * std::experimental::net::ip::tcp::acceptor acceptor1(io_context1, endpoint);
+   * acceptor1.set_exclusive_wakeup(true);
+   *
+   * std::experimental::net::ip::tcp::acceptor acceptor2(io_context2,
+   *     endpoint.protocol(), ::dup(acceptor1.native_handle()));
+   * acceptor2.set_exclusive_wakeup(true);
+   * @endcode
+   */
+  void set_exclusive_wakeup(bool enable)
+  {
+    std::error_code ec;
+    this->get_service().set_exclusive_wakeup(
+        this->get_implementation(), enable, ec);
+    std::experimental::net::v1::detail::throw_error(ec, "set_exclusive_wakeup");
+  }
+
+  /// Set whether a new connection wakes only one waiting io_context.
+  /**
+   * A listening socket may be shared by several io_contexts, each with its
+   * own acceptor for a duplicate of the socket's native handle. When exclusive
+   * wakeups are enabled on every acceptor, only one io_context is woken for
+   * each new connection. Every acceptor sharing the socket must then keep an
+   * accept outstanding at all times, as a wakeup delivered to an io_context
+   * with no accept pending is not passed on to another.
+   *
+   * @param enable Whether exclusive wakeups are to be enabled.
+   *
+   * @param ec Set to indicate what error occurred, if any. Set to
+   * std::experimental::net::v1::error::operation_not_supported on platforms
+   * that do not support exclusive wakeups.
+   */
+  NET_TS_SYNC_OP_VOID set_exclusive_wakeup(bool enable, std::error_code& ec)
+  {
+    this->get_service().set_exclusive_wakeup(
+        this->get_implementation(), enable, ec);
+    NET_TS_SYNC_OP_VOID_RETURN(ec);
+  }
+
   /// Set an option on the acceptor.
   /**
    * This function is used to set an option on the acceptor.
@@ -1619,7 +1691,180 @@ public:
 
     return init.result.get();
   }
+
+  /// Start an asynchronous accept of a batch of new connections.
+  /**
+   * This function is used to asynchronously accept the connections that are
+   * waiting to be accepted. The function call always returns immediately.
+   *
+   * When the acceptor becomes ready, connections are accepted until none
+   * remain to be accepted or @c max_connections have been accepted. The
+   * handler then receives them all at once, rather than the acceptor waiting
+   * for readiness again between connections. To keep accepting, start another
+   * batch from within the handler.
+   *
+   * The new sockets use the acceptor's io_context.
+   *
+   * This overload requires that the Protocol template parameter satisfy the
+   * AcceptableProtocol type requirements.
+   *
+   * @param max_connections The largest number of connections to accept in one
+   * batch. A value of zero is treated as one.
+   *
+   * @param handler The handler to be called when the accept operation
+   * completes. Copies will be made of the handler as required. The function
+   * signature of the handler must be:
+   * @code void handler(
+   *   const std::error_code& error, // Result of operation.
+   *   std::vector<typename Protocol::socket> peers // The accepted sockets.
+   * ); @endcode
+   * If at least one connection is accepted, @c error is clear. An error that
+   * occurs after that is reported by the next operation. Regardless of whether
+   * the asynchronous operation completes immediately or not, the handler will
+   * not be invoked from within this function. Invocation of the handler will
+   * be performed in a manner equivalent to using
+   * std::experimental::net::v1::io_context::post().
+   *
+   * @note Batches are not supported when the implementation uses I/O
+   * completion ports. On those platforms the operation fails with
+   * std::experimental::net::v1::error::operation_not_supported.
+   *
+   * @par Example
+   * @code
+   * void accept_handler(const std::error_code& error,
+   *     std::vector<std::experimental::net::ip::tcp::socket> peers)
+   * {
+   *   if (!error)
+   *   {
+   *     // Accept succeeded.
+   *   }
+   * }
+   *
+   * ...
+   *
+   * std::experimental::net::ip::tcp::acceptor acceptor(io_context);
+   * ...
+   * acceptor.async_accept_many(64, accept_handler);
+   * @endcode
+   */
+  template <typename MoveAcceptManyHandler>
+  NET_TS_INITFN_RESULT_TYPE(MoveAcceptManyHandler,
+      void (std::error_code, std::vector<typename Protocol::socket>))
+  async_accept_many(std::size_t max_connections,
+      NET_TS_MOVE_ARG(MoveAcceptManyHandler) handler)
+  {
+    async_completion<MoveAcceptManyHandler,
+      void (std::error_code,
+        std::vector<typename Protocol::socket>)> init(handler);
+
+    own_io_context_balancer balancer = { &this->get_executor().context() };
+    this->get_service().async_accept_many(this->get_implementation(),
+        max_connections ? max_connections : 1, balancer,
+        init.completion_handler);
+
+    return init.result.get();
+  }
+
+  /// Start an asynchronous accept of a batch of new connections.
+  /**
+   * This function is used to asynchronously accept the connections that are
+   * waiting to be accepted, placing each new socket on an io_context chosen
+   * by a balancer. The function call always returns immediately.
+   *
+   * When the acceptor becomes ready, connections are accepted until none
+   * remain to be accepted or @c max_connections have been accepted. The
+   * handler then receives them all at once, rather than the acceptor waiting
+   * for readiness again between connections. To keep accepting, start another
+   * batch from within the handler.
+   *
+   * This overload requires that the Protocol template parameter satisfy the
+   * AcceptableProtocol type requirements.
+   *
+   * @param max_connections The largest number of connections to accept in one
+   * batch. A value of zero is treated as one.
+   *
+   * @param balancer A function object that is called once for each accepted
+   * connection to choose the io_context that the new socket will use. The
+   * function signature must be:
+   * @code std::experimental::net::io_context& balancer(); @endcode
+   * The balancer is called when the operation completes, from a thread that
+   * is running the acceptor's io_context, before the handler is passed to its
+   * associated executor. It is therefore not called from the handler's
+   * executor. A copy of the balancer is made for each batch, and any state it
+   * updates is discarded with that copy. To keep state across batches, such
+   * as the assignment counts of an io_context_balancer, pass the balancer by
+   * reference using @c std::ref. The referenced balancer must then remain
+   * valid until the handler is invoked, and must not be used concurrently
+   * from other threads.
+   *
+   * @param handler The handler to be called when the accept operation
+   * completes. Copies will be made of the handler as required. The function
+   * signature of the handler must be:
+   * @code void handler(
+   *   const std::error_code& error, // Result of operation.
+   *   std::vector<typename Protocol::socket> peers // The accepted sockets.
+   * ); @endcode
+   * If at least one connection is accepted, @c error is clear. An error that
+   * occurs after that is reported by the next operation. Regardless of whether
+   * the asynchronous operation completes immediately or not, the handler will
+   * not be invoked from within this function. Invocation of the handler will
+   * be performed in a manner equivalent to using
+   * std::experimental::net::v1::io_context::post().
+   *
+   * @note Batches are not supported when the implementation uses I/O
+   * completion ports. On those platforms the operation fails with
+   * std::experimental::net::v1::error::operation_not_supported.
+   *
+   * @par Example
+   * @code
+   * struct round_robin
+   * {
+   *   std::vector<std::experimental::net::io_context>* contexts;
+   *   std::size_t next;
+   *
+   *   std::experimental::net::io_context& operator()()
+   *   {
+   *     return (*contexts)[next++ % contexts->size()];
+   *   }
+   * };
+   *
+   * ...
+   *
+   * round_robin balancer = { &worker_contexts, 0 };
+   * acceptor.async_accept_many(64, balancer, accept_handler);
+   * @endcode
+   */
+  template <typename Balancer, typename MoveAcceptManyHandler>
+  NET_TS_INITFN_RESULT_TYPE(MoveAcceptManyHandler,
+      void (std::error_code, std::vector<typename Protocol::socket>))
+  async_accept_many(std::size_t max_connections, Balancer balancer,
+      NET_TS_MOVE_ARG(MoveAcceptManyHandler) handler)
+  {
+    async_completion<MoveAcceptManyHandler,
+      void (std::error_code,
+        std::vector<typename Protocol::socket>)> init(handler);
+
+    this->get_service().async_accept_many(this->get_implementation(),
+        max_connections ? max_connections : 1, balancer,
+        init.completion_handler);
+
+    return init.result.get();
+  }
 #endif // defined(NET_TS_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+
+#if defined(NET_TS_HAS_MOVE)
+private:
+  // Balancer that places every accepted socket on the acceptor's io_context.
+  struct own_io_context_balancer
+  {
+    std::experimental::net::v1::io_context* io_context_;
+
+    std::experimental::net::v1::io_context& operator()() const
+    {
+      return *io_context_;
+    }
+  };
+#endif // defined(NET_TS_HAS_MOVE)
 };
 
 } // inline namespace v1
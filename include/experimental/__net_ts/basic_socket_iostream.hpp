@@ -93,6 +93,11 @@ protected:
   {
   }
 
+  explicit socket_iostream_base(io_context& ctx)
+    : streambuf_(ctx)
+  {
+  }
+
 #if defined(NET_TS_HAS_MOVE)
   socket_iostream_base(socket_iostream_base&& other)
     : streambuf_(std::move(other.streambuf_))
@@ -202,6 +207,24 @@ public:
     this->setf(std::ios_base::unitbuf);
   }
 
+  /// Construct a basic_socket_iostream that uses the specified io_context.
+  /**
+   * This constructor creates a stream whose socket is associated with the
+   * supplied io_context, without establishing a connection. The io_context
+   * must outlive the stream.
+   */
+  explicit basic_socket_iostream(std::experimental::net::v1::io_context& ctx)
+    : detail::socket_iostream_base<
+        Protocol NET_TS_SVC_TARG, Clock,
+        WaitTraits NET_TS_SVC_TARG1>(ctx),
+      std::basic_iostream<char>(
+        &this->detail::socket_iostream_base<
+          Protocol NET_TS_SVC_TARG, Clock,
+          WaitTraits NET_TS_SVC_TARG1>::streambuf_)
+  {
+    this->setf(std::ios_base::unitbuf);
+  }
+
 #if defined(NET_TS_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
   /// Construct a basic_socket_iostream from the supplied socket.
   explicit basic_socket_iostream(basic_stream_socket<protocol_type> s)
@@ -24,6 +24,7 @@
 #include <experimental/__net_ts/basic_socket.hpp>
 #include <experimental/__net_ts/basic_stream_socket.hpp>
 #include <experimental/__net_ts/detail/buffer_sequence_adapter.hpp>
+#include <experimental/__net_ts/detail/global.hpp>
 #include <experimental/__net_ts/detail/memory.hpp>
 #include <experimental/__net_ts/detail/throw_error.hpp>
 #include <experimental/__net_ts/io_context.hpp>
@@ -79,6 +80,20 @@ namespace net {
 inline namespace v1 {
 namespace detail {
 
+// Holder for the io_context that is shared by all default-constructed socket
+// streambufs in the process. Each streambuf keeps a reference to the
+// io_context, so it outlives the holder if any streams remain at exit.
+class socket_streambuf_shared_io_context
+{
+public:
+  socket_streambuf_shared_io_context()
+    : io_context_(new io_context(1))
+  {
+  }
+
+  shared_ptr<io_context> io_context_;
+};
+
 // A separate base class is used to ensure that the io_context member is
 // initialised prior to the basic_socket_streambuf's basic_socket base class.
 class socket_streambuf_io_context
@@ -89,6 +104,17 @@ protected:
   {
   }
 
+  socket_streambuf_io_context(const shared_ptr<io_context>& ctx)
+    : default_io_context_(ctx)
+  {
+  }
+
+  // Obtain the process-wide io_context used by default-constructed streams.
+  static shared_ptr<io_context> shared_io_context()
+  {
+    return detail::global<socket_streambuf_shared_io_context>().io_context_;
+  }
+
   shared_ptr<io_context> default_io_context_;
 };
 
@@ -190,14 +216,36 @@ public:
 #endif
 
   /// Construct a basic_socket_streambuf without establishing a connection.
+  /**
+   * The socket is associated with an io_context that is shared by all
+   * default-constructed socket streambufs in the process. Stream timeouts
+   * are implemented by polling the socket against the expiry time, and so do
+   * not require the io_context to be run.
+   */
   basic_socket_streambuf()
-    : detail::socket_streambuf_io_context(new io_context),
+    : detail::socket_streambuf_io_context(shared_io_context()),
       basic_socket<Protocol NET_TS_SVC_TARG>(*default_io_context_),
       expiry_time_(max_expiry_time())
   {
     init_buffers();
   }
 
+  /// Construct a basic_socket_streambuf that uses the specified io_context.
+  /**
+   * This constructor creates a stream buffer whose socket is associated with
+   * the supplied io_context, without establishing a connection.
+   *
+   * @param ctx The io_context object that the socket will use. The io_context
+   * must outlive the stream buffer.
+   */
+  explicit basic_socket_streambuf(std::experimental::net::v1::io_context& ctx)
+    : detail::socket_streambuf_io_context(0),
+      basic_socket<Protocol NET_TS_SVC_TARG>(ctx),
+      expiry_time_(max_expiry_time())
+  {
+    init_buffers();
+  }
+
 #if defined(NET_TS_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
   /// Construct a basic_socket_streambuf from the supplied socket.
   explicit basic_socket_streambuf(basic_stream_socket<protocol_type> s)
@@ -216,6 +216,71 @@ public:
   {
   }
 
+#if defined(NET_TS_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+  /// Move the socket to another io_context.
+  /**
+   * This function transfers an open socket to a socket object that uses a
+   * different io_context. The connection and the socket's settings, including
+   * whether it is non-blocking, are preserved. It may be used to rebalance
+   * long-lived connections across io_contexts.
+   *
+   * The socket should have no outstanding asynchronous operations. Any that
+   * remain finish immediately with the
+   * std::experimental::net::v1::error::operation_aborted error.
+   *
+   * @param target The io_context object that the returned socket will use to
+   * dispatch handlers for any asynchronous operations performed on it.
+   *
+   * @returns A socket object that owns the connection. Following the call,
+   * this object is in the same state as if constructed using the
+   * @c basic_stream_socket(io_context&) constructor.
+   *
+   * @throws std::system_error Thrown on failure. On failure, this object
+   * still owns the connection.
+   *
+   * @par Example
+   * @code
+   * std::experimental::net::io_context_balancer balancer;
+   * ...
+   * socket = socket.migrate(balancer());
+   * @endcode
+   */
+  basic_stream_socket migrate(io_context& target)
+  {
+    std::error_code ec;
+    basic_stream_socket peer(migrate(target, ec));
+    std::experimental::net::v1::detail::throw_error(ec, "migrate");
+    return peer;
+  }
+
+  /// Move the socket to another io_context.
+  /**
+   * This function transfers an open socket to a socket object that uses a
+   * different io_context. The connection and the socket's settings, including
+   * whether it is non-blocking, are preserved.
+   *
+   * The socket should have no outstanding asynchronous operations. Any that
+   * remain finish immediately with the
+   * std::experimental::net::v1::error::operation_aborted error.
+   *
+   * @param target The io_context object that the returned socket will use to
+   * dispatch handlers for any asynchronous operations performed on it.
+   *
+   * @param ec Set to indicate what error occurred, if any. On failure, this
+   * object still owns the connection.
+   *
+   * @returns On success, a socket object that owns the connection. On error,
+   * a socket object where is_open() is false.
+   */
+  basic_stream_socket migrate(io_context& target, std::error_code& ec)
+  {
+    basic_stream_socket peer(target);
+    this->get_service().migrate(this->get_implementation(),
+        peer.get_service(), peer.get_implementation(), ec);
+    return peer;
+  }
+#endif // defined(NET_TS_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+
   /// Send some data on the socket.
   /**
    * This function is used to send data on the stream socket. The function
@@ -0,0 +1,261 @@
+//
+// bind_cancellation_slot.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_BIND_CANCELLATION_SLOT_HPP
+#define NET_TS_BIND_CANCELLATION_SLOT_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <experimental/__net_ts/detail/type_traits.hpp>
+#include <experimental/__net_ts/detail/variadic_templates.hpp>
+#include <experimental/__net_ts/associated_allocator.hpp>
+#include <experimental/__net_ts/associated_cancellation_slot.hpp>
+#include <experimental/__net_ts/associated_executor.hpp>
+#include <experimental/__net_ts/async_result.hpp>
+#include <experimental/__net_ts/bind_executor.hpp>
+#include <experimental/__net_ts/cancellation_signal.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+
+/// A call wrapper type to bind a cancellation slot of type @c CancellationSlot
+/// to an object of type @c T.
+template <typename T, typename CancellationSlot>
+class cancellation_slot_binder
+#if !defined(GENERATING_DOCUMENTATION)
+  : public detail::executor_binder_result_type<T>,
+    public detail::executor_binder_argument_type<T>,
+    public detail::executor_binder_argument_types<T>
+#endif // !defined(GENERATING_DOCUMENTATION)
+{
+public:
+  /// The type of the target object.
+  typedef T target_type;
+
+  /// The type of the associated cancellation slot.
+  typedef CancellationSlot cancellation_slot_type;
+
+  /// Construct a cancellation slot wrapper for the specified object.
+  /**
+   * This constructor is only valid if the type @c T is constructible from type
+   * @c U.
+   */
+  template <typename U>
+  cancellation_slot_binder(const cancellation_slot_type& s,
+      NET_TS_MOVE_ARG(U) u)
+    : target_(NET_TS_MOVE_CAST(U)(u)),
+      slot_(s)
+  {
+  }
+
+  /// Copy constructor.
+  cancellation_slot_binder(const cancellation_slot_binder& other)
+    : target_(other.get()),
+      slot_(other.get_cancellation_slot())
+  {
+  }
+
+#if defined(NET_TS_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+
+  /// Move constructor.
+  cancellation_slot_binder(cancellation_slot_binder&& other)
+    : target_(NET_TS_MOVE_CAST(T)(other.get())),
+      slot_(other.get_cancellation_slot())
+  {
+  }
+
+#endif // defined(NET_TS_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+
+  /// Destructor.
+  ~cancellation_slot_binder()
+  {
+  }
+
+  /// Obtain a reference to the target object.
+  target_type& get() NET_TS_NOEXCEPT
+  {
+    return target_;
+  }
+
+  /// Obtain a reference to the target object.
+  const target_type& get() const NET_TS_NOEXCEPT
+  {
+    return target_;
+  }
+
+  /// Obtain the associated cancellation slot.
+  cancellation_slot_type get_cancellation_slot() const NET_TS_NOEXCEPT
+  {
+    return slot_;
+  }
+
+#if defined(GENERATING_DOCUMENTATION)
+
+  template <typename... Args> auto operator()(Args&& ...);
+  template <typename... Args> auto operator()(Args&& ...) const;
+
+#elif defined(NET_TS_HAS_VARIADIC_TEMPLATES)
+
+  /// Forwarding function call operator.
+  template <typename... Args>
+  typename result_of<T(Args...)>::type operator()(
+      NET_TS_MOVE_ARG(Args)... args)
+  {
+    return target_(NET_TS_MOVE_CAST(Args)(args)...);
+  }
+
+  /// Forwarding function call operator.
+  template <typename... Args>
+  typename result_of<T(Args...)>::type operator()(
+      NET_TS_MOVE_ARG(Args)... args) const
+  {
+    return target_(NET_TS_MOVE_CAST(Args)(args)...);
+  }
+
+#else // defined(NET_TS_HAS_VARIADIC_TEMPLATES)
+
+  typedef typename detail::executor_binder_result_type<T>::result_type_or_void
+    result_type_or_void;
+
+  result_type_or_void operator()()
+  {
+    return target_();
+  }
+
+  result_type_or_void operator()() const
+  {
+    return target_();
+  }
+
+#define NET_TS_PRIVATE_BIND_CANCELLATION_SLOT_CALL_DEF(n) \
+  template <NET_TS_VARIADIC_TPARAMS(n)> \
+  result_type_or_void operator()( \
+      NET_TS_VARIADIC_MOVE_PARAMS(n)) \
+  { \
+    return target_(NET_TS_VARIADIC_MOVE_ARGS(n)); \
+  } \
+  \
+  template <NET_TS_VARIADIC_TPARAMS(n)> \
+  result_type_or_void operator()( \
+      NET_TS_VARIADIC_MOVE_PARAMS(n)) const \
+  { \
+    return target_(NET_TS_VARIADIC_MOVE_ARGS(n)); \
+  } \
+  /**/
+  NET_TS_VARIADIC_GENERATE(NET_TS_PRIVATE_BIND_CANCELLATION_SLOT_CALL_DEF)
+#undef NET_TS_PRIVATE_BIND_CANCELLATION_SLOT_CALL_DEF
+
+#endif // defined(NET_TS_HAS_VARIADIC_TEMPLATES)
+
+private:
+  T target_;
+  CancellationSlot slot_;
+};
+
+/// Associate an object of type @c T with a cancellation slot.
+/**
+ * When the resulting object is used as the completion handler of an
+ * asynchronous operation that supports per-operation cancellation, emitting
+ * the slot's signal cancels that operation only.
+ */
+template <typename CancellationSlot, typename T>
+inline cancellation_slot_binder<typename decay<T>::type, CancellationSlot>
+bind_cancellation_slot(const CancellationSlot& s, NET_TS_MOVE_ARG(T) t)
+{
+  return cancellation_slot_binder<typename decay<T>::type, CancellationSlot>(
+      s, NET_TS_MOVE_CAST(T)(t));
+}
+
+#if !defined(GENERATING_DOCUMENTATION)
+
+template <typename T, typename CancellationSlot, typename Signature>
+class async_result<cancellation_slot_binder<T, CancellationSlot>, Signature>
+{
+public:
+  typedef cancellation_slot_binder<
+    typename async_result<T, Signature>::completion_handler_type,
+      CancellationSlot> completion_handler_type;
+
+  typedef typename async_result<T, Signature>::return_type return_type;
+
+  explicit async_result(cancellation_slot_binder<T, CancellationSlot>& b)
+    : target_(b.get())
+  {
+  }
+
+  return_type get()
+  {
+    return target_.get();
+  }
+
+private:
+  async_result(const async_result&) NET_TS_DELETED;
+  async_result& operator=(const async_result&) NET_TS_DELETED;
+
+  async_result<T, Signature> target_;
+};
+
+template <typename T, typename CancellationSlot, typename Allocator>
+struct associated_allocator<
+  cancellation_slot_binder<T, CancellationSlot>, Allocator>
+{
+  typedef typename associated_allocator<T, Allocator>::type type;
+
+  static type get(const cancellation_slot_binder<T, CancellationSlot>& b,
+      const Allocator& a = Allocator()) NET_TS_NOEXCEPT
+  {
+    return associated_allocator<T, Allocator>::get(b.get(), a);
+  }
+};
+
+template <typename T, typename CancellationSlot, typename Executor>
+struct associated_executor<
+  cancellation_slot_binder<T, CancellationSlot>, Executor>
+{
+  typedef typename associated_executor<T, Executor>::type type;
+
+  static type get(const cancellation_slot_binder<T, CancellationSlot>& b,
+      const Executor& ex = Executor()) NET_TS_NOEXCEPT
+  {
+    return associated_executor<T, Executor>::get(b.get(), ex);
+  }
+};
+
+template <typename T, typename Executor, typename CancellationSlot>
+struct associated_cancellation_slot<
+  executor_binder<T, Executor>, CancellationSlot>
+{
+  typedef typename associated_cancellation_slot<
+    T, CancellationSlot>::type type;
+
+  static type get(const executor_binder<T, Executor>& b,
+      const CancellationSlot& s = CancellationSlot()) NET_TS_NOEXCEPT
+  {
+    return associated_cancellation_slot<T, CancellationSlot>::get(b.get(), s);
+  }
+};
+
+#endif // !defined(GENERATING_DOCUMENTATION)
+
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_BIND_CANCELLATION_SLOT_HPP
@@ -0,0 +1,333 @@
+//
+// cancellation_signal.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_CANCELLATION_SIGNAL_HPP
+#define NET_TS_CANCELLATION_SIGNAL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <experimental/__net_ts/detail/type_traits.hpp>
+#include <experimental/__net_ts/detail/variadic_templates.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+// The type-erased handler installed in a cancellation slot. The memory that
+// holds the handler is retained by the slot and reused for the next handler
+// if it is large enough, so that an operation that is started repeatedly with
+// the same slot allocates only once.
+class cancellation_handler_base
+{
+public:
+  // Invoke the handler.
+  virtual void call() = 0;
+
+  // Destroy the handler, returning the memory that held it and its size.
+  virtual std::pair<void*, std::size_t> destroy() NET_TS_NOEXCEPT = 0;
+
+protected:
+  ~cancellation_handler_base() {}
+};
+
+template <typename Handler>
+class cancellation_handler
+  : public cancellation_handler_base
+{
+public:
+#if defined(NET_TS_HAS_VARIADIC_TEMPLATES)
+  template <typename... Args>
+  cancellation_handler(std::size_t size, NET_TS_MOVE_ARG(Args)... args)
+    : handler_(NET_TS_MOVE_CAST(Args)(args)...),
+      size_(size)
+  {
+  }
+#else // defined(NET_TS_HAS_VARIADIC_TEMPLATES)
+  cancellation_handler(std::size_t size)
+    : handler_(),
+      size_(size)
+  {
+  }
+
+#define NET_TS_PRIVATE_CANCELLATION_HANDLER_CTOR_DEF(n) \
+  template <NET_TS_VARIADIC_TPARAMS(n)> \
+  cancellation_handler(std::size_t size, NET_TS_VARIADIC_MOVE_PARAMS(n)) \
+    : handler_(NET_TS_VARIADIC_MOVE_ARGS(n)), \
+      size_(size) \
+  { \
+  } \
+  /**/
+  NET_TS_VARIADIC_GENERATE(NET_TS_PRIVATE_CANCELLATION_HANDLER_CTOR_DEF)
+#undef NET_TS_PRIVATE_CANCELLATION_HANDLER_CTOR_DEF
+#endif // defined(NET_TS_HAS_VARIADIC_TEMPLATES)
+
+  void call()
+  {
+    handler_();
+  }
+
+  std::pair<void*, std::size_t> destroy() NET_TS_NOEXCEPT
+  {
+    std::pair<void*, std::size_t> mem(this, size_);
+    this->~cancellation_handler();
+    return mem;
+  }
+
+  Handler& handler() NET_TS_NOEXCEPT
+  {
+    return handler_;
+  }
+
+private:
+  ~cancellation_handler()
+  {
+  }
+
+  Handler handler_;
+  std::size_t size_;
+};
+
+} // namespace detail
+
+class cancellation_slot;
+
+/// A cancellation signal with a single slot.
+/**
+ * A cancellation_signal is used to cancel an individual asynchronous
+ * operation. The signal's slot is associated with the operation's completion
+ * handler, typically using std::experimental::net::v1::bind_cancellation_slot.
+ * When the operation starts, it installs a handler in the slot. Calling emit()
+ * invokes that handler, which cancels the operation if it is still pending.
+ * The operation then completes with the
+ * std::experimental::net::v1::error::operation_aborted error. Other operations
+ * on the same object are not affected.
+ *
+ * If the operation has already completed, or has not been started, emit()
+ * has no effect. The signal must not be emitted after the io_context that
+ * runs the operation has been destroyed.
+ *
+ * Per-operation cancellation is supported by the asynchronous socket
+ * operations on platforms that use a reactor (epoll, kqueue, /dev/poll or
+ * select). Elsewhere the slot is ignored and operations can only be cancelled
+ * by cancelling or closing the socket.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Unsafe. The signal must not be emitted concurrently
+ * with the initiation of an operation that uses its slot.
+ *
+ * @par Example
+ * @code
+ * std::experimental::net::cancellation_signal signal;
+ *
+ * socket.async_receive(buffer,
+ *     std::experimental::net::bind_cancellation_slot(signal.slot(),
+ *       [](const std::error_code& error, std::size_t n)
+ *       {
+ *         if (error == std::experimental::net::error::operation_aborted)
+ *         {
+ *           // The receive was abandoned. The socket remains open.
+ *         }
+ *       }));
+ *
+ * ...
+ *
+ * signal.emit(); // Cancel the receive only.
+ * @endcode
+ */
+class cancellation_signal
+{
+public:
+  /// Construct a signal whose slot has no handler.
+  NET_TS_CONSTEXPR cancellation_signal()
+    : handler_(0)
+  {
+  }
+
+  /// Destructor. Destroys the slot's handler, if any.
+  NET_TS_DECL ~cancellation_signal();
+
+  /// Invoke the slot's handler, if any.
+  void emit()
+  {
+    if (handler_)
+      handler_->call();
+  }
+
+  /// Get the signal's slot.
+  /**
+   * The slot remains valid for the lifetime of the signal.
+   */
+  cancellation_slot slot() NET_TS_NOEXCEPT;
+
+private:
+  cancellation_signal(const cancellation_signal&) NET_TS_DELETED;
+  cancellation_signal& operator=(const cancellation_signal&) NET_TS_DELETED;
+
+  detail::cancellation_handler_base* handler_;
+};
+
+/// The slot of a cancellation_signal, in which a handler is installed.
+/**
+ * A default-constructed slot is not connected to a signal, and an operation
+ * that is given such a slot does not support per-operation cancellation.
+ */
+class cancellation_slot
+{
+public:
+  /// Construct a slot that is not connected to any signal.
+  NET_TS_CONSTEXPR cancellation_slot()
+    : handler_(0)
+  {
+  }
+
+#if defined(NET_TS_HAS_VARIADIC_TEMPLATES) \
+  || defined(GENERATING_DOCUMENTATION)
+  /// Construct a handler in the slot, replacing any existing handler.
+  /**
+   * The handler is a function object with the signature <tt>void()</tt>.
+   *
+   * @pre is_connected() is true.
+   *
+   * @returns A reference to the new handler.
+   */
+  template <typename CancellationHandler, typename... Args>
+  CancellationHandler& emplace(NET_TS_MOVE_ARG(Args)... args)
+  {
+    typedef detail::cancellation_handler<CancellationHandler>
+      cancellation_handler_type;
+    std::pair<void*, std::size_t> mem =
+      prepare_memory(sizeof(cancellation_handler_type));
+    cancellation_handler_type* h = new (mem.first)
+      cancellation_handler_type(mem.second, NET_TS_MOVE_CAST(Args)(args)...);
+    *handler_ = h;
+    return h->handler();
+  }
+#else // defined(NET_TS_HAS_VARIADIC_TEMPLATES)
+      //   || defined(GENERATING_DOCUMENTATION)
+  template <typename CancellationHandler>
+  CancellationHandler& emplace()
+  {
+    typedef detail::cancellation_handler<CancellationHandler>
+      cancellation_handler_type;
+    std::pair<void*, std::size_t> mem =
+      prepare_memory(sizeof(cancellation_handler_type));
+    cancellation_handler_type* h = new (mem.first)
+      cancellation_handler_type(mem.second);
+    *handler_ = h;
+    return h->handler();
+  }
+
+#define NET_TS_PRIVATE_CANCELLATION_SLOT_EMPLACE_DEF(n) \
+  template <typename CancellationHandler, NET_TS_VARIADIC_TPARAMS(n)> \
+  CancellationHandler& emplace(NET_TS_VARIADIC_MOVE_PARAMS(n)) \
+  { \
+    typedef detail::cancellation_handler<CancellationHandler> \
+      cancellation_handler_type; \
+    std::pair<void*, std::size_t> mem = \
+      prepare_memory(sizeof(cancellation_handler_type)); \
+    cancellation_handler_type* h = new (mem.first) \
+      cancellation_handler_type(mem.second, NET_TS_VARIADIC_MOVE_ARGS(n)); \
+    *handler_ = h; \
+    return h->handler(); \
+  } \
+  /**/
+  NET_TS_VARIADIC_GENERATE(NET_TS_PRIVATE_CANCELLATION_SLOT_EMPLACE_DEF)
+#undef NET_TS_PRIVATE_CANCELLATION_SLOT_EMPLACE_DEF
+#endif // defined(NET_TS_HAS_VARIADIC_TEMPLATES)
+       //   || defined(GENERATING_DOCUMENTATION)
+
+  /// Install a handler in the slot, replacing any existing handler.
+  /**
+   * The handler is a function object with the signature <tt>void()</tt>.
+   *
+   * @pre is_connected() is true.
+   *
+   * @returns A reference to the installed copy of the handler.
+   */
+  template <typename CancellationHandler>
+  typename decay<CancellationHandler>::type& assign(
+      NET_TS_MOVE_ARG(CancellationHandler) handler)
+  {
+    return this->emplace<typename decay<CancellationHandler>::type>(
+        NET_TS_MOVE_CAST(CancellationHandler)(handler));
+  }
+
+  /// Remove the slot's handler, if any.
+  NET_TS_DECL void clear();
+
+  /// Determine whether the slot is connected to a signal.
+  bool is_connected() const NET_TS_NOEXCEPT
+  {
+    return handler_ != 0;
+  }
+
+  /// Determine whether a handler is installed in the slot.
+  bool has_handler() const NET_TS_NOEXCEPT
+  {
+    return handler_ != 0 && *handler_ != 0;
+  }
+
+  /// Compare two slots for equality.
+  friend bool operator==(const cancellation_slot& lhs,
+      const cancellation_slot& rhs) NET_TS_NOEXCEPT
+  {
+    return lhs.handler_ == rhs.handler_;
+  }
+
+  /// Compare two slots for inequality.
+  friend bool operator!=(const cancellation_slot& lhs,
+      const cancellation_slot& rhs) NET_TS_NOEXCEPT
+  {
+    return lhs.handler_ != rhs.handler_;
+  }
+
+private:
+  friend class cancellation_signal;
+
+  explicit cancellation_slot(detail::cancellation_handler_base** handler)
+    : handler_(handler)
+  {
+  }
+
+  // Destroy the existing handler, if any, and obtain memory for a new handler
+  // of the given size, reusing the existing handler's memory if possible.
+  NET_TS_DECL std::pair<void*, std::size_t> prepare_memory(std::size_t size);
+
+  detail::cancellation_handler_base** handler_;
+};
+
+inline cancellation_slot cancellation_signal::slot() NET_TS_NOEXCEPT
+{
+  return cancellation_slot(&handler_);
+}
+
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#if defined(NET_TS_HEADER_ONLY)
+# include <experimental/__net_ts/impl/cancellation_signal.ipp>
+#endif // defined(NET_TS_HEADER_ONLY)
+
+#endif // NET_TS_CANCELLATION_SIGNAL_HPP
@@ -0,0 +1,299 @@
+//
+// channel.hpp
+// ~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_CHANNEL_HPP
+#define NET_TS_CHANNEL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <experimental/__net_ts/async_result.hpp>
+#include <experimental/__net_ts/io_context.hpp>
+#include <experimental/__net_ts/detail/channel_handler.hpp>
+#include <experimental/__net_ts/detail/channel_impl.hpp>
+#include <experimental/__net_ts/detail/handler_type_requirements.hpp>
+#include <experimental/__net_ts/detail/memory.hpp>
+#include <experimental/__net_ts/detail/noncopyable.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+
+/// A bounded queue for passing values between handlers.
+/**
+ * The channel class passes values from producers to consumers, which may be
+ * running on different threads or different io_context objects. Values are
+ * held in a fixed-size ring and are received in the order in which they were
+ * sent.
+ *
+ * The non-blocking try_send() and try_receive() functions add and remove
+ * values without locking or allocating memory. They take a lock only when a
+ * handler is waiting on the other side of the channel, to wake it. A consumer
+ * that is woken by async_receive() should therefore drain any further values
+ * using try_receive() before waiting again, so that a busy channel is served
+ * without locking.
+ *
+ * When the channel is full, async_send() waits for space, providing
+ * backpressure to the producer. When it is empty, async_receive() waits for
+ * a value. Waiting handlers are served in the order in which they started to
+ * wait, and a send does not overtake an async_send() that is already waiting.
+ *
+ * Completions are queued to the io_context with which the channel was
+ * constructed, and each handler is then invoked using its associated
+ * executor. This is normally the consumer's io_context.
+ *
+ * @tparam T The type of the values. It must be DefaultConstructible and
+ * MoveAssignable. Each slot of the ring holds a default-constructed value
+ * while it is empty.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Safe.
+ *
+ * @par Example
+ * @code
+ * std::experimental::net::channel<message> ch(consumer_context, 1024);
+ *
+ * // On the producer's thread.
+ * if (!ch.try_send(std::move(msg)))
+ *   ch.async_send(std::move(msg),
+ *       [](const std::error_code& error) { ... });
+ *
+ * // On the consumer's thread.
+ * void receive_handler(const std::error_code& error, message msg)
+ * {
+ *   if (!error)
+ *   {
+ *     process(msg);
+ *     while (ch.try_receive(msg))
+ *       process(msg);
+ *     ch.async_receive(receive_handler);
+ *   }
+ * }
+ * @endcode
+ */
+template <typename T>
+class channel
+  : private noncopyable
+{
+public:
+  /// The type of the executor associated with the object.
+  typedef io_context::executor_type executor_type;
+
+  /// The type of the values passed through the channel.
+  typedef T value_type;
+
+  /// Constructor.
+  /**
+   * @param io_context The io_context object that the channel will use to
+   * dispatch handlers.
+   *
+   * @param capacity The number of values the channel can hold. It is rounded
+   * up to a power of two, and to at least two.
+   */
+  channel(std::experimental::net::v1::io_context& io_context,
+      std::size_t capacity)
+    : io_context_(io_context),
+      impl_(io_context, capacity)
+  {
+  }
+
+  /// Destructor.
+  /**
+   * The handler for each outstanding send and receive is invoked with the
+   * std::experimental::net::v1::error::operation_aborted error code. Values
+   * still held in the channel are destroyed.
+   */
+  ~channel()
+  {
+  }
+
+  /// Get the executor associated with the object.
+  executor_type get_executor() NET_TS_NOEXCEPT
+  {
+    return io_context_.get_executor();
+  }
+
+  /// Get the number of values the channel can hold.
+  std::size_t capacity() const
+  {
+    return impl_.capacity();
+  }
+
+  /// Determine whether the channel is open.
+  bool is_open() const
+  {
+    return impl_.is_open();
+  }
+
+  /// Close the channel.
+  /**
+   * No further values may be sent. The handler for each outstanding send is
+   * invoked with the std::experimental::net::v1::error::broken_pipe error
+   * code. Values already in the channel may still be received, after which
+   * receives fail with the std::experimental::net::v1::error::eof error code.
+   *
+   * A try_send() that runs concurrently with close() may still succeed.
+   */
+  void close()
+  {
+    impl_.close();
+  }
+
+  /// Cancel all outstanding sends and receives.
+  /**
+   * The handler for each cancelled operation is invoked with the
+   * std::experimental::net::v1::error::operation_aborted error code. The
+   * value of a cancelled send is not added to the channel.
+   *
+   * @return The number of asynchronous operations that were cancelled.
+   */
+  std::size_t cancel()
+  {
+    return impl_.cancel();
+  }
+
+  /// Add a value to the channel without waiting.
+  /**
+   * @return @c true if the value was added, or @c false if the channel is
+   * full or closed, or if an async_send() is still waiting for space.
+   */
+  bool try_send(const T& value)
+  {
+    return impl_.try_send(value);
+  }
+
+#if defined(NET_TS_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+  /// Add a value to the channel without waiting.
+  /**
+   * @return @c true if the value was moved into the channel, or @c false if
+   * the channel is full or closed, or if an async_send() is still waiting for
+   * space, in which case @c value is unchanged.
+   */
+  bool try_send(T&& value)
+  {
+    return impl_.try_send(std::move(value));
+  }
+#endif // defined(NET_TS_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+
+  /// Remove a value from the channel without waiting.
+  /**
+   * @return @c true if a value was moved into @c value, or @c false if the
+   * channel is empty.
+   */
+  bool try_receive(T& value)
+  {
+    return impl_.try_receive(value);
+  }
+
+  /// Start an asynchronous send.
+  /**
+   * This function adds a value to the channel, waiting for space if the
+   * channel is full. It always returns immediately.
+   *
+   * @param value The value to be sent.
+   *
+   * @param handler The handler to be called when the value has been added to
+   * the channel, or the send fails. Copies will be made of the handler as
+   * required. The function signature of the handler must be:
+   * @code void handler(
+   *   const std::error_code& error // Result of operation.
+   * ); @endcode
+   * If the channel is closed, @c error is
+   * std::experimental::net::v1::error::broken_pipe. Regardless of whether the
+   * asynchronous operation completes immediately or not, the handler will not
+   * be invoked from within this function. Invocation of the handler will be
+   * performed in a manner equivalent to using
+   * std::experimental::net::v1::io_context::post().
+   */
+  template <typename SendHandler>
+  NET_TS_INITFN_RESULT_TYPE(SendHandler,
+      void (std::error_code))
+  async_send(T value, NET_TS_MOVE_ARG(SendHandler) handler)
+  {
+    // If you get an error on the following line it means that your handler does
+    // not meet the documented type requirements for a SendHandler.
+    NET_TS_WAIT_HANDLER_CHECK(SendHandler, handler) type_check;
+
+    async_completion<SendHandler,
+      void (std::error_code)> init(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef detail::channel_send_handler<T, typename async_completion<
+      SendHandler, void (std::error_code)>::completion_handler_type> op;
+    typename op::ptr p = { detail::addressof(init.completion_handler),
+      op::ptr::allocate(init.completion_handler), 0 };
+    p.p = new (p.v) op(NET_TS_MOVE_CAST(T)(value), init.completion_handler);
+
+    impl_.start_send(p.p);
+    p.v = p.p = 0;
+
+    return init.result.get();
+  }
+
+  /// Start an asynchronous receive.
+  /**
+   * This function removes a value from the channel, waiting for one if the
+   * channel is empty. It always returns immediately.
+   *
+   * @param handler The handler to be called when a value has been received,
+   * or the receive fails. Copies will be made of the handler as required. The
+   * function signature of the handler must be:
+   * @code void handler(
+   *   const std::error_code& error, // Result of operation.
+   *   T value // The value received.
+   * ); @endcode
+   * If the channel is closed and empty, @c error is
+   * std::experimental::net::v1::error::eof. Regardless of whether the
+   * asynchronous operation completes immediately or not, the handler will not
+   * be invoked from within this function. Invocation of the handler will be
+   * performed in a manner equivalent to using
+   * std::experimental::net::v1::io_context::post().
+   */
+  template <typename ReceiveHandler>
+  NET_TS_INITFN_RESULT_TYPE(ReceiveHandler,
+      void (std::error_code, T))
+  async_receive(NET_TS_MOVE_ARG(ReceiveHandler) handler)
+  {
+    async_completion<ReceiveHandler,
+      void (std::error_code, T)> init(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef detail::channel_receive_handler<T, typename async_completion<
+      ReceiveHandler, void (std::error_code, T)>::completion_handler_type> op;
+    typename op::ptr p = { detail::addressof(init.completion_handler),
+      op::ptr::allocate(init.completion_handler), 0 };
+    p.p = new (p.v) op(init.completion_handler);
+
+    impl_.start_receive(p.p);
+    p.v = p.p = 0;
+
+    return init.result.get();
+  }
+
+private:
+  std::experimental::net::v1::io_context& io_context_;
+  detail::channel_impl<T> impl_;
+};
+
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_CHANNEL_HPP
@@ -0,0 +1,159 @@
+//
+// coarse_steady_timer.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_COARSE_STEADY_TIMER_HPP
+#define NET_TS_COARSE_STEADY_TIMER_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+
+#if defined(NET_TS_HAS_CHRONO) || defined(GENERATING_DOCUMENTATION)
+
+#include <time.h>
+#include <experimental/__net_ts/basic_waitable_timer.hpp>
+#include <experimental/__net_ts/detail/chrono.hpp>
+#include <experimental/__net_ts/wait_traits.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+
+/// A steady clock that trades precision for a cheaper now().
+/**
+ * On Linux, the coarse_steady_clock class reads @c CLOCK_MONOTONIC_COARSE,
+ * which is updated once per scheduler tick and may be read without consulting
+ * the hardware clock. Its readings lag the steady clock by up to one tick,
+ * typically between 1 and 4 milliseconds. On other platforms it is equivalent
+ * to the steady clock.
+ *
+ * The clock is intended for timers used as timeouts, where many timers are
+ * set and cancelled and a small delay in expiry does not matter.
+ */
+class coarse_steady_clock
+{
+public:
+  /// The duration type of the clock.
+  typedef chrono::nanoseconds duration;
+
+  /// The representation type of the duration.
+  typedef duration::rep rep;
+
+  /// The tick period of the duration.
+  typedef duration::period period;
+
+  /// The time point type of the clock.
+  typedef chrono::time_point<coarse_steady_clock, duration> time_point;
+
+  /// The clock is steady.
+  NET_TS_STATIC_CONSTANT(bool, is_steady = true);
+
+  /// Get the current time.
+  static time_point now() NET_TS_NOEXCEPT
+  {
+#if defined(CLOCK_MONOTONIC_COARSE)
+    timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return time_point(duration(
+          static_cast<rep>(ts.tv_sec) * 1000000000 + ts.tv_nsec));
+#else // defined(CLOCK_MONOTONIC_COARSE)
+    return time_point(chrono::duration_cast<duration>(
+          chrono::steady_clock::now().time_since_epoch()));
+#endif // defined(CLOCK_MONOTONIC_COARSE)
+  }
+
+  /// Get the interval at which the clock is updated.
+  static duration resolution() NET_TS_NOEXCEPT
+  {
+#if defined(CLOCK_MONOTONIC_COARSE)
+    static const duration res = get_resolution();
+    return res;
+#else // defined(CLOCK_MONOTONIC_COARSE)
+    return duration(1);
+#endif // defined(CLOCK_MONOTONIC_COARSE)
+  }
+
+private:
+#if defined(CLOCK_MONOTONIC_COARSE)
+  static duration get_resolution() NET_TS_NOEXCEPT
+  {
+    timespec ts;
+    if (::clock_getres(CLOCK_MONOTONIC_COARSE, &ts) != 0)
+      return chrono::milliseconds(10);
+    return duration(static_cast<rep>(ts.tv_sec) * 1000000000 + ts.tv_nsec);
+  }
+#endif // defined(CLOCK_MONOTONIC_COARSE)
+};
+
+/// Wait traits for the coarse steady clock.
+/**
+ * A wait is lengthened by the resolution of the clock. Otherwise, the
+ * clock's lag would cause a timer to be found not yet expired when the wait
+ * completes, and to be waited for again until the clock next advanced.
+ */
+template <>
+struct wait_traits<coarse_steady_clock>
+{
+  /// Convert a clock duration into a duration used for waiting.
+  /**
+   * @returns @c d plus the clock's resolution, if @c d is positive.
+   * Otherwise @c d.
+   */
+  static coarse_steady_clock::duration to_wait_duration(
+      const coarse_steady_clock::duration& d)
+  {
+    if (d <= coarse_steady_clock::duration::zero())
+      return d;
+    coarse_steady_clock::duration res = coarse_steady_clock::resolution();
+    if ((coarse_steady_clock::duration::max)() - res < d)
+      return (coarse_steady_clock::duration::max)();
+    return d + res;
+  }
+
+  /// Convert a clock duration into a duration used for waiting.
+  /**
+   * @returns The time until @c t, plus the clock's resolution if it is
+   * positive.
+   */
+  static coarse_steady_clock::duration to_wait_duration(
+      const coarse_steady_clock::time_point& t)
+  {
+    coarse_steady_clock::time_point now = coarse_steady_clock::now();
+    if (now + (coarse_steady_clock::duration::max)() < t)
+      return (coarse_steady_clock::duration::max)();
+    if (now + (coarse_steady_clock::duration::min)() > t)
+      return (coarse_steady_clock::duration::min)();
+    return to_wait_duration(t - now);
+  }
+};
+
+/// Typedef for a timer based on the coarse steady clock.
+/**
+ * A coarse_steady_timer is cheaper to set than a steady_timer, as reading the
+ * clock does not consult the hardware clock, but it may expire up to two
+ * ticks of the clock late.
+ */
+typedef basic_waitable_timer<coarse_steady_clock> coarse_steady_timer;
+
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // defined(NET_TS_HAS_CHRONO) || defined(GENERATING_DOCUMENTATION)
+
+#endif // NET_TS_COARSE_STEADY_TIMER_HPP
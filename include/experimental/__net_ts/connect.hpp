@@ -21,6 +21,10 @@
 #include <experimental/__net_ts/detail/type_traits.hpp>
 #include <experimental/__net_ts/error.hpp>
 
+#if defined(NET_TS_HAS_CHRONO)
+# include <experimental/__net_ts/detail/chrono.hpp>
+#endif // defined(NET_TS_HAS_CHRONO)
+
 #include <experimental/__net_ts/detail/push_options.hpp>
 
 namespace std {
@@ -809,6 +813,131 @@ async_connect(basic_socket<Protocol NET_TS_SVC_TARG>& s,
 
 /*@}*/
 
+#if defined(NET_TS_HAS_CHRONO) && defined(NET_TS_HAS_MOVE)
+
+/**
+ * @defgroup async_connect_staggered std::experimental::net::v1::async_connect_staggered
+ *
+ * @brief The @c async_connect_staggered function is a composed asynchronous
+ * operation that establishes a socket connection by racing staggered
+ * connection attempts to the endpoints in a sequence.
+ */
+/*@{*/
+
+/// Asynchronously establishes a socket connection by racing staggered
+/// connection attempts to the endpoints in a sequence.
+/**
+ * This function attempts to connect a socket to one of a sequence of
+ * endpoints, following the "Happy Eyeballs" algorithm described in RFC 8305.
+ * The endpoints are reordered so that address families alternate, starting
+ * with the family of the first endpoint. A connection attempt is started on a
+ * separate socket for the first endpoint. Each time the attempt delay elapses
+ * without a connection being established, or whenever an attempt fails, an
+ * attempt is started for the next endpoint, so that several attempts may be
+ * in progress at once. The first connection to be established is moved into
+ * @c s, and all other attempts are abandoned.
+ *
+ * @param s The socket to be connected. If the socket is already open, it will
+ * be closed.
+ *
+ * @param endpoints A sequence of endpoints.
+ *
+ * @param attempt_delay The time to wait for a connection attempt to complete
+ * before starting the next one in parallel.
+ *
+ * @param handler The handler to be called when the connect operation
+ * completes. Copies will be made of the handler as required. The function
+ * signature of the handler must be:
+ * @code void handler(
+ *   // Result of operation. if the sequence is empty, set to
+ *   // std::experimental::net::error::not_found. Otherwise, contains the
+ *   // error from the last connection attempt to fail.
+ *   const std::error_code& error,
+ *
+ *   // On success, the successfully connected endpoint.
+ *   // Otherwise, a default-constructed endpoint.
+ *   const typename Protocol::endpoint& endpoint
+ * ); @endcode
+ * Regardless of whether the asynchronous operation completes immediately or
+ * not, the handler will not be invoked from within this function. Invocation
+ * of the handler will be performed in a manner equivalent to using
+ * std::experimental::net::v1::io_context::post().
+ *
+ * @note The connection attempts are made on sockets that are internal to the
+ * operation, so closing @c s does not cancel it. To abandon the operation,
+ * associate a cancellation slot with the handler using
+ * std::experimental::net::v1::bind_cancellation_slot and emit its signal.
+ * The attempts in flight and the attempt timer are then cancelled, no further
+ * attempts are started, and the handler is invoked with the
+ * std::experimental::net::v1::error::operation_aborted error unless an
+ * attempt has already succeeded.
+ *
+ * @par Example
+ * @code void resolve_handler(
+ *     const std::error_code& ec,
+ *     tcp::resolver::results_type results)
+ * {
+ *   if (!ec)
+ *   {
+ *     std::experimental::net::async_connect_staggered(s, results,
+ *         std::chrono::milliseconds(100), connect_handler);
+ *   }
+ * } @endcode
+ */
+template <typename Protocol NET_TS_SVC_TPARAM, typename EndpointSequence,
+    typename Rep, typename Period, typename RangeConnectHandler>
+NET_TS_INITFN_RESULT_TYPE(RangeConnectHandler,
+    void (std::error_code, typename Protocol::endpoint))
+async_connect_staggered(basic_socket<Protocol NET_TS_SVC_TARG>& s,
+    const EndpointSequence& endpoints,
+    const chrono::duration<Rep, Period>& attempt_delay,
+    NET_TS_MOVE_ARG(RangeConnectHandler) handler,
+    typename enable_if<is_endpoint_sequence<
+        EndpointSequence>::value>::type* = 0);
+
+/// Asynchronously establishes a socket connection by racing staggered
+/// connection attempts to the endpoints in a sequence.
+/**
+ * This function behaves as the overload that takes an attempt delay, using
+ * the delay of 250 milliseconds recommended by RFC 8305.
+ *
+ * @param s The socket to be connected. If the socket is already open, it will
+ * be closed.
+ *
+ * @param endpoints A sequence of endpoints.
+ *
+ * @param handler The handler to be called when the connect operation
+ * completes. Copies will be made of the handler as required. The function
+ * signature of the handler must be:
+ * @code void handler(
+ *   // Result of operation. if the sequence is empty, set to
+ *   // std::experimental::net::error::not_found. Otherwise, contains the
+ *   // error from the last connection attempt to fail.
+ *   const std::error_code& error,
+ *
+ *   // On success, the successfully connected endpoint.
+ *   // Otherwise, a default-constructed endpoint.
+ *   const typename Protocol::endpoint& endpoint
+ * ); @endcode
+ * Regardless of whether the asynchronous operation completes immediately or
+ * not, the handler will not be invoked from within this function. Invocation
+ * of the handler will be performed in a manner equivalent to using
+ * std::experimental::net::v1::io_context::post().
+ */
+template <typename Protocol NET_TS_SVC_TPARAM,
+    typename EndpointSequence, typename RangeConnectHandler>
+NET_TS_INITFN_RESULT_TYPE(RangeConnectHandler,
+    void (std::error_code, typename Protocol::endpoint))
+async_connect_staggered(basic_socket<Protocol NET_TS_SVC_TARG>& s,
+    const EndpointSequence& endpoints,
+    NET_TS_MOVE_ARG(RangeConnectHandler) handler,
+    typename enable_if<is_endpoint_sequence<
+        EndpointSequence>::value>::type* = 0);
+
+/*@}*/
+
+#endif // defined(NET_TS_HAS_CHRONO) && defined(NET_TS_HAS_MOVE)
+
 } // inline namespace v1
 } // namespace net
 } // namespace experimental
@@ -0,0 +1,76 @@
+//
+// detail/async_event_impl.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_ASYNC_EVENT_IMPL_HPP
+#define NET_TS_DETAIL_ASYNC_EVENT_IMPL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <experimental/__net_ts/io_context.hpp>
+#include <experimental/__net_ts/detail/async_wait_queue.hpp>
+#include <experimental/__net_ts/detail/wait_op.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+// A manual-reset event whose waiters are wait operations. Waiters are queued
+// in FIFO order and are woken when the event is set, or individually by
+// notification.
+class async_event_impl
+  : public async_wait_queue
+{
+public:
+  // Constructor.
+  NET_TS_DECL async_event_impl(
+      std::experimental::net::v1::io_context& ioc, bool is_set);
+
+  // Start a wait. The operation completes immediately if the event is set.
+  NET_TS_DECL void start_wait(wait_op* op);
+
+  // Set the event and wake all waiters.
+  NET_TS_DECL void set();
+
+  // Reset the event.
+  NET_TS_DECL void reset();
+
+  // Determine whether the event is set.
+  NET_TS_DECL bool is_set() const;
+
+  // Wake up to the given number of waiters without setting the event. Returns
+  // the number of waiters woken.
+  NET_TS_DECL std::size_t notify(std::size_t n);
+
+private:
+  // Whether the event is set.
+  bool is_set_;
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#if defined(NET_TS_HEADER_ONLY)
+# include <experimental/__net_ts/detail/impl/async_event_impl.ipp>
+#endif // defined(NET_TS_HEADER_ONLY)
+
+#endif // NET_TS_DETAIL_ASYNC_EVENT_IMPL_HPP
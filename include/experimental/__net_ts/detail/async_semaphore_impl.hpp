@@ -0,0 +1,78 @@
+//
+// detail/async_semaphore_impl.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_ASYNC_SEMAPHORE_IMPL_HPP
+#define NET_TS_DETAIL_ASYNC_SEMAPHORE_IMPL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <experimental/__net_ts/io_context.hpp>
+#include <experimental/__net_ts/detail/async_wait_queue.hpp>
+#include <experimental/__net_ts/detail/wait_op.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+// A counting semaphore whose waiters are wait operations. Waiters are queued
+// in FIFO order. A released unit is handed directly to the first waiter, so
+// the count is only non-zero while there are no waiters and a later arrival
+// cannot overtake a waiter that is already queued.
+class async_semaphore_impl
+  : public async_wait_queue
+{
+public:
+  // Constructor.
+  NET_TS_DECL async_semaphore_impl(
+      std::experimental::net::v1::io_context& ioc, std::size_t count);
+
+  // Start a wait for a unit. The operation completes when a unit has been
+  // acquired on its behalf, or when it is cancelled.
+  NET_TS_DECL void start_acquire(wait_op* op);
+
+  // Acquire a unit without waiting. Returns true if a unit was acquired.
+  NET_TS_DECL bool try_acquire();
+
+  // Release units, handing them to waiters first.
+  NET_TS_DECL void release(std::size_t n);
+
+  // Release one unit, unless the count has already reached the given limit.
+  // Returns false, releasing nothing, if it has.
+  NET_TS_DECL bool release_one(std::size_t limit);
+
+  // Get the number of units available.
+  NET_TS_DECL std::size_t count() const;
+
+private:
+  // The number of units available.
+  std::size_t count_;
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#if defined(NET_TS_HEADER_ONLY)
+# include <experimental/__net_ts/detail/impl/async_semaphore_impl.ipp>
+#endif // defined(NET_TS_HEADER_ONLY)
+
+#endif // NET_TS_DETAIL_ASYNC_SEMAPHORE_IMPL_HPP
@@ -0,0 +1,141 @@
+//
+// detail/async_wait_queue.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_ASYNC_WAIT_QUEUE_HPP
+#define NET_TS_DETAIL_ASYNC_WAIT_QUEUE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <experimental/__net_ts/execution_context.hpp>
+#include <experimental/__net_ts/io_context.hpp>
+#include <experimental/__net_ts/detail/mutex.hpp>
+#include <experimental/__net_ts/detail/noncopyable.hpp>
+#include <experimental/__net_ts/detail/op_queue.hpp>
+#include <experimental/__net_ts/detail/wait_op.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+class async_wait_queue_service;
+
+// The part of a queue of waiting operations that is registered with a
+// service, so that operations still queued when the io_context shuts down are
+// destroyed along with it. The owner supplies a function that moves its queued
+// operations out, which is called with the mutex held.
+class async_wait_queue_base
+  : private noncopyable
+{
+protected:
+  typedef void (*shutdown_func_type)(
+      async_wait_queue_base*, op_queue<operation>&);
+
+  // Constructor. Registers the queue with the io_context's service.
+  NET_TS_DECL async_wait_queue_base(
+      std::experimental::net::v1::io_context& ioc,
+      shutdown_func_type shutdown_func);
+
+  // Destructor. Deregisters the queue.
+  NET_TS_DECL ~async_wait_queue_base();
+
+  // The io_context implementation used to post completions.
+  io_context_impl& io_context_impl_;
+
+  // Protects the derived class's state and its waiting operations.
+  mutable std::experimental::net::v1::detail::mutex mutex_;
+
+private:
+  friend class async_wait_queue_service;
+
+  // The service with which the queue is registered.
+  async_wait_queue_service& service_;
+
+  // The function that moves out the queued operations at shutdown.
+  shutdown_func_type shutdown_func_;
+
+  // Pointers to adjacent queues in the service's linked list.
+  async_wait_queue_base* next_;
+  async_wait_queue_base* prev_;
+};
+
+// The queue of wait operations shared by the asynchronous synchronisation
+// primitives.
+class async_wait_queue
+  : public async_wait_queue_base
+{
+public:
+  // Abort all waiters. Returns the number of operations cancelled.
+  NET_TS_DECL std::size_t cancel();
+
+protected:
+  // Constructor.
+  NET_TS_DECL explicit async_wait_queue(
+      std::experimental::net::v1::io_context& ioc);
+
+  // Destructor. Aborts any waiters.
+  NET_TS_DECL ~async_wait_queue();
+
+  // The operations waiting on the queue.
+  op_queue<wait_op> waiters_;
+
+private:
+  // Move out the waiters at shutdown.
+  NET_TS_DECL static void do_shutdown(
+      async_wait_queue_base* base, op_queue<operation>& ops);
+};
+
+// Service that keeps track of the wait queues created on an io_context.
+class async_wait_queue_service
+  : public execution_context_service_base<async_wait_queue_service>
+{
+public:
+  // Constructor.
+  NET_TS_DECL explicit async_wait_queue_service(execution_context& ctx);
+
+  // Destroy all waiters that are still queued.
+  NET_TS_DECL void shutdown();
+
+private:
+  friend class async_wait_queue_base;
+
+  // Add a queue to the linked list.
+  NET_TS_DECL void register_queue(async_wait_queue_base& q);
+
+  // Remove a queue from the linked list.
+  NET_TS_DECL void deregister_queue(async_wait_queue_base& q);
+
+  // Protects the linked list.
+  std::experimental::net::v1::detail::mutex mutex_;
+
+  // The head of a linked list of all queues.
+  async_wait_queue_base* queues_;
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#if defined(NET_TS_HEADER_ONLY)
+# include <experimental/__net_ts/detail/impl/async_wait_queue.ipp>
+#endif // defined(NET_TS_HEADER_ONLY)
+
+#endif // NET_TS_DETAIL_ASYNC_WAIT_QUEUE_HPP
@@ -42,6 +42,11 @@ typedef boost::detail::atomic_count atomic_count;
 inline void increment(atomic_count& a, long b) { while (b > 0) ++a, --b; }
 #endif // defined(NET_TS_HAS_STD_ATOMIC)
 
+#if defined(NET_TS_HAS_THREADS) && defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+// Used for the counts of a single-threaded io_context.
+inline void increment(long& a, long b) { a += b; }
+#endif // defined(NET_TS_HAS_THREADS) && defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+
 } // namespace detail
 } // inline namespace v1
 } // namespace net
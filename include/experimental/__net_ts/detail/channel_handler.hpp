@@ -0,0 +1,149 @@
+//
+// detail/channel_handler.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_CHANNEL_HANDLER_HPP
+#define NET_TS_DETAIL_CHANNEL_HANDLER_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <experimental/__net_ts/detail/bind_handler.hpp>
+#include <experimental/__net_ts/detail/channel_op.hpp>
+#include <experimental/__net_ts/detail/fenced_block.hpp>
+#include <experimental/__net_ts/detail/handler_alloc_helpers.hpp>
+#include <experimental/__net_ts/detail/handler_invoke_helpers.hpp>
+#include <experimental/__net_ts/detail/memory.hpp>
+#include <experimental/__net_ts/io_context.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+template <typename T, typename Handler>
+class channel_send_handler : public channel_send_op<T>
+{
+public:
+  NET_TS_DEFINE_HANDLER_PTR(channel_send_handler);
+
+  template <typename U>
+  channel_send_handler(NET_TS_MOVE_ARG(U) value, Handler& h)
+    : channel_send_op<T>(&channel_send_handler::do_complete,
+        NET_TS_MOVE_CAST(U)(value)),
+      handler_(NET_TS_MOVE_CAST(Handler)(h))
+  {
+    handler_work<Handler>::start(handler_);
+  }
+
+  static void do_complete(void* owner, operation* base,
+      const std::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    // Take ownership of the handler object.
+    channel_send_handler* h(static_cast<channel_send_handler*>(base));
+    ptr p = { std::experimental::net::v1::detail::addressof(h->handler_), h, h };
+    handler_work<Handler> w(h->handler_);
+
+    NET_TS_HANDLER_COMPLETION((*h));
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::binder1<Handler, std::error_code>
+      handler(h->handler_, h->ec_);
+    p.h = std::experimental::net::v1::detail::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      NET_TS_HANDLER_INVOCATION_BEGIN((handler.arg1_));
+      w.complete(handler, handler.handler_);
+      NET_TS_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  Handler handler_;
+};
+
+template <typename T, typename Handler>
+class channel_receive_handler : public channel_receive_op<T>
+{
+public:
+  NET_TS_DEFINE_HANDLER_PTR(channel_receive_handler);
+
+  channel_receive_handler(Handler& h)
+    : channel_receive_op<T>(&channel_receive_handler::do_complete),
+      handler_(NET_TS_MOVE_CAST(Handler)(h))
+  {
+    handler_work<Handler>::start(handler_);
+  }
+
+  static void do_complete(void* owner, operation* base,
+      const std::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    // Take ownership of the handler object.
+    channel_receive_handler* h(static_cast<channel_receive_handler*>(base));
+    ptr p = { std::experimental::net::v1::detail::addressof(h->handler_), h, h };
+    handler_work<Handler> w(h->handler_);
+
+    NET_TS_HANDLER_COMPLETION((*h));
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+#if defined(NET_TS_HAS_MOVE)
+    detail::move_binder2<Handler, std::error_code, T>
+      handler(0, NET_TS_MOVE_CAST(Handler)(h->handler_), h->ec_,
+          NET_TS_MOVE_CAST(T)(h->value_));
+#else // defined(NET_TS_HAS_MOVE)
+    detail::binder2<Handler, std::error_code, T>
+      handler(h->handler_, h->ec_, h->value_);
+#endif // defined(NET_TS_HAS_MOVE)
+    p.h = std::experimental::net::v1::detail::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      NET_TS_HANDLER_INVOCATION_BEGIN((handler.arg1_, "..."));
+      w.complete(handler, handler.handler_);
+      NET_TS_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  Handler handler_;
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_DETAIL_CHANNEL_HANDLER_HPP
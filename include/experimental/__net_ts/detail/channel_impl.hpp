@@ -0,0 +1,382 @@
+//
+// detail/channel_impl.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_CHANNEL_IMPL_HPP
+#define NET_TS_DETAIL_CHANNEL_IMPL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <experimental/__net_ts/error.hpp>
+#include <experimental/__net_ts/io_context.hpp>
+#include <experimental/__net_ts/detail/async_wait_queue.hpp>
+#include <experimental/__net_ts/detail/channel_op.hpp>
+#include <experimental/__net_ts/detail/channel_ring.hpp>
+#include <experimental/__net_ts/detail/mutex.hpp>
+#include <experimental/__net_ts/detail/op_queue.hpp>
+
+#if defined(NET_TS_HAS_STD_ATOMIC)
+# include <atomic>
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+// The state of a channel. Values pass through a lock-free ring. The mutex is
+// only taken to queue or wake a waiting operation, and a sender or receiver
+// that finds no one waiting on the other side never takes it.
+//
+// A waiter first counts itself as waiting and then checks the ring again,
+// while the other side first updates the ring and then checks the count. Both
+// sides separate the two steps with a full fence, so at least one of them
+// sees the other and the waiter is not left asleep.
+//
+// The waiting operations are registered with the io_context through the wait
+// queue base, so that any still waiting at shutdown are destroyed.
+template <typename T>
+class channel_impl
+  : private async_wait_queue_base
+{
+public:
+  // Constructor.
+  channel_impl(std::experimental::net::v1::io_context& ioc,
+      std::size_t capacity)
+    : async_wait_queue_base(ioc, &channel_impl::do_shutdown),
+      ring_(capacity),
+      open_(true)
+  {
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    open_hint_.store(true, std::memory_order_relaxed);
+    senders_waiting_.store(0, std::memory_order_relaxed);
+    receivers_waiting_.store(0, std::memory_order_relaxed);
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+  }
+
+  // Destructor. Aborts any waiters.
+  ~channel_impl()
+  {
+    cancel();
+  }
+
+  // Get the number of values the channel can hold.
+  std::size_t capacity() const
+  {
+    return ring_.capacity();
+  }
+
+  // Determine whether the channel is open.
+  bool is_open() const
+  {
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    return open_;
+  }
+
+  // Add a value without waiting. Returns false if the channel is full or
+  // closed, or if earlier sends are still waiting for space, in which case the
+  // value is left unchanged.
+  template <typename U>
+  bool try_send(NET_TS_MOVE_ARG(U) value)
+  {
+    if (!is_open_hint())
+      return false;
+    if (has_queued_senders())
+      return false;
+    if (!ring_.push(NET_TS_MOVE_CAST(U)(value)))
+      return false;
+    if (has_waiters(receivers_waiting_))
+      wake();
+    return true;
+  }
+
+  // Remove a value without waiting. Returns false if the channel is empty.
+  bool try_receive(T& value)
+  {
+    if (!ring_.pop(value))
+      return false;
+    if (has_waiters(senders_waiting_))
+      wake();
+    return true;
+  }
+
+  // Start a send. The operation completes once its value has been added to
+  // the channel, or with an error if the channel is closed. While other sends
+  // are waiting, the operation is queued behind them so that values are added
+  // in the order in which they were sent.
+  void start_send(channel_send_op<T>* op)
+  {
+    io_context_impl_.work_started();
+
+    if (try_send(NET_TS_MOVE_CAST(T)(op->value_)))
+    {
+      io_context_impl_.post_deferred_completion(op);
+      return;
+    }
+
+    op_queue<operation> ops;
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    if (open_)
+    {
+      senders_.push(op);
+      add_waiter(senders_waiting_);
+      transfer(ops);
+    }
+    else
+    {
+      op->ec_ = std::experimental::net::v1::error::broken_pipe;
+      ops.push(op);
+    }
+    lock.unlock();
+
+    io_context_impl_.post_deferred_completions(ops);
+  }
+
+  // Start a receive. The operation completes once a value has been removed
+  // from the channel on its behalf, or with an error if the channel is closed
+  // and empty.
+  void start_receive(channel_receive_op<T>* op)
+  {
+    io_context_impl_.work_started();
+
+    if (try_receive(op->value_))
+    {
+      io_context_impl_.post_deferred_completion(op);
+      return;
+    }
+
+    op_queue<operation> ops;
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    receivers_.push(op);
+    add_waiter(receivers_waiting_);
+    transfer(ops);
+    lock.unlock();
+
+    io_context_impl_.post_deferred_completions(ops);
+  }
+
+  // Close the channel. Waiting senders fail, and receivers fail once the
+  // channel is empty.
+  void close()
+  {
+    op_queue<operation> ops;
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    open_ = false;
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    open_hint_.store(false, std::memory_order_relaxed);
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+    transfer(ops);
+    while (channel_send_op<T>* op = senders_.front())
+    {
+      senders_.pop();
+      remove_waiter(senders_waiting_);
+      op->ec_ = std::experimental::net::v1::error::broken_pipe;
+      ops.push(op);
+    }
+    lock.unlock();
+
+    io_context_impl_.post_deferred_completions(ops);
+  }
+
+  // Abort all waiters. Returns the number of operations cancelled.
+  std::size_t cancel()
+  {
+    op_queue<operation> ops;
+    std::size_t n = 0;
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    while (channel_send_op<T>* op = senders_.front())
+    {
+      senders_.pop();
+      remove_waiter(senders_waiting_);
+      op->ec_ = std::experimental::net::v1::error::operation_aborted;
+      ops.push(op);
+      ++n;
+    }
+    while (channel_receive_op<T>* op = receivers_.front())
+    {
+      receivers_.pop();
+      remove_waiter(receivers_waiting_);
+      op->ec_ = std::experimental::net::v1::error::operation_aborted;
+      ops.push(op);
+      ++n;
+    }
+    lock.unlock();
+
+    io_context_impl_.post_deferred_completions(ops);
+    return n;
+  }
+
+private:
+#if defined(NET_TS_HAS_STD_ATOMIC)
+  typedef std::atomic<std::size_t> waiter_count;
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+  typedef std::size_t waiter_count;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+
+  // Whether the channel appears to be open, checked without the mutex. A send
+  // that races with close() may still be accepted.
+  bool is_open_hint() const
+  {
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    return open_hint_.load(std::memory_order_relaxed);
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+    return is_open();
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+  }
+
+  // Determine whether sends are waiting for space. A new value must not take a
+  // slot ahead of them.
+  bool has_queued_senders() const
+  {
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    return senders_waiting_.load(std::memory_order_relaxed) != 0;
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    return !senders_.empty();
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+  }
+
+  // Determine whether there may be waiters after updating the ring.
+  static bool has_waiters(const waiter_count& count)
+  {
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return count.load(std::memory_order_relaxed) != 0;
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+    (void)count;
+    return true;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+  }
+
+  // Count a waiter before checking the ring again. The mutex must be held.
+  static void add_waiter(waiter_count& count)
+  {
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    count.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+    ++count;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+  }
+
+  // Stop counting a waiter. The mutex must be held.
+  static void remove_waiter(waiter_count& count)
+  {
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    count.fetch_sub(1, std::memory_order_relaxed);
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+    --count;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+  }
+
+  // Move out the waiting operations at shutdown. The mutex is held.
+  static void do_shutdown(async_wait_queue_base* base, op_queue<operation>& ops)
+  {
+    channel_impl* impl = static_cast<channel_impl*>(base);
+    while (channel_send_op<T>* op = impl->senders_.front())
+    {
+      impl->senders_.pop();
+      remove_waiter(impl->senders_waiting_);
+      ops.push(op);
+    }
+    while (channel_receive_op<T>* op = impl->receivers_.front())
+    {
+      impl->receivers_.pop();
+      remove_waiter(impl->receivers_waiting_);
+      ops.push(op);
+    }
+  }
+
+  // Move values between the ring and any waiters, after the ring has changed.
+  void wake()
+  {
+    op_queue<operation> ops;
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    transfer(ops);
+    lock.unlock();
+
+    io_context_impl_.post_deferred_completions(ops);
+  }
+
+  // Give values to waiting receivers and take values from waiting senders
+  // until neither can make progress. Once the channel is closed and empty,
+  // waiting receivers fail. The mutex must be held.
+  void transfer(op_queue<operation>& ops)
+  {
+    for (bool progress = true; progress; )
+    {
+      progress = false;
+      while (channel_receive_op<T>* op = receivers_.front())
+      {
+        if (!ring_.pop(op->value_))
+          break;
+        receivers_.pop();
+        remove_waiter(receivers_waiting_);
+        ops.push(op);
+        progress = true;
+      }
+      while (channel_send_op<T>* op = senders_.front())
+      {
+        if (!ring_.push(NET_TS_MOVE_CAST(T)(op->value_)))
+          break;
+        senders_.pop();
+        remove_waiter(senders_waiting_);
+        ops.push(op);
+        progress = true;
+      }
+    }
+
+    if (!open_)
+    {
+      while (channel_receive_op<T>* op = receivers_.front())
+      {
+        receivers_.pop();
+        remove_waiter(receivers_waiting_);
+        op->ec_ = std::experimental::net::v1::error::eof;
+        ops.push(op);
+      }
+    }
+  }
+
+  // The values in the channel.
+  channel_ring<T> ring_;
+
+  // Whether the channel is open. Protected by the mutex, as are the waiters.
+  bool open_;
+
+#if defined(NET_TS_HAS_STD_ATOMIC)
+  // A copy of the open flag that may be read without the mutex.
+  std::atomic<bool> open_hint_;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+
+  // The operations waiting to send, and their number.
+  op_queue<channel_send_op<T> > senders_;
+  waiter_count senders_waiting_;
+
+  // The operations waiting to receive, and their number.
+  op_queue<channel_receive_op<T> > receivers_;
+  waiter_count receivers_waiting_;
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_DETAIL_CHANNEL_IMPL_HPP
@@ -0,0 +1,77 @@
+//
+// detail/channel_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_CHANNEL_OP_HPP
+#define NET_TS_DETAIL_CHANNEL_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <experimental/__net_ts/detail/operation.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+template <typename T>
+class channel_send_op
+  : public operation
+{
+public:
+  // The error code to be passed to the completion handler.
+  std::error_code ec_;
+
+  // The value being sent. Moved into the channel when the send completes
+  // successfully.
+  T value_;
+
+protected:
+  template <typename U>
+  channel_send_op(func_type func, NET_TS_MOVE_ARG(U) value)
+    : operation(func),
+      value_(NET_TS_MOVE_CAST(U)(value))
+  {
+  }
+};
+
+template <typename T>
+class channel_receive_op
+  : public operation
+{
+public:
+  // The error code to be passed to the completion handler.
+  std::error_code ec_;
+
+  // The value received, to be passed to the completion handler.
+  T value_;
+
+protected:
+  channel_receive_op(func_type func)
+    : operation(func),
+      value_()
+  {
+  }
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_DETAIL_CHANNEL_OP_HPP
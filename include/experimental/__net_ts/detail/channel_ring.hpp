@@ -0,0 +1,204 @@
+//
+// detail/channel_ring.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_CHANNEL_RING_HPP
+#define NET_TS_DETAIL_CHANNEL_RING_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <experimental/__net_ts/detail/noncopyable.hpp>
+
+#if defined(NET_TS_HAS_STD_ATOMIC)
+# include <atomic>
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+# include <experimental/__net_ts/detail/mutex.hpp>
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+// A bounded multiple-producer, multiple-consumer queue of values. Each slot
+// carries a sequence number that tells producers and consumers whether it is
+// free or full for the current lap of the ring, so that pushing and popping
+// take one compare-and-swap and never lock. Values are move-assigned into and
+// out of slots, which are default constructed up front.
+template <typename T>
+class channel_ring
+  : private noncopyable
+{
+public:
+  // Constructor. The capacity is rounded up to a power of two.
+  explicit channel_ring(std::size_t capacity)
+    : slots_(0),
+      mask_(0)
+  {
+    std::size_t n = 2;
+    while (n < capacity)
+      n <<= 1;
+    slots_ = new slot[n];
+    mask_ = n - 1;
+
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    for (std::size_t i = 0; i < n; ++i)
+      slots_[i].sequence_.store(i, std::memory_order_relaxed);
+    push_pos_.store(0, std::memory_order_relaxed);
+    pop_pos_.store(0, std::memory_order_relaxed);
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+    push_pos_ = 0;
+    pop_pos_ = 0;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+  }
+
+  // Destructor.
+  ~channel_ring()
+  {
+    delete[] slots_;
+  }
+
+  // Get the number of values the ring can hold.
+  std::size_t capacity() const
+  {
+    return mask_ + 1;
+  }
+
+  // Add a value to the ring. Returns false if the ring is full, in which case
+  // the value is left unchanged.
+  template <typename U>
+  bool push(NET_TS_MOVE_ARG(U) value)
+  {
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    std::size_t pos = push_pos_.load(std::memory_order_relaxed);
+    slot* s;
+    for (;;)
+    {
+      s = &slots_[pos & mask_];
+      std::size_t seq = s->sequence_.load(std::memory_order_acquire);
+      std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq - pos);
+      if (diff == 0)
+      {
+        if (push_pos_.compare_exchange_weak(pos, pos + 1,
+              std::memory_order_relaxed))
+          break;
+      }
+      else if (diff < 0)
+        return false;
+      else
+        pos = push_pos_.load(std::memory_order_relaxed);
+    }
+
+    s->value_ = NET_TS_MOVE_CAST(U)(value);
+    s->sequence_.store(pos + 1, std::memory_order_release);
+    return true;
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    if (push_pos_ - pop_pos_ > mask_)
+      return false;
+    slots_[push_pos_++ & mask_].value_ = NET_TS_MOVE_CAST(U)(value);
+    return true;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+  }
+
+  // Remove the oldest value from the ring. Returns false if the ring is empty.
+  bool pop(T& value)
+  {
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    std::size_t pos = pop_pos_.load(std::memory_order_relaxed);
+    slot* s;
+    for (;;)
+    {
+      s = &slots_[pos & mask_];
+      std::size_t seq = s->sequence_.load(std::memory_order_acquire);
+      std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+      if (diff == 0)
+      {
+        if (pop_pos_.compare_exchange_weak(pos, pos + 1,
+              std::memory_order_relaxed))
+          break;
+      }
+      else if (diff < 0)
+        return false;
+      else
+        pos = pop_pos_.load(std::memory_order_relaxed);
+    }
+
+    take(s->value_, value);
+    s->sequence_.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    if (pop_pos_ == push_pos_)
+      return false;
+    take(slots_[pop_pos_++ & mask_].value_, value);
+    return true;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+  }
+
+private:
+  // Move a value out of a slot, leaving the slot holding a default-constructed
+  // value so that it does not keep resources alive.
+  static void take(T& from, T& to)
+  {
+    to = NET_TS_MOVE_CAST(T)(from);
+    from = T();
+  }
+
+  // Enough padding to keep the producer and consumer positions on separate
+  // cache lines.
+  enum { cache_line_size = 64 };
+
+  struct slot
+  {
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    std::atomic<std::size_t> sequence_;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+    T value_;
+  };
+
+  // The slots, which hold up to mask_ + 1 values.
+  slot* slots_;
+  std::size_t mask_;
+
+#if defined(NET_TS_HAS_STD_ATOMIC)
+  char pad1_[cache_line_size];
+
+  // The position of the next slot to be pushed.
+  std::atomic<std::size_t> push_pos_;
+
+  char pad2_[cache_line_size];
+
+  // The position of the next slot to be popped.
+  std::atomic<std::size_t> pop_pos_;
+
+  char pad3_[cache_line_size];
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+  std::experimental::net::v1::detail::mutex mutex_;
+  std::size_t push_pos_;
+  std::size_t pop_pos_;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_DETAIL_CHANNEL_RING_HPP
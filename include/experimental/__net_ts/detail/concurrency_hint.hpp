@@ -39,12 +39,41 @@
     & NET_TS_CONCURRENCY_HINT_ID_MASK) \
       == NET_TS_CONCURRENCY_HINT_ID)
 
+// Defining NET_TS_DISABLE_IO_CONTEXT_THREADS makes every io_context in the
+// program behave as if it had been constructed with the
+// NET_TS_CONCURRENCY_HINT_UNSAFE hint, and removes at compile time the
+// locking, atomic operations and memory fences that the hint otherwise only
+// skips at run time. The scheduler records its running thread itself, so
+// checking whether a handler may be dispatched, and recycling the memory of
+// functions posted through the io_context's executor, need no lookup in
+// thread-specific storage. Socket and timer operations still allocate through
+// the default handler allocation hooks, which find the thread's memory cache
+// through the thread-specific call stack. It is intended for programs that
+// give each thread its own io_context. In addition to the restrictions of
+// NET_TS_CONCURRENCY_HINT_UNSAFE:
+//
+// - Functions must not be posted to an io_context from a thread other than
+//   the one running it, and io_context::producer must not be used.
+//
+// - The system_context, and so system_executor's post() and defer(), must
+//   not be used.
+//
+// - Asynchronous resolve operations always fail with operation_not_supported,
+//   as they are performed on a background thread. When
+//   NET_TS_ENABLE_DNS_RESOLVER is also defined, forward resolution runs on the
+//   io_context itself and is not affected, but resolving an endpoint to a
+//   name still fails.
+
 // Helper macro to determine if locking is enabled for a given facility.
-#define NET_TS_CONCURRENCY_HINT_IS_LOCKING(facility, hint) \
+#if defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+# define NET_TS_CONCURRENCY_HINT_IS_LOCKING(facility, hint) false
+#else // defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+# define NET_TS_CONCURRENCY_HINT_IS_LOCKING(facility, hint) \
   (((static_cast<unsigned>(hint) \
     & (NET_TS_CONCURRENCY_HINT_ID_MASK \
       | NET_TS_CONCURRENCY_HINT_LOCKING_ ## facility)) \
         ^ NET_TS_CONCURRENCY_HINT_ID) != 0)
+#endif // defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
 
 // This special concurrency hint disables locking in both the scheduler and
 // reactor I/O. This hint has the following restrictions:
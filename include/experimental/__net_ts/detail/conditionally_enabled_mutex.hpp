@@ -107,10 +107,16 @@ public:
   };
 
   // Constructor.
+#if defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+  explicit conditionally_enabled_mutex(bool)
+  {
+  }
+#else // defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
   explicit conditionally_enabled_mutex(bool enabled)
     : enabled_(enabled)
   {
   }
+#endif // defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
 
   // Destructor.
   ~conditionally_enabled_mutex()
@@ -141,7 +147,12 @@ private:
   friend class scoped_lock;
   friend class conditionally_enabled_event;
   std::experimental::net::v1::detail::mutex mutex_;
+#if defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+  // Locking is disabled at compile time, so that the checks fold away.
+  static const bool enabled_ = false;
+#else // defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
   const bool enabled_;
+#endif // defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
 };
 
 } // namespace detail
@@ -517,6 +517,15 @@
         // || defined(NET_TS_HAS_BOOST_CHRONO)
 #endif // !defined(NET_TS_HAS_CHRONO)
 
+// Asynchronous resolution using the built-in DNS client.
+#if !defined(NET_TS_HAS_DNS_RESOLVER)
+# if defined(NET_TS_ENABLE_DNS_RESOLVER)
+#  if !defined(NET_TS_WINDOWS_RUNTIME) && defined(NET_TS_HAS_CHRONO)
+#   define NET_TS_HAS_DNS_RESOLVER 1
+#  endif // !defined(NET_TS_WINDOWS_RUNTIME) && defined(NET_TS_HAS_CHRONO)
+# endif // defined(NET_TS_ENABLE_DNS_RESOLVER)
+#endif // !defined(NET_TS_HAS_DNS_RESOLVER)
+
 // Boost support for the DateTime library.
 #if !defined(NET_TS_HAS_BOOST_DATE_TIME)
 # if !defined(NET_TS_DISABLE_BOOST_DATE_TIME)
@@ -1014,7 +1023,7 @@
 # include <unistd.h>
 #endif // defined(NET_TS_HAS_UNISTD_H)
 
-// Linux: epoll, eventfd and timerfd.
+// Linux: epoll, eventfd, timerfd and futex.
 #if defined(__linux__)
 # include <linux/version.h>
 # if !defined(NET_TS_HAS_EPOLL)
@@ -1038,6 +1047,13 @@
 #   endif // (__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 8)
 #  endif // defined(NET_TS_HAS_EPOLL)
 # endif // !defined(NET_TS_HAS_TIMERFD)
+# if !defined(NET_TS_HAS_FUTEX)
+#  if !defined(NET_TS_DISABLE_FUTEX)
+#   if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,22)
+#    define NET_TS_HAS_FUTEX 1
+#   endif // LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,22)
+#  endif // !defined(NET_TS_DISABLE_FUTEX)
+# endif // !defined(NET_TS_HAS_FUTEX)
 #endif // defined(__linux__)
 
 // Mac OS X, FreeBSD, NetBSD, OpenBSD: kqueue.
@@ -0,0 +1,563 @@
+//
+// detail/connection_pool.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_CONNECTION_POOL_HPP
+#define NET_TS_DETAIL_CONNECTION_POOL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+
+#if defined(NET_TS_HAS_CHRONO) && defined(NET_TS_HAS_MOVE)
+
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <vector>
+#include <experimental/__net_ts/basic_stream_socket.hpp>
+#include <experimental/__net_ts/buffer.hpp>
+#include <experimental/__net_ts/error.hpp>
+#include <experimental/__net_ts/io_context.hpp>
+#include <experimental/__net_ts/socket_base.hpp>
+#include <experimental/__net_ts/steady_timer.hpp>
+#include <experimental/__net_ts/detail/chrono.hpp>
+#include <experimental/__net_ts/detail/connection_pool_op.hpp>
+#include <experimental/__net_ts/detail/memory.hpp>
+#include <experimental/__net_ts/detail/mutex.hpp>
+#include <experimental/__net_ts/detail/noncopyable.hpp>
+#include <experimental/__net_ts/detail/op_queue.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+// The state of a connection pool. The state is shared with the handlers for
+// the pool's internal asynchronous operations, so that it outlives the pool
+// object until those operations have completed.
+template <typename Protocol>
+class connection_pool
+  : private noncopyable
+{
+public:
+  typedef typename Protocol::endpoint endpoint_type;
+  typedef basic_stream_socket<Protocol> socket_type;
+  typedef connection_pool_op<Protocol> op;
+  typedef chrono::steady_clock clock_type;
+
+  // Constructor.
+  explicit connection_pool(std::experimental::net::v1::io_context& ioc)
+    : io_context_(ioc),
+      io_context_impl_(use_service<io_context_impl>(ioc)),
+      timer_(ioc),
+      timer_armed_(false),
+      idle_count_(0),
+      max_idle_(default_max_idle),
+      max_in_flight_(~std::size_t(0)),
+      idle_timeout_(chrono::seconds(default_idle_timeout))
+  {
+  }
+
+  // Get the io_context associated with the pool.
+  std::experimental::net::v1::io_context& get_io_context()
+  {
+    return io_context_;
+  }
+
+  // Set the maximum number of idle connections kept for each endpoint.
+  void set_max_idle(std::size_t n)
+  {
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    max_idle_ = n;
+  }
+
+  // Get the maximum number of idle connections kept for each endpoint.
+  std::size_t max_idle() const
+  {
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    return max_idle_;
+  }
+
+  // Set the maximum number of connections, for each endpoint, that may be
+  // checked out or in the process of being established.
+  void set_max_in_flight(std::size_t n)
+  {
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    max_in_flight_ = n;
+  }
+
+  // Get the maximum number of in-flight connections for each endpoint.
+  std::size_t max_in_flight() const
+  {
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    return max_in_flight_;
+  }
+
+  // Set the time after which an idle connection is closed.
+  void set_idle_timeout(const clock_type::duration& d)
+  {
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    idle_timeout_ = d;
+  }
+
+  // Get the time after which an idle connection is closed.
+  clock_type::duration idle_timeout() const
+  {
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    return idle_timeout_;
+  }
+
+  // Get the total number of idle connections.
+  std::size_t idle_count() const
+  {
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    return idle_count_;
+  }
+
+  // Get the number of in-flight connections for an endpoint.
+  std::size_t in_flight(const endpoint_type& endpoint) const
+  {
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    typename endpoint_map::const_iterator i = endpoints_.find(endpoint);
+    return i == endpoints_.end() ? 0 : i->second.in_flight_;
+  }
+
+  // Start an operation to obtain a connection to the endpoint. The operation
+  // is given an idle connection if a live one exists, otherwise a new
+  // connection is established. If the in-flight limit has been reached the
+  // operation waits for a connection to be returned.
+  static void checkout(const shared_ptr<connection_pool>& self,
+      const endpoint_type& endpoint, op* o)
+  {
+    self->io_context_impl_.work_started();
+
+    op_queue<operation> ops;
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(self->mutex_);
+    endpoint_state& es = self->endpoints_[endpoint];
+    if (es.waiters_.empty() && es.in_flight_ < self->max_in_flight_)
+      assign(self, endpoint, es, o, ops, lock);
+    else
+      es.waiters_.push(o);
+    lock.unlock();
+
+    self->io_context_impl_.post_deferred_completions(ops);
+  }
+
+  // Return a connection to the pool. A closed socket indicates that the
+  // connection is no longer usable.
+  static void checkin(const shared_ptr<connection_pool>& self,
+      const endpoint_type& endpoint, socket_type& socket)
+  {
+    bool alive = socket.is_open() && is_alive(socket);
+
+    op_queue<operation> ops;
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(self->mutex_);
+    typename endpoint_map::iterator i = self->endpoints_.find(endpoint);
+    if (i == self->endpoints_.end())
+      i = self->endpoints_.insert(i, std::make_pair(endpoint, endpoint_state()));
+    endpoint_state& es = i->second;
+    if (es.in_flight_ > 0)
+      --es.in_flight_;
+
+    if (alive && !es.waiters_.empty())
+    {
+      // Hand the connection straight to the oldest waiting operation.
+      op* o = static_cast<op*>(es.waiters_.front());
+      es.waiters_.pop();
+      o->socket_ = NET_TS_MOVE_CAST(socket_type)(socket);
+      ++es.in_flight_;
+      ops.push(o);
+    }
+    else if (alive && es.idle_.size() < self->max_idle_)
+    {
+      idle_connection c(NET_TS_MOVE_CAST(socket_type)(socket),
+          clock_type::now() + self->idle_timeout_);
+      es.idle_.push_back(NET_TS_MOVE_CAST(idle_connection)(c));
+      ++self->idle_count_;
+      start_timer(self, es.idle_.back().expiry_);
+    }
+    else
+    {
+      std::error_code ignored_ec;
+      socket.close(ignored_ec);
+      serve_waiters(self, endpoint, es, ops, lock);
+    }
+
+    self->prune(i);
+    lock.unlock();
+
+    self->io_context_impl_.post_deferred_completions(ops);
+  }
+
+  // Close all idle connections and abort all pending operations.
+  static void close(const shared_ptr<connection_pool>& self)
+  {
+    op_queue<operation> ops;
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(self->mutex_);
+
+    typename endpoint_map::iterator i = self->endpoints_.begin();
+    while (i != self->endpoints_.end())
+    {
+      endpoint_state& es = i->second;
+      es.idle_.clear();
+      while (op* o = static_cast<op*>(es.waiters_.front()))
+      {
+        es.waiters_.pop();
+        o->ec_ = std::experimental::net::v1::error::operation_aborted;
+        ops.push(o);
+      }
+      self->prune(i++);
+    }
+    self->idle_count_ = 0;
+
+    // Cancel connection attempts. Their handlers release the in-flight slots.
+    std::error_code ignored_ec;
+    for (std::size_t j = 0; j < self->connecting_.size(); ++j)
+      if (shared_ptr<pending_connect> pc = self->connecting_[j].lock())
+        if (pc->op_)
+          pc->op_->socket_.close(ignored_ec);
+    self->connecting_.clear();
+
+    self->timer_.cancel();
+    lock.unlock();
+
+    self->io_context_impl_.post_deferred_completions(ops);
+  }
+
+private:
+  // Default limits.
+  enum
+  {
+    default_max_idle = 8,
+    default_idle_timeout = 60
+  };
+
+  // An idle connection and the time at which it is to be closed.
+  struct idle_connection
+  {
+    idle_connection(socket_type&& socket,
+        const clock_type::time_point& expiry)
+      : socket_(NET_TS_MOVE_CAST(socket_type)(socket)),
+        expiry_(expiry)
+    {
+    }
+
+    socket_type socket_;
+    clock_type::time_point expiry_;
+  };
+
+  // The connections and operations associated with an endpoint.
+  struct endpoint_state
+  {
+    endpoint_state()
+      : in_flight_(0)
+    {
+    }
+
+    endpoint_state(endpoint_state&& other)
+      : idle_(NET_TS_MOVE_CAST(std::deque<idle_connection>)(other.idle_)),
+        in_flight_(other.in_flight_)
+    {
+      waiters_.push(other.waiters_);
+    }
+
+    // Idle connections, with the most recently used at the back.
+    std::deque<idle_connection> idle_;
+
+    // The number of connections checked out or being established.
+    std::size_t in_flight_;
+
+    // Operations waiting for the in-flight count to fall below the limit.
+    op_queue<operation> waiters_;
+  };
+
+  typedef std::map<endpoint_type, endpoint_state> endpoint_map;
+
+  // A connection attempt. The operation is destroyed if the attempt's handler
+  // is destroyed without being invoked.
+  struct pending_connect
+    : private noncopyable
+  {
+    explicit pending_connect(op* o)
+      : op_(o)
+    {
+    }
+
+    ~pending_connect()
+    {
+      if (op_)
+        op_->destroy();
+    }
+
+    op* op_;
+  };
+
+  // Handler for the completion of a connection attempt.
+  class connect_handler
+  {
+  public:
+    connect_handler(const shared_ptr<connection_pool>& pool,
+        const shared_ptr<pending_connect>& pc, const endpoint_type& endpoint)
+      : pool_(pool),
+        pc_(pc),
+        endpoint_(endpoint)
+    {
+    }
+
+    void operator()(const std::error_code& ec)
+    {
+      op_queue<operation> ops;
+      std::experimental::net::v1::detail::mutex::scoped_lock lock(
+          pool_->mutex_);
+      op* o = pc_->op_;
+      pc_->op_ = 0;
+      if (ec)
+      {
+        o->ec_ = ec;
+        std::error_code ignored_ec;
+        o->socket_.close(ignored_ec);
+        release(pool_, endpoint_, ops, lock);
+      }
+      ops.push(o);
+      lock.unlock();
+
+      pool_->io_context_impl_.post_deferred_completions(ops);
+    }
+
+  private:
+    shared_ptr<connection_pool> pool_;
+    shared_ptr<pending_connect> pc_;
+    endpoint_type endpoint_;
+  };
+
+  // Handler for the idle eviction timer.
+  class timer_handler
+  {
+  public:
+    explicit timer_handler(const shared_ptr<connection_pool>& pool)
+      : pool_(pool)
+    {
+    }
+
+    void operator()(const std::error_code&)
+    {
+      std::experimental::net::v1::detail::mutex::scoped_lock lock(
+          pool_->mutex_);
+      pool_->timer_armed_ = false;
+      evict_idle(pool_);
+    }
+
+  private:
+    shared_ptr<connection_pool> pool_;
+  };
+
+  // Check whether the peer has closed an idle connection, or sent data that
+  // nobody is waiting for, by peeking without blocking.
+  static bool is_alive(socket_type& socket)
+  {
+    std::error_code ec;
+    bool non_blocking = socket.non_blocking();
+    socket.non_blocking(true, ec);
+    if (ec)
+      return false;
+
+    char data;
+    socket.receive(std::experimental::net::v1::buffer(&data, 1),
+        socket_base::message_peek, ec);
+
+    std::error_code ignored_ec;
+    socket.non_blocking(non_blocking, ignored_ec);
+    return ec == std::experimental::net::v1::error::would_block;
+  }
+
+  // Give an operation a live idle connection, or start establishing a new
+  // one. The caller's lock is released while each idle connection is probed.
+  // The operation's in-flight slot keeps the endpoint's state from being
+  // pruned meanwhile.
+  static void assign(const shared_ptr<connection_pool>& self,
+      const endpoint_type& endpoint, endpoint_state& es, op* o,
+      op_queue<operation>& ops,
+      std::experimental::net::v1::detail::mutex::scoped_lock& lock)
+  {
+    ++es.in_flight_;
+
+    while (!es.idle_.empty())
+    {
+      socket_type socket(NET_TS_MOVE_CAST(socket_type)(es.idle_.back().socket_));
+      es.idle_.pop_back();
+      --self->idle_count_;
+
+      lock.unlock();
+      bool alive = is_alive(socket);
+      if (!alive)
+      {
+        std::error_code ignored_ec;
+        socket.close(ignored_ec);
+      }
+      lock.lock();
+
+      if (alive)
+      {
+        o->socket_ = NET_TS_MOVE_CAST(socket_type)(socket);
+        ops.push(o);
+        return;
+      }
+    }
+
+    shared_ptr<pending_connect> pc(new pending_connect(o));
+    typename std::vector<weak_ptr<pending_connect> >::iterator i =
+      self->connecting_.begin();
+    while (i != self->connecting_.end())
+    {
+      if (i->expired())
+        i = self->connecting_.erase(i);
+      else
+        ++i;
+    }
+    self->connecting_.push_back(pc);
+    o->socket_.async_connect(endpoint, connect_handler(self, pc, endpoint));
+  }
+
+  // Release an in-flight slot, allowing a waiting operation to proceed. The
+  // caller's lock must be held, and is released as described for assign().
+  static void release(const shared_ptr<connection_pool>& self,
+      const endpoint_type& endpoint, op_queue<operation>& ops,
+      std::experimental::net::v1::detail::mutex::scoped_lock& lock)
+  {
+    typename endpoint_map::iterator i = self->endpoints_.find(endpoint);
+    if (i == self->endpoints_.end())
+      return;
+    if (i->second.in_flight_ > 0)
+      --i->second.in_flight_;
+    serve_waiters(self, endpoint, i->second, ops, lock);
+    self->prune(i);
+  }
+
+  // Start waiting operations while the in-flight limit allows. The caller's
+  // lock must be held, and is released as described for assign().
+  static void serve_waiters(const shared_ptr<connection_pool>& self,
+      const endpoint_type& endpoint, endpoint_state& es,
+      op_queue<operation>& ops,
+      std::experimental::net::v1::detail::mutex::scoped_lock& lock)
+  {
+    while (!es.waiters_.empty() && es.in_flight_ < self->max_in_flight_)
+    {
+      op* o = static_cast<op*>(es.waiters_.front());
+      es.waiters_.pop();
+      assign(self, endpoint, es, o, ops, lock);
+    }
+  }
+
+  // Arm the eviction timer if it is not already running. The mutex must be
+  // held by the caller.
+  static void start_timer(const shared_ptr<connection_pool>& self,
+      const clock_type::time_point& expiry)
+  {
+    if (!self->timer_armed_)
+    {
+      self->timer_armed_ = true;
+      self->timer_.expires_at(expiry);
+      self->timer_.async_wait(timer_handler(self));
+    }
+  }
+
+  // Close idle connections that have expired, and rearm the timer for the
+  // next expiry. Connections that the peer has closed are found when they are
+  // next checked out, as probing each one here would cost system calls for
+  // every idle connection while the mutex is held. The mutex must be held by
+  // the caller.
+  static void evict_idle(const shared_ptr<connection_pool>& self)
+  {
+    clock_type::time_point now = clock_type::now();
+    clock_type::time_point next_expiry = (clock_type::time_point::max)();
+
+    typename endpoint_map::iterator i = self->endpoints_.begin();
+    while (i != self->endpoints_.end())
+    {
+      std::deque<idle_connection>& idle = i->second.idle_;
+      typename std::deque<idle_connection>::iterator j = idle.begin();
+      while (j != idle.end())
+      {
+        if (j->expiry_ <= now)
+        {
+          j = idle.erase(j);
+          --self->idle_count_;
+        }
+        else
+        {
+          if (j->expiry_ < next_expiry)
+            next_expiry = j->expiry_;
+          ++j;
+        }
+      }
+      self->prune(i++);
+    }
+
+    if (self->idle_count_ > 0)
+      start_timer(self, next_expiry);
+  }
+
+  // Remove the state for an endpoint if it is no longer needed. The mutex
+  // must be held by the caller.
+  void prune(typename endpoint_map::iterator i)
+  {
+    if (i->second.idle_.empty() && i->second.in_flight_ == 0
+        && i->second.waiters_.empty())
+      endpoints_.erase(i);
+  }
+
+  // The io_context used for the pool's connections.
+  std::experimental::net::v1::io_context& io_context_;
+
+  // The io_context implementation used to post completions.
+  io_context_impl& io_context_impl_;
+
+  // Mutex to protect access to the data below.
+  mutable std::experimental::net::v1::detail::mutex mutex_;
+
+  // The connections and waiting operations for each endpoint.
+  endpoint_map endpoints_;
+
+  // Connection attempts that are in progress.
+  std::vector<weak_ptr<pending_connect> > connecting_;
+
+  // Timer used to close idle connections.
+  std::experimental::net::v1::steady_timer timer_;
+
+  // Whether the timer has a wait outstanding.
+  bool timer_armed_;
+
+  // The total number of idle connections.
+  std::size_t idle_count_;
+
+  // The limits applied to each endpoint.
+  std::size_t max_idle_;
+  std::size_t max_in_flight_;
+
+  // The time after which an idle connection is closed.
+  clock_type::duration idle_timeout_;
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // defined(NET_TS_HAS_CHRONO) && defined(NET_TS_HAS_MOVE)
+
+#endif // NET_TS_DETAIL_CONNECTION_POOL_HPP
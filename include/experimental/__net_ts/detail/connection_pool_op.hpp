@@ -0,0 +1,119 @@
+//
+// detail/connection_pool_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_CONNECTION_POOL_OP_HPP
+#define NET_TS_DETAIL_CONNECTION_POOL_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <experimental/__net_ts/basic_stream_socket.hpp>
+#include <experimental/__net_ts/error.hpp>
+#include <experimental/__net_ts/io_context.hpp>
+#include <experimental/__net_ts/detail/bind_handler.hpp>
+#include <experimental/__net_ts/detail/fenced_block.hpp>
+#include <experimental/__net_ts/detail/handler_alloc_helpers.hpp>
+#include <experimental/__net_ts/detail/handler_invoke_helpers.hpp>
+#include <experimental/__net_ts/detail/handler_work.hpp>
+#include <experimental/__net_ts/detail/memory.hpp>
+#include <experimental/__net_ts/detail/operation.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+template <typename Protocol>
+class connection_pool_op : public operation
+{
+public:
+  // The error code to be passed to the completion handler.
+  std::error_code ec_;
+
+  // The connection to be passed to the completion handler.
+  basic_stream_socket<Protocol> socket_;
+
+protected:
+  connection_pool_op(std::experimental::net::v1::io_context& ioc,
+      func_type complete_func)
+    : operation(complete_func),
+      socket_(ioc)
+  {
+  }
+};
+
+template <typename Protocol, typename Handler>
+class connection_pool_checkout_op : public connection_pool_op<Protocol>
+{
+public:
+  NET_TS_DEFINE_HANDLER_PTR(connection_pool_checkout_op);
+
+  connection_pool_checkout_op(std::experimental::net::v1::io_context& ioc,
+      Handler& handler)
+    : connection_pool_op<Protocol>(ioc,
+        &connection_pool_checkout_op::do_complete),
+      handler_(NET_TS_MOVE_CAST(Handler)(handler))
+  {
+    handler_work<Handler>::start(handler_);
+  }
+
+  static void do_complete(void* owner, operation* base,
+      const std::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    // Take ownership of the handler object.
+    connection_pool_checkout_op* o(
+        static_cast<connection_pool_checkout_op*>(base));
+    ptr p = { std::experimental::net::v1::detail::addressof(o->handler_), o, o };
+    handler_work<Handler> w(o->handler_);
+
+    NET_TS_HANDLER_COMPLETION((*o));
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::move_binder2<Handler,
+      std::error_code, basic_stream_socket<Protocol> >
+        handler(0, NET_TS_MOVE_CAST(Handler)(o->handler_), o->ec_,
+          NET_TS_MOVE_CAST(basic_stream_socket<Protocol>)(o->socket_));
+    p.h = std::experimental::net::v1::detail::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      NET_TS_HANDLER_INVOCATION_BEGIN((handler.arg1_, "..."));
+      w.complete(handler, handler.handler_);
+      NET_TS_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  Handler handler_;
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_DETAIL_CONNECTION_POOL_OP_HPP
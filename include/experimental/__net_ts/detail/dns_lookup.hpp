@@ -0,0 +1,654 @@
+//
+// detail/dns_lookup.hpp
+// ~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_DNS_LOOKUP_HPP
+#define NET_TS_DETAIL_DNS_LOOKUP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+
+#if defined(NET_TS_HAS_DNS_RESOLVER)
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <experimental/__net_ts/basic_datagram_socket.hpp>
+#include <experimental/__net_ts/basic_stream_socket.hpp>
+#include <experimental/__net_ts/bind_executor.hpp>
+#include <experimental/__net_ts/buffer.hpp>
+#include <experimental/__net_ts/io_context.hpp>
+#include <experimental/__net_ts/post.hpp>
+#include <experimental/__net_ts/read.hpp>
+#include <experimental/__net_ts/steady_timer.hpp>
+#include <experimental/__net_ts/strand.hpp>
+#include <experimental/__net_ts/write.hpp>
+#include <experimental/__net_ts/ip/basic_endpoint.hpp>
+#include <experimental/__net_ts/ip/basic_resolver_query.hpp>
+#include <experimental/__net_ts/ip/basic_resolver_results.hpp>
+#include <experimental/__net_ts/detail/dns_ops.hpp>
+#include <experimental/__net_ts/detail/memory.hpp>
+#include <experimental/__net_ts/detail/noncopyable.hpp>
+#include <experimental/__net_ts/detail/op_queue.hpp>
+#include <experimental/__net_ts/detail/resolver_cache.hpp>
+#include <experimental/__net_ts/detail/type_traits.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+// Protocol type used to talk to name servers. The ip::udp and ip::tcp classes
+// cannot be used here as they depend on the resolver.
+template <int Type, int Proto>
+class dns_transport
+{
+public:
+  typedef std::experimental::net::v1::ip::basic_endpoint<dns_transport> endpoint;
+
+  typedef typename conditional<Type == NET_TS_OS_DEF(SOCK_DGRAM),
+    basic_datagram_socket<dns_transport>,
+    basic_stream_socket<dns_transport> >::type socket;
+
+  static dns_transport v4()
+  {
+    return dns_transport(NET_TS_OS_DEF(AF_INET));
+  }
+
+  static dns_transport v6()
+  {
+    return dns_transport(NET_TS_OS_DEF(AF_INET6));
+  }
+
+  int type() const
+  {
+    return Type;
+  }
+
+  int protocol() const
+  {
+    return Proto;
+  }
+
+  int family() const
+  {
+    return family_;
+  }
+
+  friend bool operator==(const dns_transport& p1, const dns_transport& p2)
+  {
+    return p1.family_ == p2.family_;
+  }
+
+  friend bool operator!=(const dns_transport& p1, const dns_transport& p2)
+  {
+    return p1.family_ != p2.family_;
+  }
+
+private:
+  explicit dns_transport(int protocol_family)
+    : family_(protocol_family)
+  {
+  }
+
+  int family_;
+};
+
+typedef dns_transport<NET_TS_OS_DEF(SOCK_DGRAM),
+    NET_TS_OS_DEF(IPPROTO_UDP)> dns_udp;
+typedef dns_transport<NET_TS_OS_DEF(SOCK_STREAM),
+    NET_TS_OS_DEF(IPPROTO_TCP)> dns_tcp;
+
+// Performs a single forward lookup by sending A and AAAA queries to the
+// configured name servers. Queries are sent over UDP, falling back to TCP when
+// a response is truncated. All state is accessed through a strand, and the
+// object is kept alive by the handlers for its outstanding operations.
+template <typename Protocol>
+class dns_lookup
+  : private noncopyable
+{
+public:
+  typedef typename resolver_cache<Protocol>::op op;
+  typedef std::experimental::net::v1::ip::basic_resolver_query<Protocol> query_type;
+  typedef std::experimental::net::v1::ip::basic_resolver_results<Protocol> results_type;
+
+  // Construct a lookup that completes the given operation. The query types
+  // that are not wanted should be passed a zero query identifier.
+  dns_lookup(std::experimental::net::v1::io_context& ioc,
+      io_context_impl& ioc_impl, resolver_cache<Protocol>& cache,
+      const dns_ops::config& cfg, unsigned short name_server_port,
+      const query_type& query, unsigned short port, op* o,
+      unsigned short aaaa_id, unsigned short a_id)
+    : strand_(ioc.get_executor()),
+      io_context_impl_(ioc_impl),
+      cache_(cache),
+      config_(cfg),
+      name_server_port_(name_server_port),
+      query_(query),
+      port_(port),
+      op_(o),
+      aaaa_(ioc, 0, dns_ops::type_aaaa, aaaa_id),
+      a_(ioc, 1, dns_ops::type_a, a_id),
+      pending_(0),
+      cancelled_(false),
+      abandoned_(false)
+  {
+  }
+
+  // Destructor. The operation is destroyed if the lookup never completed.
+  ~dns_lookup()
+  {
+    if (op_)
+      op_->destroy();
+  }
+
+  // Begin the lookup.
+  static void start(const shared_ptr<dns_lookup>& self)
+  {
+    std::experimental::net::v1::post(self->strand_,
+        handler(self, 0, 0, start_event));
+  }
+
+  // Check whether the operation has been cancelled, and stop the lookup if no
+  // other operations are waiting on its result.
+  static void cancel(const shared_ptr<dns_lookup>& self)
+  {
+    std::experimental::net::v1::post(self->strand_,
+        handler(self, 0, 0, cancel_event));
+  }
+
+private:
+  // The type of the strand used to serialise access to the lookup's state.
+  typedef std::experimental::net::v1::strand<
+    std::experimental::net::v1::io_context::executor_type> strand_type;
+
+  // The events that drive the lookup.
+  enum event_type
+  {
+    start_event,
+    cancel_event,
+    send_event,
+    receive_event,
+    timeout_event,
+    connect_event,
+    write_event,
+    read_length_event,
+    read_body_event
+  };
+
+  // Handler used to deliver events to the lookup.
+  class handler
+  {
+  public:
+    handler(const shared_ptr<dns_lookup>& self,
+        int index, unsigned int generation, event_type event)
+      : self_(self),
+        index_(index),
+        generation_(generation),
+        event_(event)
+    {
+    }
+
+    void operator()()
+    {
+      self_->handle_event(self_, index_, generation_,
+          event_, std::error_code(), 0);
+    }
+
+    void operator()(const std::error_code& ec)
+    {
+      self_->handle_event(self_, index_, generation_, event_, ec, 0);
+    }
+
+    void operator()(const std::error_code& ec, std::size_t bytes)
+    {
+      self_->handle_event(self_, index_, generation_, event_, ec, bytes);
+    }
+
+  private:
+    shared_ptr<dns_lookup> self_;
+    int index_;
+    unsigned int generation_;
+    event_type event_;
+  };
+
+  // The state of the query for a single record type.
+  struct transaction
+  {
+    transaction(std::experimental::net::v1::io_context& ioc,
+        int index, unsigned short qtype, unsigned short id)
+      : index_(index),
+        qtype_(qtype),
+        id_(id),
+        udp_socket_(ioc),
+        tcp_socket_(ioc),
+        timer_(ioc),
+        tries_(0),
+        generation_(0),
+        active_(false),
+        status_(dns_ops::response_server_failure)
+    {
+    }
+
+    // The index of the transaction within the lookup.
+    int index_;
+
+    // The record type being queried, and the identifier of the query. An
+    // identifier of zero indicates that the record type is not wanted.
+    unsigned short qtype_;
+    unsigned short id_;
+
+    // The encoded query, and the same query prefixed by its length for TCP.
+    std::vector<unsigned char> query_;
+    std::vector<unsigned char> tcp_query_;
+
+    // Buffers for the response.
+    std::vector<unsigned char> response_;
+    unsigned char length_[2];
+
+    // The name server currently being queried.
+    std::experimental::net::v1::ip::address server_;
+
+    // The source of the last datagram received.
+    dns_udp::endpoint sender_;
+
+    // The sockets and timer used to perform the query.
+    dns_udp::socket udp_socket_;
+    dns_tcp::socket tcp_socket_;
+    std::experimental::net::v1::steady_timer timer_;
+
+    // The number of times a name server has been queried.
+    std::size_t tries_;
+
+    // Incremented whenever a new attempt is started, so that the handlers for
+    // earlier attempts may be identified and ignored.
+    unsigned int generation_;
+
+    // Whether the query is in progress.
+    bool active_;
+
+    // The outcome of the query, and the addresses received.
+    dns_ops::response_status status_;
+    std::vector<std::experimental::net::v1::ip::address> addresses_;
+  };
+
+  // Get the transaction with the specified index.
+  transaction& get_transaction(int index)
+  {
+    return index == 0 ? aaaa_ : a_;
+  }
+
+  // Dispatch an event to the appropriate function.
+  void handle_event(const shared_ptr<dns_lookup>& self, int index,
+      unsigned int generation, event_type event,
+      const std::error_code& ec, std::size_t bytes)
+  {
+    if (event == start_event)
+      return do_start(self);
+    if (event == cancel_event)
+      return do_cancel();
+
+    transaction& t = get_transaction(index);
+    if (!t.active_ || t.generation_ != generation)
+      return;
+
+    switch (event)
+    {
+    case send_event:
+      if (ec)
+        send_udp(self, t);
+      else
+        receive_udp(self, t);
+      break;
+    case receive_event:
+      if (ec)
+        send_udp(self, t);
+      else if (t.sender_ != dns_udp::endpoint(t.server_, name_server_port_))
+        receive_udp(self, t);
+      else
+        handle_response(self, t, bytes, false);
+      break;
+    case timeout_event:
+      if (!ec)
+        send_udp(self, t);
+      break;
+    case connect_event:
+      if (ec)
+        send_udp(self, t);
+      else
+      {
+        std::experimental::net::v1::async_write(t.tcp_socket_,
+            std::experimental::net::v1::buffer(t.tcp_query_),
+            make_handler(self, t, write_event));
+      }
+      break;
+    case write_event:
+      if (ec)
+        send_udp(self, t);
+      else
+      {
+        std::experimental::net::v1::async_read(t.tcp_socket_,
+            std::experimental::net::v1::buffer(t.length_),
+            make_handler(self, t, read_length_event));
+      }
+      break;
+    case read_length_event:
+      if (ec || (t.length_[0] == 0 && t.length_[1] == 0))
+        send_udp(self, t);
+      else
+      {
+        t.response_.resize((t.length_[0] << 8) | t.length_[1]);
+        std::experimental::net::v1::async_read(t.tcp_socket_,
+            std::experimental::net::v1::buffer(t.response_),
+            make_handler(self, t, read_body_event));
+      }
+      break;
+    case read_body_event:
+      if (ec)
+        send_udp(self, t);
+      else
+        handle_response(self, t, t.response_.size(), true);
+      break;
+    default:
+      break;
+    }
+  }
+
+  // Create a handler for an event belonging to the current attempt.
+  executor_binder<handler, strand_type> make_handler(
+      const shared_ptr<dns_lookup>& self,
+      const transaction& t, event_type event)
+  {
+    return std::experimental::net::v1::bind_executor(strand_,
+        handler(self, t.index_, t.generation_, event));
+  }
+
+  // Start the queries.
+  void do_start(const shared_ptr<dns_lookup>& self)
+  {
+    std::string name(dns_ops::normalise_name(query_.host_name()));
+
+    for (int i = 0; i < 2; ++i)
+    {
+      transaction& t = get_transaction(i);
+      if (t.id_ == 0)
+        continue;
+      if (dns_ops::encode_query(name, t.id_, t.qtype_, t.query_))
+      {
+        t.active_ = true;
+        ++pending_;
+      }
+      else
+        t.status_ = dns_ops::response_name_error;
+    }
+
+    if (pending_ == 0)
+      return complete();
+
+    for (int i = 0; i < 2; ++i)
+    {
+      transaction& t = get_transaction(i);
+      if (t.active_)
+        send_udp(self, t);
+    }
+  }
+
+  // Stop the lookup if the operation has been cancelled.
+  void do_cancel()
+  {
+    if (!op_ || cancelled_ || !op_->cancel_token_.expired())
+      return;
+
+    cancelled_ = true;
+    if (cache_.abandon(query_))
+    {
+      abandoned_ = true;
+      for (int i = 0; i < 2; ++i)
+      {
+        transaction& t = get_transaction(i);
+        if (t.active_)
+          finish(t, dns_ops::response_server_failure);
+      }
+    }
+  }
+
+  // Send the query to the next name server, or finish the transaction if all
+  // attempts have been exhausted.
+  void send_udp(const shared_ptr<dns_lookup>& self, transaction& t)
+  {
+    close(t);
+
+    std::size_t max_tries = config_.name_servers_.size() * config_.attempts_;
+    std::error_code ec;
+    do
+    {
+      if (t.tries_ >= max_tries)
+        return finish(t, t.status_);
+
+      t.server_ = config_.name_servers_[t.tries_++
+        % config_.name_servers_.size()];
+      t.udp_socket_.open(t.server_.is_v4()
+          ? dns_udp::v4() : dns_udp::v6(), ec);
+    } while (ec);
+
+    t.udp_socket_.async_send_to(
+        std::experimental::net::v1::buffer(t.query_),
+        dns_udp::endpoint(t.server_, name_server_port_),
+        make_handler(self, t, send_event));
+    start_timer(self, t);
+  }
+
+  // Wait for a response from the name server.
+  void receive_udp(const shared_ptr<dns_lookup>& self, transaction& t)
+  {
+    t.response_.resize(dns_ops::max_udp_message);
+    t.udp_socket_.async_receive_from(
+        std::experimental::net::v1::buffer(t.response_),
+        t.sender_, make_handler(self, t, receive_event));
+  }
+
+  // Repeat the query over TCP to the same name server.
+  void send_tcp(const shared_ptr<dns_lookup>& self, transaction& t)
+  {
+    close(t);
+
+    t.tcp_query_.clear();
+    t.tcp_query_.push_back(static_cast<unsigned char>(t.query_.size() >> 8));
+    t.tcp_query_.push_back(static_cast<unsigned char>(t.query_.size()));
+    t.tcp_query_.insert(t.tcp_query_.end(), t.query_.begin(), t.query_.end());
+
+    t.tcp_socket_.async_connect(
+        dns_tcp::endpoint(t.server_, name_server_port_),
+        make_handler(self, t, connect_event));
+    start_timer(self, t);
+  }
+
+  // Limit the time spent waiting on the current attempt.
+  void start_timer(const shared_ptr<dns_lookup>& self, transaction& t)
+  {
+    t.timer_.expires_after(std::experimental::net::v1::chrono::seconds(
+          config_.timeout_));
+    t.timer_.async_wait(make_handler(self, t, timeout_event));
+  }
+
+  // Process a response received from the name server.
+  void handle_response(const shared_ptr<dns_lookup>& self,
+      transaction& t, std::size_t length, bool over_tcp)
+  {
+    std::vector<std::experimental::net::v1::ip::address> addresses;
+    switch (dns_ops::decode_response(&t.response_[0],
+          length, t.query_, addresses))
+    {
+    case dns_ops::response_unrelated:
+      if (over_tcp)
+        send_udp(self, t);
+      else
+        receive_udp(self, t);
+      break;
+    case dns_ops::response_truncated:
+      if (over_tcp)
+        send_udp(self, t);
+      else
+        send_tcp(self, t);
+      break;
+    case dns_ops::response_success:
+      t.addresses_.swap(addresses);
+      finish(t, dns_ops::response_success);
+      break;
+    case dns_ops::response_name_error:
+      finish(t, dns_ops::response_name_error);
+      break;
+    default:
+      send_udp(self, t);
+      break;
+    }
+  }
+
+  // Abandon the current attempt, causing its handlers to be ignored.
+  void close(transaction& t)
+  {
+    ++t.generation_;
+    std::error_code ignored_ec;
+    t.udp_socket_.close(ignored_ec);
+    t.tcp_socket_.close(ignored_ec);
+    t.timer_.cancel();
+  }
+
+  // Finish a transaction, completing the lookup if it was the last.
+  void finish(transaction& t, dns_ops::response_status status)
+  {
+    close(t);
+    t.active_ = false;
+    t.status_ = status;
+    if (--pending_ == 0)
+      complete();
+  }
+
+  // Combine the results of the transactions and complete the operation.
+  void complete()
+  {
+    typedef typename Protocol::endpoint endpoint_type;
+    namespace ip = std::experimental::net::v1::ip;
+
+    int family = query_.hints().ai_family;
+    int flags = query_.hints().ai_flags;
+    bool map_v4 = family == NET_TS_OS_DEF(AF_INET6)
+      && (flags & ip::resolver_base::v4_mapped) != 0;
+
+    std::vector<endpoint_type> endpoints;
+    for (std::size_t i = 0; i < aaaa_.addresses_.size(); ++i)
+      endpoints.push_back(endpoint_type(aaaa_.addresses_[i], port_));
+    if (!map_v4 || endpoints.empty()
+        || (flags & ip::resolver_base::all_matching) != 0)
+    {
+      for (std::size_t i = 0; i < a_.addresses_.size(); ++i)
+      {
+        if (map_v4)
+        {
+          endpoints.push_back(endpoint_type(ip::make_address_v6(
+                  ip::v4_mapped, a_.addresses_[i].to_v4()), port_));
+        }
+        else
+          endpoints.push_back(endpoint_type(a_.addresses_[i], port_));
+      }
+    }
+
+    std::error_code ec;
+    results_type results;
+    if (abandoned_)
+      ec = std::experimental::net::v1::error::operation_aborted;
+    else if (!endpoints.empty())
+    {
+      results = results_type::create(endpoints.begin(), endpoints.end(),
+          query_.host_name(), query_.service_name());
+    }
+    else if (answered(aaaa_) || answered(a_))
+      ec = std::experimental::net::v1::error::host_not_found;
+    else
+      ec = std::experimental::net::v1::error::host_not_found_try_again;
+
+    // An abandoned lookup is no longer known to the cache, which may now be
+    // tracking a newer lookup for the same query.
+    op_queue<operation> ops;
+    if (!abandoned_)
+      cache_.complete(query_, ec, results, ops);
+
+    if (cancelled_ || op_->cancel_token_.expired())
+      op_->ec_ = std::experimental::net::v1::error::operation_aborted;
+    else
+    {
+      op_->ec_ = ec;
+      op_->results_ = results;
+    }
+    ops.push(op_);
+    op_ = 0;
+
+    io_context_impl_.post_deferred_completions(ops);
+  }
+
+  // Determine whether a name server gave a definitive answer to a query.
+  static bool answered(const transaction& t)
+  {
+    return t.id_ != 0 && (t.status_ == dns_ops::response_success
+        || t.status_ == dns_ops::response_name_error);
+  }
+
+  // The strand used to serialise access to the lookup's state.
+  strand_type strand_;
+
+  // The io_context implementation used to post completions.
+  io_context_impl& io_context_impl_;
+
+  // The cache used to pass the result to any operations that joined this one.
+  resolver_cache<Protocol>& cache_;
+
+  // The name servers and retry policy.
+  dns_ops::config config_;
+
+  // The port on which the name servers listen.
+  unsigned short name_server_port_;
+
+  // The query being resolved, and the port to use in the results.
+  query_type query_;
+  unsigned short port_;
+
+  // The operation to be completed.
+  op* op_;
+
+  // The AAAA and A queries.
+  transaction aaaa_;
+  transaction a_;
+
+  // The number of transactions still in progress.
+  int pending_;
+
+  // Whether the operation has been cancelled.
+  bool cancelled_;
+
+  // Whether the lookup was stopped because nothing needs its result.
+  bool abandoned_;
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // defined(NET_TS_HAS_DNS_RESOLVER)
+
+#endif // NET_TS_DETAIL_DNS_LOOKUP_HPP
@@ -0,0 +1,131 @@
+//
+// detail/dns_ops.hpp
+// ~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_DNS_OPS_HPP
+#define NET_TS_DETAIL_DNS_OPS_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+#include <experimental/__net_ts/ip/address.hpp>
+
+#if !defined(NET_TS_DNS_RESOLV_CONF)
+# define NET_TS_DNS_RESOLV_CONF "/etc/resolv.conf"
+#endif // !defined(NET_TS_DNS_RESOLV_CONF)
+
+#if !defined(NET_TS_DNS_HOSTS)
+# define NET_TS_DNS_HOSTS "/etc/hosts"
+#endif // !defined(NET_TS_DNS_HOSTS)
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+namespace dns_ops {
+
+// DNS constants.
+enum
+{
+  // The well-known port on which name servers listen.
+  default_port = 53,
+
+  // The largest DNS message that may be carried in a UDP datagram.
+  max_udp_message = 512,
+
+  // Resource record types.
+  type_a = 1,
+  type_aaaa = 28,
+
+  // Resource record class for the Internet.
+  class_in = 1
+};
+
+// The outcome of decoding a DNS response.
+enum response_status
+{
+  // The message is not a response to the query and should be ignored.
+  response_unrelated,
+
+  // The response was truncated and the query must be retried over TCP.
+  response_truncated,
+
+  // The response was decoded. Any addresses have been extracted.
+  response_success,
+
+  // The name server reported that the name does not exist.
+  response_name_error,
+
+  // The name server could not process the query, so another should be tried.
+  response_server_failure
+};
+
+// Name resolution settings, as read from resolv.conf.
+struct config
+{
+  // The addresses of the name servers to query, in order of preference.
+  std::vector<std::experimental::net::v1::ip::address> name_servers_;
+
+  // The number of seconds to wait for a response from a name server.
+  int timeout_;
+
+  // The number of times to try each name server.
+  int attempts_;
+};
+
+// Host name to address mappings, as read from the hosts file.
+typedef std::multimap<std::string,
+    std::experimental::net::v1::ip::address> hosts;
+
+// Read resolver settings from the named file, using defaults for any that are
+// missing.
+NET_TS_DECL void read_resolv_conf(const char* path, config& cfg);
+
+// Read host name to address mappings from the named file.
+NET_TS_DECL void read_hosts(const char* path, hosts& h);
+
+// Normalise a host name for lookup by converting it to lower case and
+// removing any trailing dot.
+NET_TS_DECL std::string normalise_name(const std::string& name);
+
+// Build a query for the given name and record type. Returns false if the name
+// is not a valid domain name.
+NET_TS_DECL bool encode_query(const std::string& name, unsigned short id,
+    unsigned short qtype, std::vector<unsigned char>& message);
+
+// Decode a response to a query built by encode_query, appending the addresses
+// of any records of the queried type to the vector. A response whose ID or
+// question does not match the query is treated as unrelated.
+NET_TS_DECL response_status decode_response(const unsigned char* data,
+    std::size_t length, const std::vector<unsigned char>& query,
+    std::vector<std::experimental::net::v1::ip::address>& addresses);
+
+} // namespace dns_ops
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#if defined(NET_TS_HEADER_ONLY)
+# include <experimental/__net_ts/detail/impl/dns_ops.ipp>
+#endif // defined(NET_TS_HEADER_ONLY)
+
+#endif // NET_TS_DETAIL_DNS_OPS_HPP
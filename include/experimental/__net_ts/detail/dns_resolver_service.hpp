@@ -0,0 +1,473 @@
+//
+// detail/dns_resolver_service.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_DNS_RESOLVER_SERVICE_HPP
+#define NET_TS_DETAIL_DNS_RESOLVER_SERVICE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+
+#if defined(NET_TS_HAS_DNS_RESOLVER)
+
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include <experimental/__net_ts/ip/basic_resolver_query.hpp>
+#include <experimental/__net_ts/ip/basic_resolver_results.hpp>
+#include <experimental/__net_ts/ip/resolver_base.hpp>
+#include <experimental/__net_ts/detail/dns_lookup.hpp>
+#include <experimental/__net_ts/detail/dns_ops.hpp>
+#include <experimental/__net_ts/detail/memory.hpp>
+#include <experimental/__net_ts/detail/mutex.hpp>
+#include <experimental/__net_ts/detail/resolve_endpoint_op.hpp>
+#include <experimental/__net_ts/detail/resolve_query_op.hpp>
+#include <experimental/__net_ts/detail/resolver_cache.hpp>
+#include <experimental/__net_ts/detail/resolver_service_base.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+// Resolver service that performs asynchronous forward resolution by talking
+// directly to the configured name servers, rather than by calling getaddrinfo
+// on a background thread. Synchronous and reverse resolution continue to use
+// the system resolver.
+template <typename Protocol>
+class dns_resolver_service :
+  public service_base<dns_resolver_service<Protocol> >,
+  public resolver_service_base
+{
+public:
+  // The implementation type of the resolver. A cancellation token is used to
+  // indicate to the asynchronous operation that the operation has been
+  // cancelled.
+  typedef socket_ops::shared_cancel_token_type implementation_type;
+
+  // The endpoint type.
+  typedef typename Protocol::endpoint endpoint_type;
+
+  // The query type.
+  typedef std::experimental::net::v1::ip::basic_resolver_query<Protocol> query_type;
+
+  // The results type.
+  typedef std::experimental::net::v1::ip::basic_resolver_results<Protocol> results_type;
+
+  // Constructor.
+  dns_resolver_service(std::experimental::net::v1::io_context& io_context)
+    : service_base<dns_resolver_service<Protocol> >(io_context),
+      resolver_service_base(io_context),
+      name_server_port_(dns_ops::default_port),
+      random_(std::random_device()())
+  {
+    dns_ops::read_resolv_conf(NET_TS_DNS_RESOLV_CONF, config_);
+    dns_ops::read_hosts(NET_TS_DNS_HOSTS, hosts_);
+  }
+
+  // Destroy all user-defined handler objects owned by the service.
+  void shutdown()
+  {
+    this->base_shutdown();
+    cache_.shutdown();
+  }
+
+  // Perform any fork-related housekeeping.
+  void notify_fork(std::experimental::net::v1::io_context::fork_event fork_ev)
+  {
+    this->base_notify_fork(fork_ev);
+  }
+
+  // Destroy a resolver implementation.
+  void destroy(implementation_type& impl)
+  {
+    socket_ops::weak_cancel_token_type owner(impl);
+    resolver_service_base::destroy(impl);
+    cancel_lookups(owner);
+  }
+
+  // Move-assign from another resolver implementation.
+  void move_assign(implementation_type& impl,
+      dns_resolver_service& other_service,
+      implementation_type& other_impl)
+  {
+    socket_ops::weak_cancel_token_type owner(impl);
+    resolver_service_base::move_assign(impl, other_service, other_impl);
+    cancel_lookups(owner);
+  }
+
+  // Cancel pending asynchronous operations.
+  void cancel(implementation_type& impl)
+  {
+    socket_ops::weak_cancel_token_type owner(impl);
+    resolver_service_base::cancel(impl);
+    cancel_lookups(owner);
+  }
+
+  // Set a resolver option.
+  template <typename Option>
+  std::error_code set_option(implementation_type&,
+      const Option& option, std::error_code& ec)
+  {
+    namespace opt = std::experimental::net::v1::ip::detail::resolver_option;
+    if (option.name() == opt::name_server_port_name)
+    {
+      if (option.value() <= 0 || option.value() > 0xFFFF)
+      {
+        ec = std::experimental::net::v1::error::invalid_argument;
+        return ec;
+      }
+
+      std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+      name_server_port_ = static_cast<unsigned short>(option.value());
+      ec = std::error_code();
+      return ec;
+    }
+    if (resolver_cache<Protocol>::is_cache_option(option.name()))
+      return cache_.set_option(option.name(), option.value(), ec);
+    return resolver_service_base::set_option(
+        option.name(), option.value(), ec);
+  }
+
+  // Get a resolver option.
+  template <typename Option>
+  std::error_code get_option(const implementation_type&,
+      Option& option, std::error_code& ec) const
+  {
+    namespace opt = std::experimental::net::v1::ip::detail::resolver_option;
+    if (option.name() == opt::name_server_port_name)
+    {
+      std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+      option.data() = name_server_port_;
+      ec = std::error_code();
+      return ec;
+    }
+    if (resolver_cache<Protocol>::is_cache_option(option.name()))
+      return cache_.get_option(option.name(), option.data(), ec);
+    return resolver_service_base::get_option(
+        option.name(), option.data(), ec);
+  }
+
+  // Resolve a query to a list of entries.
+  results_type resolve(implementation_type&, const query_type& query,
+      std::error_code& ec)
+  {
+    results_type results;
+    if (cache_.lookup(query, results, ec))
+      return results;
+
+    std::experimental::net::v1::detail::addrinfo_type* address_info = 0;
+
+    socket_ops::getaddrinfo(query.host_name().c_str(),
+        query.service_name().c_str(), query.hints(), &address_info, ec);
+    auto_addrinfo auto_address_info(address_info);
+
+    if (!ec)
+    {
+      results = results_type::create(
+          address_info, query.host_name(), query.service_name());
+    }
+    cache_.insert(query, ec, results);
+    return results;
+  }
+
+  // Asynchronously resolve a query to a list of entries.
+  template <typename Handler>
+  void async_resolve(implementation_type& impl,
+      const query_type& query, Handler& handler)
+  {
+    // Allocate and construct an operation to wrap the handler.
+    typedef resolve_query_op<Protocol, Handler> op;
+    typename op::ptr p = { std::experimental::net::v1::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(impl, query, cache_, io_context_impl_, handler);
+
+    NET_TS_HANDLER_CREATION((io_context_impl_.context(),
+          *p.p, "resolver", &impl, 0, "async_resolve"));
+
+    // Complete immediately if the query can be answered without contacting a
+    // name server, otherwise share the result of an identical lookup that is
+    // already in progress.
+    unsigned short port = 0;
+    if (cache_.lookup(query, p.p->results_, p.p->ec_)
+        || resolve_locally(query, port, p.p->results_, p.p->ec_))
+      io_context_impl_.post_immediate_completion(p.p, false);
+    else if (cache_.join(query, p.p))
+      io_context_impl_.work_started();
+    else
+      start_lookup(impl, query, port, p.p);
+    p.v = p.p = 0;
+  }
+
+  // Resolve an endpoint to a list of entries.
+  results_type resolve(implementation_type&,
+      const endpoint_type& endpoint, std::error_code& ec)
+  {
+    char host_name[NI_MAXHOST];
+    char service_name[NI_MAXSERV];
+    socket_ops::sync_getnameinfo(endpoint.data(), endpoint.size(),
+        host_name, NI_MAXHOST, service_name, NI_MAXSERV,
+        endpoint.protocol().type(), ec);
+
+    return ec ? results_type() : results_type::create(
+        endpoint, host_name, service_name);
+  }
+
+  // Asynchronously resolve an endpoint to a list of entries.
+  template <typename Handler>
+  void async_resolve(implementation_type& impl,
+      const endpoint_type& endpoint, Handler& handler)
+  {
+    // Allocate and construct an operation to wrap the handler.
+    typedef resolve_endpoint_op<Protocol, Handler> op;
+    typename op::ptr p = { std::experimental::net::v1::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(impl, endpoint, io_context_impl_, handler);
+
+    NET_TS_HANDLER_CREATION((io_context_impl_.context(),
+          *p.p, "resolver", &impl, 0, "async_resolve"));
+
+    start_resolve_op(p.p);
+    p.v = p.p = 0;
+  }
+
+private:
+  typedef dns_lookup<Protocol> lookup_type;
+
+  // Determine the port for the query's service name, and attempt to answer
+  // the query from the host name alone or from the hosts file. Returns true
+  // if the query has been answered, or has failed.
+  bool resolve_locally(const query_type& query, unsigned short& port,
+      results_type& results, std::error_code& ec)
+  {
+    namespace ip = std::experimental::net::v1::ip;
+    int flags = query.hints().ai_flags;
+    int family = query.hints().ai_family;
+
+    const std::string& service = query.service_name();
+    if (service.empty())
+      port = 0;
+    else if (service.find_first_not_of("0123456789") == std::string::npos)
+    {
+      unsigned long value = std::strtoul(service.c_str(), 0, 10);
+      if (value > 0xFFFF)
+      {
+        ec = std::experimental::net::v1::error::service_not_found;
+        return true;
+      }
+      port = static_cast<unsigned short>(value);
+    }
+    else if (flags & ip::resolver_base::numeric_service)
+    {
+      ec = std::experimental::net::v1::error::service_not_found;
+      return true;
+    }
+    else
+    {
+      // Service names are looked up locally, so this does not block.
+      std::experimental::net::v1::detail::addrinfo_type hints
+        = std::experimental::net::v1::detail::addrinfo_type();
+      hints.ai_family = NET_TS_OS_DEF(AF_INET);
+      hints.ai_socktype = query.hints().ai_socktype;
+      hints.ai_protocol = query.hints().ai_protocol;
+      hints.ai_flags = NET_TS_OS_DEF(AI_PASSIVE);
+      std::experimental::net::v1::detail::addrinfo_type* address_info = 0;
+      socket_ops::getaddrinfo(0, service.c_str(), hints, &address_info, ec);
+      auto_addrinfo auto_address_info(address_info);
+      if (ec)
+        return true;
+      port = socket_ops::network_to_host_short(
+          reinterpret_cast<std::experimental::net::v1::detail::sockaddr_in4_type*>(
+            address_info->ai_addr)->sin_port);
+    }
+
+    std::vector<ip::address> addresses;
+    const std::string& host = query.host_name();
+    if (host.empty())
+    {
+      bool passive = (flags & ip::resolver_base::passive) != 0;
+      if (family != NET_TS_OS_DEF(AF_INET))
+      {
+        addresses.push_back(passive ? ip::address_v6::any()
+            : ip::address_v6::loopback());
+      }
+      if (family != NET_TS_OS_DEF(AF_INET6))
+      {
+        addresses.push_back(passive ? ip::address_v4::any()
+            : ip::address_v4::loopback());
+      }
+    }
+    else
+    {
+      std::error_code address_ec;
+      ip::address address = ip::make_address(host.c_str(), address_ec);
+      if (!address_ec)
+        addresses.push_back(address);
+      else if (flags & ip::resolver_base::numeric_host)
+      {
+        ec = std::experimental::net::v1::error::host_not_found;
+        return true;
+      }
+      else
+      {
+        std::pair<dns_ops::hosts::const_iterator,
+          dns_ops::hosts::const_iterator> range =
+            hosts_.equal_range(dns_ops::normalise_name(host));
+        for (; range.first != range.second; ++range.first)
+          addresses.push_back(range.first->second);
+      }
+
+      if (addresses.empty())
+        return false;
+    }
+
+    std::vector<endpoint_type> endpoints;
+    for (std::size_t i = 0; i < addresses.size(); ++i)
+    {
+      if (addresses[i].is_v6())
+      {
+        if (family != NET_TS_OS_DEF(AF_INET))
+          endpoints.push_back(endpoint_type(addresses[i], port));
+      }
+      else if (family != NET_TS_OS_DEF(AF_INET6))
+        endpoints.push_back(endpoint_type(addresses[i], port));
+      else if (flags & ip::resolver_base::v4_mapped)
+      {
+        endpoints.push_back(endpoint_type(ip::make_address_v6(
+                ip::v4_mapped, addresses[i].to_v4()), port));
+      }
+    }
+
+    if (endpoints.empty())
+      ec = std::experimental::net::v1::error::host_not_found;
+    else
+    {
+      ec = std::error_code();
+      results = results_type::create(endpoints.begin(), endpoints.end(),
+          query.host_name(), query.service_name());
+    }
+    return true;
+  }
+
+  // Start a lookup to complete the operation.
+  void start_lookup(const implementation_type& owner, const query_type& query,
+      unsigned short port, typename lookup_type::op* o)
+  {
+    namespace ip = std::experimental::net::v1::ip;
+    int flags = query.hints().ai_flags;
+    int family = query.hints().ai_family;
+    bool want_aaaa = family != NET_TS_OS_DEF(AF_INET);
+    bool want_a = family != NET_TS_OS_DEF(AF_INET6)
+      || (flags & ip::resolver_base::v4_mapped) != 0;
+
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    shared_ptr<lookup_type> lookup(new lookup_type(this->get_io_context(),
+          io_context_impl_, cache_, config_, name_server_port_, query, port, o,
+          want_aaaa ? next_query_id() : 0, want_a ? next_query_id() : 0));
+
+    // Keep track of the lookup so that it can be cancelled through the
+    // resolver that started it. Only that resolver's finished lookups are
+    // pruned here, as the others are removed when their resolver is cancelled
+    // or destroyed.
+    socket_ops::weak_cancel_token_type key(owner);
+    std::pair<typename lookup_map::iterator,
+      typename lookup_map::iterator> range = lookups_.equal_range(key);
+    while (range.first != range.second)
+    {
+      if (range.first->second.expired())
+        lookups_.erase(range.first++);
+      else
+        ++range.first;
+    }
+    lookups_.insert(typename lookup_map::value_type(key, lookup));
+    lock.unlock();
+
+    io_context_impl_.work_started();
+    lookup_type::start(lookup);
+  }
+
+  // Ask the lookups started through a resolver to check whether their
+  // operation has been cancelled. The owner's cancellation token has already
+  // been replaced, so its lookups can no longer be reached through it and are
+  // removed.
+  void cancel_lookups(const socket_ops::weak_cancel_token_type& owner)
+  {
+    std::vector<shared_ptr<lookup_type> > lookups;
+
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    std::pair<typename lookup_map::iterator,
+      typename lookup_map::iterator> range = lookups_.equal_range(owner);
+    for (typename lookup_map::iterator i = range.first;
+        i != range.second; ++i)
+    {
+      if (shared_ptr<lookup_type> lookup = i->second.lock())
+        lookups.push_back(lookup);
+    }
+    lookups_.erase(range.first, range.second);
+    lock.unlock();
+
+    for (std::size_t i = 0; i < lookups.size(); ++i)
+      lookup_type::cancel(lookups[i]);
+  }
+
+  // Generate a random, non-zero query identifier. The mutex must be held by
+  // the caller.
+  unsigned short next_query_id()
+  {
+    unsigned short id = 0;
+    while (id == 0)
+      id = static_cast<unsigned short>(random_());
+    return id;
+  }
+
+  // Cached results and in-progress lookups for forward resolution.
+  resolver_cache<Protocol> cache_;
+
+  // The name servers and retry policy, as read from resolv.conf.
+  dns_ops::config config_;
+
+  // The contents of the hosts file.
+  dns_ops::hosts hosts_;
+
+  // Mutex to protect access to the data below.
+  mutable std::experimental::net::v1::detail::mutex mutex_;
+
+  // The port on which the name servers listen.
+  unsigned short name_server_port_;
+
+  // The random number generator used for query identifiers.
+  std::mt19937 random_;
+
+  // The lookups that may still be in progress, keyed by the cancellation
+  // token of the resolver that started them.
+  typedef std::multimap<socket_ops::weak_cancel_token_type,
+    weak_ptr<lookup_type>,
+    std::owner_less<socket_ops::weak_cancel_token_type> > lookup_map;
+  lookup_map lookups_;
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // defined(NET_TS_HAS_DNS_RESOLVER)
+
+#endif // NET_TS_DETAIL_DNS_RESOLVER_SERVICE_HPP
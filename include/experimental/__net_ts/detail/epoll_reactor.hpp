@@ -21,21 +21,29 @@
 
 #include <experimental/__net_ts/detail/atomic_count.hpp>
 #include <experimental/__net_ts/detail/conditionally_enabled_mutex.hpp>
+#include <experimental/__net_ts/detail/cstdint.hpp>
 #include <experimental/__net_ts/detail/limits.hpp>
-#include <experimental/__net_ts/detail/object_pool.hpp>
 #include <experimental/__net_ts/detail/op_queue.hpp>
 #include <experimental/__net_ts/detail/reactor_op.hpp>
 #include <experimental/__net_ts/detail/select_interrupter.hpp>
+#include <experimental/__net_ts/detail/slab_object_pool.hpp>
 #include <experimental/__net_ts/detail/socket_types.hpp>
 #include <experimental/__net_ts/detail/timer_queue_base.hpp>
 #include <experimental/__net_ts/detail/timer_queue_set.hpp>
 #include <experimental/__net_ts/detail/wait_op.hpp>
 #include <experimental/__net_ts/execution_context.hpp>
+#include <cstddef>
+#include <vector>
+#include <sys/epoll.h>
 
 #if defined(NET_TS_HAS_TIMERFD)
 # include <sys/timerfd.h>
 #endif // defined(NET_TS_HAS_TIMERFD)
 
+#if defined(NET_TS_HAS_STD_ATOMIC)
+# include <atomic>
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+
 #include <experimental/__net_ts/detail/push_options.hpp>
 
 namespace std {
@@ -51,6 +59,9 @@ private:
   // The mutex type used by this reactor.
   typedef conditionally_enabled_mutex mutex;
 
+  // The queue of operation deadlines.
+  class deadline_queue;
+
 public:
   enum op_types { read_op = 0, write_op = 1,
     connect_op = 1, except_op = 2, max_ops = 3 };
@@ -59,11 +70,9 @@ public:
   class descriptor_state : operation
   {
     friend class epoll_reactor;
+    friend class deadline_queue;
     friend class object_pool_access;
 
-    descriptor_state* next_;
-    descriptor_state* prev_;
-
     mutex mutex_;
     epoll_reactor* reactor_;
     int descriptor_;
@@ -71,11 +80,15 @@ public:
     op_queue<reactor_op> op_queue_[max_ops];
     bool try_speculative_[max_ops];
     bool shutdown_;
+    uint64_t op_timeout_;
+    bool has_deadline_;
+    std::size_t deadline_index_;
 
     NET_TS_DECL descriptor_state(bool locking);
     void set_ready_events(uint32_t events) { task_result_ = events; }
     void add_ready_events(uint32_t events) { task_result_ |= events; }
     NET_TS_DECL operation* perform_io(uint32_t events);
+    NET_TS_DECL uint64_t time_out_ops(uint64_t now, op_queue<operation>& ops);
     NET_TS_DECL static void do_complete(
         void* owner, operation* base,
         const std::error_code& ec, std::size_t bytes_transferred);
@@ -111,6 +124,25 @@ public:
       int op_type, socket_type descriptor,
       per_descriptor_data& descriptor_data, reactor_op* op);
 
+  // Set whether readiness of the descriptor wakes only one of the reactors
+  // waiting on the same open file. Returns 0 on success, system error code on
+  // failure.
+  NET_TS_DECL int set_exclusive_wakeup(socket_type descriptor,
+      per_descriptor_data& descriptor_data, bool enable);
+
+  // Set the timeout, in microseconds, for operations that are started on the
+  // descriptor and must wait for readiness. An operation that is still
+  // waiting when the timeout elapses fails with the timed_out error. A
+  // timeout of 0 disables it. Returns 0 on success, system error code on
+  // failure.
+  NET_TS_DECL int set_op_timeout(
+      per_descriptor_data& descriptor_data, uint64_t usec);
+
+  // Get the timeout, in microseconds, for operations started on the
+  // descriptor.
+  NET_TS_DECL uint64_t op_timeout(
+      const per_descriptor_data& descriptor_data);
+
   // Move descriptor registration from one descriptor_data object to another.
   NET_TS_DECL void move_descriptor(socket_type descriptor,
       per_descriptor_data& target_descriptor_data,
@@ -123,10 +155,12 @@ public:
   }
 
   // Start a new operation. The reactor operation will be performed when the
-  // given descriptor is flagged as ready, or an error has occurred.
+  // given descriptor is flagged as ready, or an error has occurred. If the
+  // operation completes speculatively and allow_inline is true, the handler
+  // may be invoked before start_op returns.
   NET_TS_DECL void start_op(int op_type, socket_type descriptor,
       per_descriptor_data& descriptor_data, reactor_op* op,
-      bool is_continuation, bool allow_speculative);
+      bool is_continuation, bool allow_speculative, bool allow_inline = false);
 
   // Cancel all operations associated with the given descriptor. The
   // handlers associated with the descriptor will be invoked with the
@@ -134,6 +168,14 @@ public:
   NET_TS_DECL void cancel_ops(socket_type descriptor,
       per_descriptor_data& descriptor_data);
 
+  // Cancel the operation of the given type that is associated with the given
+  // key. The handler for the operation, if it is still pending, will be
+  // invoked with the operation_aborted error. Other operations associated
+  // with the descriptor are not affected.
+  NET_TS_DECL void cancel_ops_by_key(socket_type descriptor,
+      per_descriptor_data& descriptor_data, int op_type,
+      void* cancellation_key);
+
   // Cancel any operations that are running against the descriptor and remove
   // its registration from the reactor. The reactor resources associated with
   // the descriptor must be released by calling cleanup_descriptor_data.
@@ -189,6 +231,79 @@ private:
   // The hint to pass to epoll_create to size its data structures.
   enum { epoll_size = 20000 };
 
+  // The flag that requests exclusive wakeups, or 0 if it is not available.
+#if defined(EPOLLEXCLUSIVE)
+  enum { epoll_exclusive = EPOLLEXCLUSIVE };
+#else // defined(EPOLLEXCLUSIVE)
+  enum { epoll_exclusive = 0 };
+#endif // defined(EPOLLEXCLUSIVE)
+
+  // The deadlines of operations waiting on descriptors that have an operation
+  // timeout. Each descriptor appears at most once, keyed by the earliest
+  // deadline recorded for it. An entry may be earlier than any deadline
+  // still pending, in which case it is simply rescheduled when it fires.
+  // Entries hold raw descriptor_state pointers and are removed when the state
+  // is freed. An entry that is added while the state is being freed may
+  // outlive it. That is harmless, because the pool never releases the
+  // memory of a state before the reactor is destroyed, and a deadline only
+  // times out operations whose own deadlines have passed.
+  class deadline_queue
+    : public timer_queue_base
+  {
+  public:
+    // Get the current time of the monotonic clock, in microseconds.
+    NET_TS_DECL static uint64_t now();
+
+    // Record a deadline for an operation on the descriptor. Returns true if
+    // it is now the earliest deadline in the queue.
+    NET_TS_DECL bool enqueue(descriptor_state* descriptor, uint64_t deadline);
+
+    // Remove the descriptor's entry, if it has one.
+    NET_TS_DECL void dequeue(descriptor_state* descriptor);
+
+    // Whether there are no deadlines in the queue.
+    NET_TS_DECL virtual bool empty() const;
+
+    // Get the time to wait until the next deadline.
+    NET_TS_DECL virtual long wait_duration_msec(long max_duration) const;
+
+    // Get the time to wait until the next deadline.
+    NET_TS_DECL virtual long wait_duration_usec(long max_duration) const;
+
+    // Dequeue all operations whose deadlines have passed, completing them with
+    // the timed_out error.
+    NET_TS_DECL virtual void get_ready_timers(op_queue<operation>& ops);
+
+    // Discard all deadlines. The operations are owned by the descriptors.
+    NET_TS_DECL virtual void get_all_timers(op_queue<operation>& ops);
+
+  private:
+    // Remove the entry at the given position in the heap.
+    NET_TS_DECL void remove(std::size_t index);
+
+    // Move the entry at the given position up the heap.
+    NET_TS_DECL void up_heap(std::size_t index);
+
+    // Move the entry at the given position down the heap.
+    NET_TS_DECL void down_heap(std::size_t index);
+
+    // Swap two entries in the heap.
+    NET_TS_DECL void swap_heap(std::size_t index1, std::size_t index2);
+
+    struct heap_entry
+    {
+      // The time at which the descriptor must be checked for timed out
+      // operations.
+      uint64_t deadline_;
+
+      // The descriptor with waiting operations.
+      descriptor_state* descriptor_;
+    };
+
+    // The heap of deadlines, with the earliest deadline at the front.
+    std::vector<heap_entry> heap_;
+  };
+
   // Create the epoll file descriptor. Throws an exception if the descriptor
   // cannot be created.
   NET_TS_DECL static int do_epoll_create();
@@ -208,9 +323,17 @@ private:
   // Helper function to remove a timer queue.
   NET_TS_DECL void do_remove_timer_queue(timer_queue_base& queue);
 
-  // Called to recalculate and update the timeout.
+  // Called to recalculate and update the timeout. The timer descriptor is
+  // re-armed only if the timeout moves earlier, and only once the reactor is
+  // about to wait, unless it is waiting already.
   NET_TS_DECL void update_timeout();
 
+#if defined(NET_TS_HAS_TIMERFD)
+  // Arm the timer descriptor with the current timeout. Must be called with
+  // the mutex held.
+  NET_TS_DECL void arm_timer_fd();
+#endif // defined(NET_TS_HAS_TIMERFD)
+
   // Get the timeout value for the epoll_wait call. The timeout value is
   // returned as a number of milliseconds. A return value of -1 indicates
   // that epoll_wait should block indefinitely.
@@ -231,23 +354,45 @@ private:
   // The interrupter is used to break a blocking epoll_wait call.
   select_interrupter interrupter_;
 
+#if defined(NET_TS_HAS_STD_ATOMIC)
+  // Whether the interrupter has been signalled but epoll_wait has not yet
+  // reported it. Further interrupts are redundant until it has.
+  std::atomic<bool> interrupt_pending_;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+
   // The epoll file descriptor.
   int epoll_fd_;
 
   // The timer file descriptor.
   int timer_fd_;
 
+  // The time, in microseconds of the monotonic clock, at which the timer
+  // descriptor is armed to expire, or the maximum value if it is disarmed.
+  // Protected by the mutex.
+  uint64_t timer_fd_expiry_;
+
+#if defined(NET_TS_HAS_STD_ATOMIC)
+  // Whether the timer descriptor must be re-armed before the reactor next
+  // waits.
+  std::atomic<bool> timer_fd_stale_;
+
+  // Whether the reactor is waiting, or about to wait, in epoll_wait.
+  std::atomic<bool> waiting_;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+
   // The timer queues.
   timer_queue_set timer_queues_;
 
+  // The deadlines of operations on descriptors with an operation timeout.
+  deadline_queue deadlines_;
+
   // Whether the service has been shut down.
   bool shutdown_;
 
-  // Mutex to protect access to the registered descriptors.
-  mutex registered_descriptors_mutex_;
-
-  // Keep track of all registered descriptors.
-  object_pool<descriptor_state> registered_descriptors_;
+  // Keep track of all registered descriptors. Allocation and deallocation do
+  // not need a lock. The memory of a freed state is reused but not released,
+  // which deadlines_ relies on.
+  slab_object_pool<descriptor_state> registered_descriptors_;
 
   // Helper class to do post-perform_io cleanup.
   struct perform_io_cleanup_on_block_exit;
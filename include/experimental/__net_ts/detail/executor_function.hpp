@@ -16,6 +16,7 @@
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
 #include <experimental/__net_ts/detail/config.hpp>
+#include <new>
 #include <experimental/__net_ts/detail/handler_alloc_helpers.hpp>
 
 #include <experimental/__net_ts/detail/push_options.hpp>
@@ -99,6 +100,48 @@ private:
   Alloc allocator_;
 };
 
+// A function object stored in space owned by a wrapper, rather than in memory
+// obtained from an allocator.
+template <typename Function>
+class inline_executor_function : public executor_function_base
+{
+public:
+  template <typename F>
+  explicit inline_executor_function(NET_TS_MOVE_ARG(F) f)
+    : executor_function_base(&inline_executor_function::do_complete),
+      function_(NET_TS_MOVE_CAST(F)(f))
+  {
+  }
+
+  // Move the function object into new space, destroying the original.
+  static executor_function_base* move(
+      executor_function_base* base, void* space) NET_TS_NOEXCEPT
+  {
+    inline_executor_function* o(static_cast<inline_executor_function*>(base));
+    inline_executor_function* p = new (space) inline_executor_function(
+        NET_TS_MOVE_CAST(Function)(o->function_));
+    o->~inline_executor_function();
+    return p;
+  }
+
+  static void do_complete(executor_function_base* base, bool call)
+  {
+    // Move the function out so that the space may be reused by the upcall.
+    inline_executor_function* o(static_cast<inline_executor_function*>(base));
+    Function function(NET_TS_MOVE_CAST(Function)(o->function_));
+    o->~inline_executor_function();
+
+    // Make the upcall if required.
+    if (call)
+    {
+      function();
+    }
+  }
+
+private:
+  Function function_;
+};
+
 } // namespace detail
 } // inline namespace v1
 } // namespace net
@@ -18,7 +18,8 @@
 #include <experimental/__net_ts/detail/config.hpp>
 
 #if !defined(NET_TS_HAS_THREADS) \
-  || defined(NET_TS_DISABLE_FENCED_BLOCK)
+  || defined(NET_TS_DISABLE_FENCED_BLOCK) \
+  || defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
 # include <experimental/__net_ts/detail/null_fenced_block.hpp>
 #elif defined(NET_TS_HAS_STD_ATOMIC)
 # include <experimental/__net_ts/detail/std_fenced_block.hpp>
@@ -51,7 +52,8 @@ inline namespace v1 {
 namespace detail {
 
 #if !defined(NET_TS_HAS_THREADS) \
-  || defined(NET_TS_DISABLE_FENCED_BLOCK)
+  || defined(NET_TS_DISABLE_FENCED_BLOCK) \
+  || defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
 typedef null_fenced_block fenced_block;
 #elif defined(NET_TS_HAS_STD_ATOMIC)
 typedef std_fenced_block fenced_block;
@@ -0,0 +1,187 @@
+//
+// detail/idle_tracker_state.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_IDLE_TRACKER_STATE_HPP
+#define NET_TS_DETAIL_IDLE_TRACKER_STATE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+
+#if defined(NET_TS_HAS_CHRONO)
+
+#include <cstddef>
+#include <vector>
+#include <experimental/__net_ts/io_context.hpp>
+#include <experimental/__net_ts/steady_timer.hpp>
+#include <experimental/__net_ts/detail/chrono.hpp>
+#include <experimental/__net_ts/detail/memory.hpp>
+#include <experimental/__net_ts/detail/mutex.hpp>
+#include <experimental/__net_ts/detail/noncopyable.hpp>
+#include <experimental/__net_ts/detail/op_queue.hpp>
+#include <experimental/__net_ts/detail/wait_op.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+class idle_tracker_state;
+
+// The intrusive part of an idle tracker entry. The entry is linked into one
+// of the tracker's buckets while its wait operation is outstanding. The state
+// is set, with the state's mutex held, when the entry is first waited on and
+// is never changed afterwards, so that the entry may be touched from other
+// threads.
+struct idle_tracker_hook
+{
+  idle_tracker_hook* next_;
+  idle_tracker_hook* prev_;
+  std::size_t bucket_;
+  wait_op* op_;
+  shared_ptr<idle_tracker_state> state_;
+};
+
+// The state of an idle tracker. Entries are kept in a wheel of buckets, each
+// holding the entries last touched during one tick of the wheel. Touching an
+// entry moves it to the current bucket. On each tick the wheel advances and
+// the entries in the bucket it reaches, which have not been touched for a
+// full revolution, are expired.
+//
+// The state is shared with the entries and with the handler for the wheel's
+// timer. The timer itself belongs to the tracker object, so that it is not
+// destroyed after the io_context.
+class idle_tracker_state
+  : private noncopyable
+{
+public:
+  typedef chrono::steady_clock clock_type;
+
+  // Constructor.
+  NET_TS_DECL idle_tracker_state(
+      std::experimental::net::v1::io_context& ioc, steady_timer& timer,
+      const clock_type::duration& timeout,
+      const clock_type::duration& resolution);
+
+  // Get the time after which an entry that has not been touched expires.
+  clock_type::duration timeout() const
+  {
+    return resolution_ * static_cast<clock_type::rep>(buckets_.size() - 1);
+  }
+
+  // Get the interval at which the wheel advances.
+  clock_type::duration resolution() const
+  {
+    return resolution_;
+  }
+
+  // Get the number of entries being tracked.
+  NET_TS_DECL std::size_t size() const;
+
+  // Start tracking an entry, binding it to the state if it is not yet bound.
+  // The operation completes when the entry expires or is cancelled, or at once
+  // if the entry is bound to another state.
+  NET_TS_DECL static void start(const shared_ptr<idle_tracker_state>& self,
+      idle_tracker_hook& h, wait_op* op);
+
+  // Record activity on an entry. Has no effect unless the entry is bound to
+  // this state.
+  NET_TS_DECL void touch(idle_tracker_hook& h);
+
+  // Stop tracking an entry. Returns the number of operations cancelled, which
+  // is zero unless the entry is bound to this state.
+  NET_TS_DECL std::size_t cancel(idle_tracker_hook& h);
+
+  // Stop tracking all entries and stop the timer. Called when the tracker is
+  // destroyed.
+  NET_TS_DECL void close();
+
+private:
+  // Handler for the wheel's timer.
+  class timer_handler
+  {
+  public:
+    explicit timer_handler(const shared_ptr<idle_tracker_state>& state)
+      : state_(state)
+    {
+    }
+
+    void operator()(const std::error_code&)
+    {
+      idle_tracker_state::tick(state_);
+    }
+
+  private:
+    shared_ptr<idle_tracker_state> state_;
+  };
+
+  // Advance the wheel and expire the entries in the bucket it reaches.
+  NET_TS_DECL static void tick(const shared_ptr<idle_tracker_state>& self);
+
+  // Get the number of buckets needed for a timeout, throwing if the timeout or
+  // resolution is not positive.
+  NET_TS_DECL static std::size_t bucket_count(
+      const clock_type::duration& timeout,
+      const clock_type::duration& resolution);
+
+  // Link an entry into the current bucket. The mutex must be held.
+  NET_TS_DECL void link(idle_tracker_hook& h);
+
+  // Unlink an entry from its bucket. The mutex must be held.
+  NET_TS_DECL void unlink(idle_tracker_hook& h);
+
+  // The io_context implementation used to post completions.
+  io_context_impl& io_context_impl_;
+
+  // Protects the timer, the wheel and the entries linked into it.
+  mutable std::experimental::net::v1::detail::mutex mutex_;
+
+  // The timer used to advance the wheel. Null once the tracker is closed.
+  steady_timer* timer_;
+
+  // Whether the timer is waiting.
+  bool timer_armed_;
+
+  // The time at which the wheel next advances.
+  clock_type::time_point next_tick_;
+
+  // The interval at which the wheel advances.
+  clock_type::duration resolution_;
+
+  // The heads of the lists of entries in each bucket.
+  std::vector<idle_tracker_hook*> buckets_;
+
+  // The bucket into which touched entries are placed.
+  std::size_t current_;
+
+  // The number of entries being tracked.
+  std::size_t count_;
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#if defined(NET_TS_HEADER_ONLY)
+# include <experimental/__net_ts/detail/impl/idle_tracker_state.ipp>
+#endif // defined(NET_TS_HEADER_ONLY)
+
+#endif // defined(NET_TS_HAS_CHRONO)
+
+#endif // NET_TS_DETAIL_IDLE_TRACKER_STATE_HPP
@@ -0,0 +1,102 @@
+//
+// detail/impl/async_event_impl.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_IMPL_ASYNC_EVENT_IMPL_IPP
+#define NET_TS_DETAIL_IMPL_ASYNC_EVENT_IMPL_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <experimental/__net_ts/detail/async_event_impl.hpp>
+#include <experimental/__net_ts/error.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+async_event_impl::async_event_impl(
+    std::experimental::net::v1::io_context& ioc, bool is_set)
+  : async_wait_queue(ioc),
+    is_set_(is_set)
+{
+}
+
+void async_event_impl::start_wait(wait_op* op)
+{
+  io_context_impl_.work_started();
+
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+  if (is_set_)
+  {
+    lock.unlock();
+    io_context_impl_.post_deferred_completion(op);
+    return;
+  }
+
+  waiters_.push(op);
+}
+
+void async_event_impl::set()
+{
+  op_queue<operation> ops;
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+  is_set_ = true;
+  ops.push(waiters_);
+  lock.unlock();
+
+  io_context_impl_.post_deferred_completions(ops);
+}
+
+void async_event_impl::reset()
+{
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+  is_set_ = false;
+}
+
+bool async_event_impl::is_set() const
+{
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+  return is_set_;
+}
+
+std::size_t async_event_impl::notify(std::size_t n)
+{
+  op_queue<operation> ops;
+  std::size_t woken = 0;
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+  for (; woken < n; ++woken)
+  {
+    wait_op* op = waiters_.front();
+    if (!op)
+      break;
+    waiters_.pop();
+    ops.push(op);
+  }
+  lock.unlock();
+
+  io_context_impl_.post_deferred_completions(ops);
+  return woken;
+}
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_DETAIL_IMPL_ASYNC_EVENT_IMPL_IPP
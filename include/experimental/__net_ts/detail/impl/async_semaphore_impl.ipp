@@ -0,0 +1,118 @@
+//
+// detail/impl/async_semaphore_impl.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_IMPL_ASYNC_SEMAPHORE_IMPL_IPP
+#define NET_TS_DETAIL_IMPL_ASYNC_SEMAPHORE_IMPL_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <experimental/__net_ts/detail/async_semaphore_impl.hpp>
+#include <experimental/__net_ts/error.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+async_semaphore_impl::async_semaphore_impl(
+    std::experimental::net::v1::io_context& ioc, std::size_t count)
+  : async_wait_queue(ioc),
+    count_(count)
+{
+}
+
+void async_semaphore_impl::start_acquire(wait_op* op)
+{
+  io_context_impl_.work_started();
+
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+  if (count_ > 0)
+  {
+    --count_;
+    lock.unlock();
+    io_context_impl_.post_deferred_completion(op);
+    return;
+  }
+
+  waiters_.push(op);
+}
+
+bool async_semaphore_impl::try_acquire()
+{
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+  if (count_ > 0)
+  {
+    --count_;
+    return true;
+  }
+  return false;
+}
+
+void async_semaphore_impl::release(std::size_t n)
+{
+  op_queue<operation> ops;
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+  for (; n > 0; --n)
+  {
+    if (wait_op* op = waiters_.front())
+    {
+      waiters_.pop();
+      ops.push(op);
+    }
+    else
+    {
+      count_ += n;
+      break;
+    }
+  }
+  lock.unlock();
+
+  io_context_impl_.post_deferred_completions(ops);
+}
+
+bool async_semaphore_impl::release_one(std::size_t limit)
+{
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+  if (wait_op* op = waiters_.front())
+  {
+    waiters_.pop();
+    lock.unlock();
+    io_context_impl_.post_deferred_completion(op);
+    return true;
+  }
+
+  if (count_ >= limit)
+    return false;
+
+  ++count_;
+  return true;
+}
+
+std::size_t async_semaphore_impl::count() const
+{
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+  return count_;
+}
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_DETAIL_IMPL_ASYNC_SEMAPHORE_IMPL_IPP
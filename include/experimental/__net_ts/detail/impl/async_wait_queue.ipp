@@ -0,0 +1,139 @@
+//
+// detail/impl/async_wait_queue.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_IMPL_ASYNC_WAIT_QUEUE_IPP
+#define NET_TS_DETAIL_IMPL_ASYNC_WAIT_QUEUE_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <experimental/__net_ts/detail/async_wait_queue.hpp>
+#include <experimental/__net_ts/error.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+async_wait_queue_base::async_wait_queue_base(
+    std::experimental::net::v1::io_context& ioc,
+    shutdown_func_type shutdown_func)
+  : io_context_impl_(use_service<io_context_impl>(ioc)),
+    service_(use_service<async_wait_queue_service>(ioc)),
+    shutdown_func_(shutdown_func),
+    next_(0),
+    prev_(0)
+{
+  service_.register_queue(*this);
+}
+
+async_wait_queue_base::~async_wait_queue_base()
+{
+  service_.deregister_queue(*this);
+}
+
+async_wait_queue::async_wait_queue(
+    std::experimental::net::v1::io_context& ioc)
+  : async_wait_queue_base(ioc, &async_wait_queue::do_shutdown)
+{
+}
+
+async_wait_queue::~async_wait_queue()
+{
+  cancel();
+}
+
+std::size_t async_wait_queue::cancel()
+{
+  op_queue<operation> ops;
+  std::size_t n = 0;
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+  while (wait_op* op = waiters_.front())
+  {
+    waiters_.pop();
+    op->ec_ = std::experimental::net::v1::error::operation_aborted;
+    ops.push(op);
+    ++n;
+  }
+  lock.unlock();
+
+  io_context_impl_.post_deferred_completions(ops);
+  return n;
+}
+
+void async_wait_queue::do_shutdown(
+    async_wait_queue_base* base, op_queue<operation>& ops)
+{
+  async_wait_queue* q = static_cast<async_wait_queue*>(base);
+  ops.push(q->waiters_);
+}
+
+async_wait_queue_service::async_wait_queue_service(execution_context& ctx)
+  : execution_context_service_base<async_wait_queue_service>(ctx),
+    mutex_(),
+    queues_(0)
+{
+}
+
+void async_wait_queue_service::shutdown()
+{
+  op_queue<operation> ops;
+
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+
+  async_wait_queue_base* q = queues_;
+  while (q)
+  {
+    q->mutex_.lock();
+    q->shutdown_func_(q, ops);
+    q->mutex_.unlock();
+    q = q->next_;
+  }
+}
+
+void async_wait_queue_service::register_queue(async_wait_queue_base& q)
+{
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+
+  q.next_ = queues_;
+  q.prev_ = 0;
+  if (queues_)
+    queues_->prev_ = &q;
+  queues_ = &q;
+}
+
+void async_wait_queue_service::deregister_queue(async_wait_queue_base& q)
+{
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+
+  if (queues_ == &q)
+    queues_ = q.next_;
+  if (q.prev_)
+    q.prev_->next_ = q.next_;
+  if (q.next_)
+    q.next_->prev_ = q.prev_;
+  q.next_ = 0;
+  q.prev_ = 0;
+}
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_DETAIL_IMPL_ASYNC_WAIT_QUEUE_IPP
@@ -152,7 +152,7 @@ void dev_poll_reactor::move_descriptor(socket_type,
 
 void dev_poll_reactor::start_op(int op_type, socket_type descriptor,
     dev_poll_reactor::per_descriptor_data&, reactor_op* op,
-    bool is_continuation, bool allow_speculative)
+    bool is_continuation, bool allow_speculative, bool allow_inline)
 {
   std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
 
@@ -171,7 +171,7 @@ void dev_poll_reactor::start_op(int op_type, socket_type descriptor,
         if (op->perform())
         {
           lock.unlock();
-          scheduler_.post_immediate_completion(op, is_continuation);
+          scheduler_.complete_immediately(op, is_continuation, allow_inline);
           return;
         }
       }
@@ -204,6 +204,19 @@ void dev_poll_reactor::cancel_ops(socket_type descriptor,
   cancel_ops_unlocked(descriptor, std::experimental::net::v1::error::operation_aborted);
 }
 
+void dev_poll_reactor::cancel_ops_by_key(socket_type descriptor,
+    dev_poll_reactor::per_descriptor_data&, int op_type, void* cancellation_key)
+{
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+  op_queue<operation> ops;
+  bool need_interrupt = op_queue_[op_type].cancel_operations_by_key(
+      descriptor, ops, cancellation_key,
+      std::experimental::net::v1::error::operation_aborted);
+  scheduler_.post_deferred_completions(ops);
+  if (need_interrupt)
+    interrupter_.interrupt();
+}
+
 void dev_poll_reactor::deregister_descriptor(socket_type descriptor,
     dev_poll_reactor::per_descriptor_data&, bool)
 {
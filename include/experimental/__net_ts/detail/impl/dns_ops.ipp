@@ -0,0 +1,302 @@
+//
+// detail/impl/dns_ops.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_IMPL_DNS_OPS_IPP
+#define NET_TS_DETAIL_IMPL_DNS_OPS_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <experimental/__net_ts/detail/dns_ops.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+namespace dns_ops {
+
+void read_resolv_conf(const char* path, config& cfg)
+{
+  cfg.name_servers_.clear();
+  cfg.timeout_ = 5;
+  cfg.attempts_ = 2;
+
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line))
+  {
+    std::istringstream is(line);
+    std::string keyword;
+    if (!(is >> keyword) || keyword[0] == '#' || keyword[0] == ';')
+      continue;
+
+    if (keyword == "nameserver")
+    {
+      std::string value;
+      std::error_code ec;
+      if (is >> value)
+      {
+        std::experimental::net::v1::ip::address addr =
+          std::experimental::net::v1::ip::make_address(value.c_str(), ec);
+        if (!ec)
+          cfg.name_servers_.push_back(addr);
+      }
+    }
+    else if (keyword == "options")
+    {
+      std::string value;
+      while (is >> value)
+      {
+        if (value.compare(0, 8, "timeout:") == 0)
+        {
+          int n = std::atoi(value.c_str() + 8);
+          if (n > 0)
+            cfg.timeout_ = n;
+        }
+        else if (value.compare(0, 9, "attempts:") == 0)
+        {
+          int n = std::atoi(value.c_str() + 9);
+          if (n > 0)
+            cfg.attempts_ = n;
+        }
+      }
+    }
+  }
+
+  // Use the local name server if none are configured.
+  if (cfg.name_servers_.empty())
+  {
+    cfg.name_servers_.push_back(
+        std::experimental::net::v1::ip::address_v4::loopback());
+  }
+}
+
+void read_hosts(const char* path, hosts& h)
+{
+  h.clear();
+
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line))
+  {
+    std::string::size_type comment = line.find('#');
+    if (comment != std::string::npos)
+      line.erase(comment);
+
+    std::istringstream is(line);
+    std::string value;
+    if (!(is >> value))
+      continue;
+
+    std::error_code ec;
+    std::experimental::net::v1::ip::address addr =
+      std::experimental::net::v1::ip::make_address(value.c_str(), ec);
+    if (ec)
+      continue;
+
+    std::string name;
+    while (is >> name)
+      h.insert(hosts::value_type(normalise_name(name), addr));
+  }
+}
+
+std::string normalise_name(const std::string& name)
+{
+  std::string result(name);
+  if (!result.empty() && result[result.size() - 1] == '.')
+    result.erase(result.size() - 1);
+  for (std::string::size_type i = 0; i < result.size(); ++i)
+    result[i] = static_cast<char>(
+        std::tolower(static_cast<unsigned char>(result[i])));
+  return result;
+}
+
+bool encode_query(const std::string& name, unsigned short id,
+    unsigned short qtype, std::vector<unsigned char>& message)
+{
+  message.clear();
+
+  // Header: ID, flags with recursion desired, one question.
+  const unsigned char header[12] = {
+    static_cast<unsigned char>(id >> 8), static_cast<unsigned char>(id),
+    0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+  message.insert(message.end(), header, header + sizeof(header));
+
+  // Question name as a sequence of length-prefixed labels.
+  std::string::size_type start = 0;
+  while (start < name.size())
+  {
+    std::string::size_type end = name.find('.', start);
+    if (end == std::string::npos)
+      end = name.size();
+    std::string::size_type label_length = end - start;
+    if (label_length == 0 || label_length > 63)
+      return false;
+    message.push_back(static_cast<unsigned char>(label_length));
+    message.insert(message.end(), name.begin() + start, name.begin() + end);
+    start = end + 1;
+  }
+  message.push_back(0);
+  if (message.size() - sizeof(header) > 255 || name.empty())
+    return false;
+
+  // Question type and class.
+  message.push_back(static_cast<unsigned char>(qtype >> 8));
+  message.push_back(static_cast<unsigned char>(qtype));
+  message.push_back(0);
+  message.push_back(class_in);
+
+  return true;
+}
+
+// Read a 16-bit value in network byte order.
+inline unsigned short read_u16(const unsigned char* p)
+{
+  return static_cast<unsigned short>((p[0] << 8) | p[1]);
+}
+
+// Skip over an encoded, possibly compressed, name.
+inline bool skip_name(const unsigned char* data,
+    std::size_t length, std::size_t& pos)
+{
+  while (pos < length)
+  {
+    unsigned char label_length = data[pos];
+    if ((label_length & 0xC0) == 0xC0)
+    {
+      pos += 2;
+      return pos <= length;
+    }
+    if (label_length & 0xC0)
+      return false;
+    pos += 1 + label_length;
+    if (label_length == 0)
+      return true;
+  }
+  return false;
+}
+
+// Compare two encoded, uncompressed names, ignoring the case of letters. A
+// length byte never falls in the range of the letters, so a name only matches
+// another with the same labels.
+inline bool names_equal(const unsigned char* a,
+    const unsigned char* b, std::size_t length)
+{
+  for (std::size_t i = 0; i < length; ++i)
+  {
+    unsigned char x = a[i], y = b[i];
+    if (x >= 'A' && x <= 'Z')
+      x = static_cast<unsigned char>(x - 'A' + 'a');
+    if (y >= 'A' && y <= 'Z')
+      y = static_cast<unsigned char>(y - 'A' + 'a');
+    if (x != y)
+      return false;
+  }
+  return true;
+}
+
+response_status decode_response(const unsigned char* data,
+    std::size_t length, const std::vector<unsigned char>& query,
+    std::vector<std::experimental::net::v1::ip::address>& addresses)
+{
+  if (length < 12 || query.size() < 12 + 5
+      || read_u16(data) != read_u16(&query[0]))
+    return response_unrelated;
+
+  // Must be a standard query response containing our single question.
+  unsigned short flags = read_u16(data + 2);
+  if ((flags & 0x8000) == 0 || (flags & 0x7800) != 0
+      || read_u16(data + 4) != 1)
+    return response_unrelated;
+
+  // The question must repeat the query's name, type and class. The name is
+  // the first in the message, so it cannot be compressed.
+  std::size_t question_length = query.size() - 12;
+  if (length < 12 + question_length
+      || !names_equal(data + 12, &query[12], question_length - 4)
+      || std::memcmp(data + 8 + question_length,
+        &query[8 + question_length], 4) != 0)
+    return response_unrelated;
+  std::size_t pos = 12 + question_length;
+  unsigned short qtype = read_u16(&query[8 + question_length]);
+
+  if (flags & 0x0200)
+    return response_truncated;
+
+  switch (flags & 0x000F)
+  {
+  case 0:
+    break;
+  case 3:
+    return response_name_error;
+  default:
+    return response_server_failure;
+  }
+
+  // Extract the addresses from the answer section. Any other records, such as
+  // CNAMEs that lead to the addresses, are skipped.
+  unsigned short answers = read_u16(data + 6);
+  for (unsigned short i = 0; i < answers; ++i)
+  {
+    if (!skip_name(data, length, pos) || pos + 10 > length)
+      return response_server_failure;
+
+    unsigned short type = read_u16(data + pos);
+    unsigned short rclass = read_u16(data + pos + 2);
+    std::size_t rdlength = read_u16(data + pos + 8);
+    pos += 10;
+    if (pos + rdlength > length)
+      return response_server_failure;
+
+    if (type == qtype && rclass == class_in)
+    {
+      if (type == type_a && rdlength == 4)
+      {
+        std::experimental::net::v1::ip::address_v4::bytes_type bytes;
+        std::copy(data + pos, data + pos + 4, bytes.begin());
+        addresses.push_back(
+            std::experimental::net::v1::ip::address_v4(bytes));
+      }
+      else if (type == type_aaaa && rdlength == 16)
+      {
+        std::experimental::net::v1::ip::address_v6::bytes_type bytes;
+        std::copy(data + pos, data + pos + 16, bytes.begin());
+        addresses.push_back(
+            std::experimental::net::v1::ip::address_v6(bytes));
+      }
+    }
+
+    pos += rdlength;
+  }
+
+  return response_success;
+}
+
+} // namespace dns_ops
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_DETAIL_IMPL_DNS_OPS_IPP
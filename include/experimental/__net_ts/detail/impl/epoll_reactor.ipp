@@ -20,6 +20,7 @@
 #if defined(NET_TS_HAS_EPOLL)
 
 #include <cstddef>
+#include <ctime>
 #include <sys/epoll.h>
 #include <experimental/__net_ts/detail/epoll_reactor.hpp>
 #include <experimental/__net_ts/detail/throw_error.hpp>
@@ -43,10 +44,17 @@ epoll_reactor::epoll_reactor(std::experimental::net::v1::execution_context& ctx)
     mutex_(NET_TS_CONCURRENCY_HINT_IS_LOCKING(
           REACTOR_REGISTRATION, scheduler_.concurrency_hint())),
     interrupter_(),
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    interrupt_pending_(false),
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
     epoll_fd_(do_epoll_create()),
     timer_fd_(do_timerfd_create()),
-    shutdown_(false),
-    registered_descriptors_mutex_(mutex_.enabled())
+    timer_fd_expiry_((std::numeric_limits<uint64_t>::max)()),
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    timer_fd_stale_(false),
+    waiting_(false),
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+    shutdown_(false)
 {
   // Add the interrupter's descriptor to epoll.
   epoll_event ev = { 0, { 0 } };
@@ -62,6 +70,9 @@ epoll_reactor::epoll_reactor(std::experimental::net::v1::execution_context& ctx)
     ev.data.ptr = &timer_fd_;
     epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, timer_fd_, &ev);
   }
+
+  // Operation deadlines are waited for in the same way as timers.
+  timer_queues_.insert(&deadlines_);
 }
 
 epoll_reactor::~epoll_reactor()
@@ -80,7 +91,8 @@ void epoll_reactor::shutdown()
 
   op_queue<operation> ops;
 
-  while (descriptor_state* state = registered_descriptors_.first())
+  for (descriptor_state* state = registered_descriptors_.first();
+      state != 0; state = registered_descriptors_.next(state))
   {
     for (int i = 0; i < max_ops; ++i)
       ops.push(state->op_queue_[i]);
@@ -125,12 +137,13 @@ void epoll_reactor::notify_fork(
       epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, timer_fd_, &ev);
     }
 
+    // The new timer descriptor is not armed.
+    timer_fd_expiry_ = (std::numeric_limits<uint64_t>::max)();
     update_timeout();
 
     // Re-register all descriptors with epoll.
-    mutex::scoped_lock descriptors_lock(registered_descriptors_mutex_);
     for (descriptor_state* state = registered_descriptors_.first();
-        state != 0; state = state->next_)
+        state != 0; state = registered_descriptors_.next(state))
     {
       ev.events = state->registered_events_;
       ev.data.ptr = state;
@@ -165,6 +178,8 @@ int epoll_reactor::register_descriptor(socket_type descriptor,
     descriptor_data->reactor_ = this;
     descriptor_data->descriptor_ = descriptor;
     descriptor_data->shutdown_ = false;
+    descriptor_data->op_timeout_ = 0;
+    descriptor_data->has_deadline_ = false;
     for (int i = 0; i < max_ops; ++i)
       descriptor_data->try_speculative_[i] = true;
   }
@@ -207,6 +222,8 @@ int epoll_reactor::register_internal_descriptor(
     descriptor_data->reactor_ = this;
     descriptor_data->descriptor_ = descriptor;
     descriptor_data->shutdown_ = false;
+    descriptor_data->op_timeout_ = 0;
+    descriptor_data->has_deadline_ = false;
     descriptor_data->op_queue_[op_type].push(op);
     for (int i = 0; i < max_ops; ++i)
       descriptor_data->try_speculative_[i] = true;
@@ -223,6 +240,70 @@ int epoll_reactor::register_internal_descriptor(
   return 0;
 }
 
+int epoll_reactor::set_exclusive_wakeup(socket_type descriptor,
+    epoll_reactor::per_descriptor_data& descriptor_data, bool enable)
+{
+  if (!descriptor_data)
+    return EBADF;
+
+  if (epoll_exclusive == 0)
+    return EOPNOTSUPP;
+
+  mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+
+  uint32_t events = descriptor_data->registered_events_;
+  if (events == 0)
+    return EOPNOTSUPP;
+  if (((events & epoll_exclusive) != 0) == enable)
+    return 0;
+
+  // Exclusive registrations cannot be modified, and cannot include EPOLLPRI,
+  // so the descriptor is removed and added again. Adding the descriptor makes
+  // the kernel check its readiness, so no edge is lost in between.
+  if (enable)
+    events = (events & ~static_cast<uint32_t>(EPOLLPRI)) | epoll_exclusive;
+  else
+    events = (events & ~static_cast<uint32_t>(epoll_exclusive)) | EPOLLPRI;
+
+  epoll_event ev = { 0, { 0 } };
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, descriptor, &ev);
+  ev.events = events;
+  ev.data.ptr = descriptor_data;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, descriptor, &ev) != 0)
+  {
+    int err = errno;
+    ev.events = descriptor_data->registered_events_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, descriptor, &ev);
+    return err;
+  }
+
+  descriptor_data->registered_events_ = events;
+  return 0;
+}
+
+int epoll_reactor::set_op_timeout(
+    epoll_reactor::per_descriptor_data& descriptor_data, uint64_t usec)
+{
+  if (!descriptor_data)
+    return EBADF;
+
+  mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+
+  // Operations that are already waiting keep the deadlines they were given.
+  descriptor_data->op_timeout_ = usec;
+  return 0;
+}
+
+uint64_t epoll_reactor::op_timeout(
+    const epoll_reactor::per_descriptor_data& descriptor_data)
+{
+  if (!descriptor_data)
+    return 0;
+
+  mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+  return descriptor_data->op_timeout_;
+}
+
 void epoll_reactor::move_descriptor(socket_type,
     epoll_reactor::per_descriptor_data& target_descriptor_data,
     epoll_reactor::per_descriptor_data& source_descriptor_data)
@@ -233,7 +314,7 @@ void epoll_reactor::move_descriptor(socket_type,
 
 void epoll_reactor::start_op(int op_type, socket_type descriptor,
     epoll_reactor::per_descriptor_data& descriptor_data, reactor_op* op,
-    bool is_continuation, bool allow_speculative)
+    bool is_continuation, bool allow_speculative, bool allow_inline)
 {
   if (!descriptor_data)
   {
@@ -264,7 +345,7 @@ void epoll_reactor::start_op(int op_type, socket_type descriptor,
             if (descriptor_data->registered_events_ != 0)
               descriptor_data->try_speculative_[op_type] = false;
           descriptor_lock.unlock();
-          scheduler_.post_immediate_completion(op, is_continuation);
+          scheduler_.complete_immediately(op, is_continuation, allow_inline);
           return;
         }
       }
@@ -278,6 +359,14 @@ void epoll_reactor::start_op(int op_type, socket_type descriptor,
 
       if (op_type == write_op)
       {
+        if ((descriptor_data->registered_events_ & epoll_exclusive) != 0
+            && (descriptor_data->registered_events_ & EPOLLOUT) == 0)
+        {
+          op->ec_ = std::experimental::net::v1::error::operation_not_supported;
+          scheduler_.post_immediate_completion(op, is_continuation);
+          return;
+        }
+
         if ((descriptor_data->registered_events_ & EPOLLOUT) == 0)
         {
           epoll_event ev = { 0, { 0 } };
@@ -303,6 +392,24 @@ void epoll_reactor::start_op(int op_type, socket_type descriptor,
       scheduler_.post_immediate_completion(op, is_continuation);
       return;
     }
+    else if ((descriptor_data->registered_events_ & epoll_exclusive) != 0)
+    {
+      if (op_type == write_op
+          && (descriptor_data->registered_events_ & EPOLLOUT) == 0)
+      {
+        op->ec_ = std::experimental::net::v1::error::operation_not_supported;
+        scheduler_.post_immediate_completion(op, is_continuation);
+        return;
+      }
+
+      // Exclusive registrations cannot be modified, so the descriptor is added
+      // again to make the kernel check its readiness.
+      epoll_event ev = { 0, { 0 } };
+      epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, descriptor, &ev);
+      ev.events = descriptor_data->registered_events_;
+      ev.data.ptr = descriptor_data;
+      epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, descriptor, &ev);
+    }
     else
     {
       if (op_type == write_op)
@@ -317,8 +424,30 @@ void epoll_reactor::start_op(int op_type, socket_type descriptor,
     }
   }
 
+  uint64_t deadline = 0;
+  if (descriptor_data->op_timeout_)
+  {
+    deadline = deadline_queue::now() + descriptor_data->op_timeout_;
+    op->deadline_ = deadline;
+  }
+
   descriptor_data->op_queue_[op_type].push(op);
   scheduler_.work_started();
+
+  if (deadline)
+  {
+    descriptor_data->has_deadline_ = true;
+
+    // Expired deadlines are processed with the reactor mutex held, so the
+    // descriptor lock must be released before the mutex is acquired. If the
+    // operation completes in between, the deadline is found to have nothing
+    // to time out when it expires.
+    descriptor_lock.unlock();
+
+    mutex::scoped_lock lock(mutex_);
+    if (!shutdown_ && deadlines_.enqueue(descriptor_data, deadline))
+      update_timeout();
+  }
 }
 
 void epoll_reactor::cancel_ops(socket_type,
@@ -345,6 +474,35 @@ void epoll_reactor::cancel_ops(socket_type,
   scheduler_.post_deferred_completions(ops);
 }
 
+void epoll_reactor::cancel_ops_by_key(socket_type,
+    epoll_reactor::per_descriptor_data& descriptor_data,
+    int op_type, void* cancellation_key)
+{
+  if (!descriptor_data)
+    return;
+
+  mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+
+  op_queue<operation> ops;
+  op_queue<reactor_op> other_ops;
+  while (reactor_op* op = descriptor_data->op_queue_[op_type].front())
+  {
+    descriptor_data->op_queue_[op_type].pop();
+    if (op->cancellation_key_ == cancellation_key)
+    {
+      op->ec_ = std::experimental::net::v1::error::operation_aborted;
+      ops.push(op);
+    }
+    else
+      other_ops.push(op);
+  }
+  descriptor_data->op_queue_[op_type].push(other_ops);
+
+  descriptor_lock.unlock();
+
+  scheduler_.post_deferred_completions(ops);
+}
+
 void epoll_reactor::deregister_descriptor(socket_type descriptor,
     epoll_reactor::per_descriptor_data& descriptor_data, bool closing)
 {
@@ -355,13 +513,17 @@ void epoll_reactor::deregister_descriptor(socket_type descriptor,
 
   if (!descriptor_data->shutdown_)
   {
-    if (closing)
+    if (closing
+        && (descriptor_data->registered_events_ & epoll_exclusive) == 0)
     {
       // The descriptor will be automatically removed from the epoll set when
       // it is closed.
     }
     else if (descriptor_data->registered_events_ != 0)
     {
+      // An exclusive registration is normally for a duplicated listening
+      // socket, which stays in the epoll set after this descriptor is closed
+      // and would go on consuming wakeups meant for other io_contexts.
       epoll_event ev = { 0, { 0 } };
       epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, descriptor, &ev);
     }
@@ -468,10 +630,29 @@ void epoll_reactor::run(long usec, op_queue<operation>& ops)
     }
   }
 
+#if defined(NET_TS_HAS_TIMERFD) && defined(NET_TS_HAS_STD_ATOMIC)
+  // Apply any deferred change to the timeout. Threads that change it after
+  // waiting_ is set re-arm the timer descriptor themselves.
+  if (timer_fd_ != -1)
+  {
+    waiting_.store(true, std::memory_order_seq_cst);
+    if (timer_fd_stale_.load(std::memory_order_seq_cst))
+    {
+      mutex::scoped_lock lock(mutex_);
+      if (timer_fd_stale_.load(std::memory_order_relaxed))
+        arm_timer_fd();
+    }
+  }
+#endif // defined(NET_TS_HAS_TIMERFD) && defined(NET_TS_HAS_STD_ATOMIC)
+
   // Block on the epoll descriptor.
   epoll_event events[128];
   int num_events = epoll_wait(epoll_fd_, events, 128, timeout);
 
+#if defined(NET_TS_HAS_TIMERFD) && defined(NET_TS_HAS_STD_ATOMIC)
+  waiting_.store(false, std::memory_order_relaxed);
+#endif // defined(NET_TS_HAS_TIMERFD) && defined(NET_TS_HAS_STD_ATOMIC)
+
 #if defined(NET_TS_ENABLE_HANDLER_TRACKING)
   // Trace the waiting events.
   for (int i = 0; i < num_events; ++i)
@@ -519,6 +700,13 @@ void epoll_reactor::run(long usec, op_queue<operation>& ops)
       // to make it so that we only get woken up when the descriptor's epoll
       // registration is updated.
 
+#if defined(NET_TS_HAS_STD_ATOMIC)
+      // An interrupt that arrived since epoll_wait returned was coalesced
+      // with this one. That is safe, as the caller only needs this call to
+      // return before the reactor is next run.
+      interrupt_pending_.store(false, std::memory_order_release);
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+
 #if defined(NET_TS_HAS_TIMERFD)
       if (timer_fd_ == -1)
         check_timers = true;
@@ -558,10 +746,15 @@ void epoll_reactor::run(long usec, op_queue<operation>& ops)
 #if defined(NET_TS_HAS_TIMERFD)
     if (timer_fd_ != -1)
     {
-      itimerspec new_timeout;
-      itimerspec old_timeout;
-      int flags = get_timeout(new_timeout);
-      timerfd_settime(timer_fd_, flags, &new_timeout, &old_timeout);
+# if defined(NET_TS_HAS_STD_ATOMIC)
+      // The timer descriptor has expired and remains readable until it is
+      // re-armed, which is deferred until the reactor next waits so that
+      // timers scheduled by the handlers in between are included.
+      timer_fd_expiry_ = (std::numeric_limits<uint64_t>::max)();
+      timer_fd_stale_.store(true, std::memory_order_relaxed);
+# else // defined(NET_TS_HAS_STD_ATOMIC)
+      arm_timer_fd();
+# endif // defined(NET_TS_HAS_STD_ATOMIC)
     }
 #endif // defined(NET_TS_HAS_TIMERFD)
   }
@@ -569,6 +762,11 @@ void epoll_reactor::run(long usec, op_queue<operation>& ops)
 
 void epoll_reactor::interrupt()
 {
+#if defined(NET_TS_HAS_STD_ATOMIC)
+  if (interrupt_pending_.exchange(true, std::memory_order_acq_rel))
+    return;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+
   epoll_event ev = { 0, { 0 } };
   ev.events = EPOLLIN | EPOLLERR | EPOLLET;
   ev.data.ptr = &interrupter_;
@@ -626,14 +824,18 @@ int epoll_reactor::do_timerfd_create()
 
 epoll_reactor::descriptor_state* epoll_reactor::allocate_descriptor_state()
 {
-  mutex::scoped_lock descriptors_lock(registered_descriptors_mutex_);
   return registered_descriptors_.alloc(NET_TS_CONCURRENCY_HINT_IS_LOCKING(
         REACTOR_IO, scheduler_.concurrency_hint()));
 }
 
 void epoll_reactor::free_descriptor_state(epoll_reactor::descriptor_state* s)
 {
-  mutex::scoped_lock descriptors_lock(registered_descriptors_mutex_);
+  if (s->has_deadline_)
+  {
+    mutex::scoped_lock lock(mutex_);
+    deadlines_.dequeue(s);
+  }
+
   registered_descriptors_.free(s);
 }
 
@@ -654,16 +856,44 @@ void epoll_reactor::update_timeout()
 #if defined(NET_TS_HAS_TIMERFD)
   if (timer_fd_ != -1)
   {
-    itimerspec new_timeout;
-    itimerspec old_timeout;
-    int flags = get_timeout(new_timeout);
-    timerfd_settime(timer_fd_, flags, &new_timeout, &old_timeout);
+    // If the timer descriptor is armed to expire no later than the new
+    // timeout, it is re-armed with the correct timeout when it expires.
+    long usec = timer_queues_.wait_duration_usec(5 * 60 * 1000 * 1000);
+    if (deadline_queue::now() + usec >= timer_fd_expiry_)
+      return;
+
+# if defined(NET_TS_HAS_STD_ATOMIC)
+    // Leave the re-arming to the reactor, unless it is already waiting.
+    timer_fd_stale_.store(true, std::memory_order_seq_cst);
+    if (!waiting_.load(std::memory_order_seq_cst))
+      return;
+# endif // defined(NET_TS_HAS_STD_ATOMIC)
+
+    arm_timer_fd();
     return;
   }
 #endif // defined(NET_TS_HAS_TIMERFD)
   interrupt();
 }
 
+#if defined(NET_TS_HAS_TIMERFD)
+void epoll_reactor::arm_timer_fd()
+{
+  itimerspec new_timeout;
+  itimerspec old_timeout;
+  int flags = get_timeout(new_timeout);
+  timerfd_settime(timer_fd_, flags, &new_timeout, &old_timeout);
+
+  uint64_t now = deadline_queue::now();
+  timer_fd_expiry_ = flags ? now : now
+    + static_cast<uint64_t>(new_timeout.it_value.tv_sec) * 1000000
+    + new_timeout.it_value.tv_nsec / 1000;
+#if defined(NET_TS_HAS_STD_ATOMIC)
+  timer_fd_stale_.store(false, std::memory_order_relaxed);
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+}
+#endif // defined(NET_TS_HAS_TIMERFD)
+
 int epoll_reactor::get_timeout(int msec)
 {
   // By default we will wait no longer than 5 minutes. This will ensure that
@@ -687,6 +917,156 @@ int epoll_reactor::get_timeout(itimerspec& ts)
 }
 #endif // defined(NET_TS_HAS_TIMERFD)
 
+uint64_t epoll_reactor::deadline_queue::now()
+{
+  timespec ts;
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+bool epoll_reactor::deadline_queue::enqueue(
+    descriptor_state* descriptor, uint64_t deadline)
+{
+  std::size_t index = descriptor->deadline_index_;
+  if (index < heap_.size())
+  {
+    // The descriptor will already be checked no later than this deadline.
+    if (heap_[index].deadline_ <= deadline)
+      return false;
+    heap_[index].deadline_ = deadline;
+  }
+  else
+  {
+    index = heap_.size();
+    descriptor->deadline_index_ = index;
+    heap_entry entry = { deadline, descriptor };
+    heap_.push_back(entry);
+  }
+
+  up_heap(index);
+  return heap_[0].descriptor_ == descriptor;
+}
+
+void epoll_reactor::deadline_queue::dequeue(descriptor_state* descriptor)
+{
+  if (descriptor->deadline_index_ < heap_.size()
+      && heap_[descriptor->deadline_index_].descriptor_ == descriptor)
+    remove(descriptor->deadline_index_);
+}
+
+bool epoll_reactor::deadline_queue::empty() const
+{
+  return heap_.empty();
+}
+
+long epoll_reactor::deadline_queue::wait_duration_msec(long max_duration) const
+{
+  if (heap_.empty())
+    return max_duration;
+
+  uint64_t current = now();
+  if (heap_[0].deadline_ <= current)
+    return 0;
+  uint64_t msec = (heap_[0].deadline_ - current + 999) / 1000;
+  return msec < static_cast<uint64_t>(max_duration)
+    ? static_cast<long>(msec) : max_duration;
+}
+
+long epoll_reactor::deadline_queue::wait_duration_usec(long max_duration) const
+{
+  if (heap_.empty())
+    return max_duration;
+
+  uint64_t current = now();
+  if (heap_[0].deadline_ <= current)
+    return 0;
+  uint64_t usec = heap_[0].deadline_ - current;
+  return usec < static_cast<uint64_t>(max_duration)
+    ? static_cast<long>(usec) : max_duration;
+}
+
+void epoll_reactor::deadline_queue::get_ready_timers(op_queue<operation>& ops)
+{
+  if (heap_.empty())
+    return;
+
+  uint64_t current = now();
+  while (!heap_.empty() && heap_[0].deadline_ <= current)
+  {
+    descriptor_state* descriptor = heap_[0].descriptor_;
+    remove(0);
+
+    // Operations that have not yet reached their deadlines are checked again
+    // at the earliest of them.
+    if (uint64_t next = descriptor->time_out_ops(current, ops))
+      enqueue(descriptor, next);
+  }
+}
+
+void epoll_reactor::deadline_queue::get_all_timers(op_queue<operation>&)
+{
+  for (std::size_t i = 0; i < heap_.size(); ++i)
+    heap_[i].descriptor_->deadline_index_
+      = (std::numeric_limits<std::size_t>::max)();
+  heap_.clear();
+}
+
+void epoll_reactor::deadline_queue::remove(std::size_t index)
+{
+  std::size_t last = heap_.size() - 1;
+  if (index != last)
+    swap_heap(index, last);
+  heap_[last].descriptor_->deadline_index_
+    = (std::numeric_limits<std::size_t>::max)();
+  heap_.pop_back();
+  if (index < heap_.size())
+  {
+    if (index > 0
+        && heap_[index].deadline_ < heap_[(index - 1) / 2].deadline_)
+      up_heap(index);
+    else
+      down_heap(index);
+  }
+}
+
+void epoll_reactor::deadline_queue::up_heap(std::size_t index)
+{
+  while (index > 0)
+  {
+    std::size_t parent = (index - 1) / 2;
+    if (!(heap_[index].deadline_ < heap_[parent].deadline_))
+      break;
+    swap_heap(index, parent);
+    index = parent;
+  }
+}
+
+void epoll_reactor::deadline_queue::down_heap(std::size_t index)
+{
+  std::size_t child = index * 2 + 1;
+  while (child < heap_.size())
+  {
+    std::size_t min_child = (child + 1 == heap_.size()
+        || heap_[child].deadline_ < heap_[child + 1].deadline_)
+      ? child : child + 1;
+    if (heap_[index].deadline_ < heap_[min_child].deadline_)
+      break;
+    swap_heap(index, min_child);
+    index = min_child;
+    child = index * 2 + 1;
+  }
+}
+
+void epoll_reactor::deadline_queue::swap_heap(
+    std::size_t index1, std::size_t index2)
+{
+  heap_entry tmp = heap_[index1];
+  heap_[index1] = heap_[index2];
+  heap_[index2] = tmp;
+  heap_[index1].descriptor_->deadline_index_ = index1;
+  heap_[index2].descriptor_->deadline_index_ = index2;
+}
+
 struct epoll_reactor::perform_io_cleanup_on_block_exit
 {
   explicit perform_io_cleanup_on_block_exit(epoll_reactor* r)
@@ -722,7 +1102,10 @@ struct epoll_reactor::perform_io_cleanup_on_block_exit
 
 epoll_reactor::descriptor_state::descriptor_state(bool locking)
   : operation(&epoll_reactor::descriptor_state::do_complete),
-    mutex_(locking)
+    mutex_(locking),
+    op_timeout_(0),
+    has_deadline_(false),
+    deadline_index_((std::numeric_limits<std::size_t>::max)())
 {
 }
 
@@ -765,6 +1148,38 @@ operation* epoll_reactor::descriptor_state::perform_io(uint32_t events)
   return io_cleanup.first_op_;
 }
 
+uint64_t epoll_reactor::descriptor_state::time_out_ops(
+    uint64_t now, op_queue<operation>& ops)
+{
+  mutex::scoped_lock descriptor_lock(mutex_);
+
+  // Operations that have timed out are removed from the queues, preserving
+  // the order of those that remain.
+  uint64_t earliest = 0;
+  for (int j = 0; j < max_ops; ++j)
+  {
+    op_queue<reactor_op> remaining;
+    while (reactor_op* op = op_queue_[j].front())
+    {
+      op_queue_[j].pop();
+      if (op->deadline_ != 0 && op->deadline_ <= now)
+      {
+        op->ec_ = std::experimental::net::v1::error::timed_out;
+        ops.push(op);
+      }
+      else
+      {
+        if (op->deadline_ != 0 && (earliest == 0 || op->deadline_ < earliest))
+          earliest = op->deadline_;
+        remaining.push(op);
+      }
+    }
+    op_queue_[j].push(remaining);
+  }
+
+  return earliest;
+}
+
 void epoll_reactor::descriptor_state::do_complete(
     void* owner, operation* base,
     const std::error_code& ec, std::size_t bytes_transferred)
@@ -0,0 +1,229 @@
+//
+// detail/impl/idle_tracker_state.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_IMPL_IDLE_TRACKER_STATE_IPP
+#define NET_TS_DETAIL_IMPL_IDLE_TRACKER_STATE_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+
+#if defined(NET_TS_HAS_CHRONO)
+
+#include <experimental/__net_ts/detail/idle_tracker_state.hpp>
+#include <experimental/__net_ts/detail/throw_error.hpp>
+#include <experimental/__net_ts/error.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+idle_tracker_state::idle_tracker_state(
+    std::experimental::net::v1::io_context& ioc, steady_timer& timer,
+    const clock_type::duration& timeout,
+    const clock_type::duration& resolution)
+  : io_context_impl_(use_service<io_context_impl>(ioc)),
+    timer_(&timer),
+    timer_armed_(false),
+    resolution_(resolution),
+    buckets_(bucket_count(timeout, resolution)),
+    current_(0),
+    count_(0)
+{
+}
+
+std::size_t idle_tracker_state::size() const
+{
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+  return count_;
+}
+
+void idle_tracker_state::start(const shared_ptr<idle_tracker_state>& self,
+    idle_tracker_hook& h, wait_op* op)
+{
+  self->io_context_impl_.work_started();
+
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(self->mutex_);
+
+  if (!self->timer_)
+  {
+    lock.unlock();
+    op->ec_ = std::experimental::net::v1::error::operation_aborted;
+    self->io_context_impl_.post_deferred_completion(op);
+    return;
+  }
+
+  if (!h.state_)
+    h.state_ = self;
+  else if (h.state_ != self)
+  {
+    lock.unlock();
+    op->ec_ = std::experimental::net::v1::error::invalid_argument;
+    self->io_context_impl_.post_deferred_completion(op);
+    return;
+  }
+
+  h.op_ = op;
+  self->link(h);
+  ++self->count_;
+
+  if (!self->timer_armed_)
+  {
+    self->timer_armed_ = true;
+    self->next_tick_ = clock_type::now() + self->resolution_;
+    self->timer_->expires_at(self->next_tick_);
+    self->timer_->async_wait(timer_handler(self));
+  }
+}
+
+void idle_tracker_state::touch(idle_tracker_hook& h)
+{
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+  if (h.state_.get() == this && h.op_ && h.bucket_ != current_)
+  {
+    unlink(h);
+    link(h);
+  }
+}
+
+std::size_t idle_tracker_state::cancel(idle_tracker_hook& h)
+{
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+  if (h.state_.get() != this)
+    return 0;
+  wait_op* op = h.op_;
+  if (!op)
+    return 0;
+
+  unlink(h);
+  h.op_ = 0;
+  --count_;
+  lock.unlock();
+
+  op->ec_ = std::experimental::net::v1::error::operation_aborted;
+  io_context_impl_.post_deferred_completion(op);
+  return 1;
+}
+
+void idle_tracker_state::close()
+{
+  op_queue<operation> ops;
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+
+  for (std::size_t i = 0; i < buckets_.size(); ++i)
+  {
+    while (idle_tracker_hook* h = buckets_[i])
+    {
+      unlink(*h);
+      h->op_->ec_ = std::experimental::net::v1::error::operation_aborted;
+      ops.push(h->op_);
+      h->op_ = 0;
+    }
+  }
+  count_ = 0;
+
+  if (timer_)
+  {
+    timer_->cancel();
+    timer_ = 0;
+  }
+  lock.unlock();
+
+  io_context_impl_.post_deferred_completions(ops);
+}
+
+void idle_tracker_state::tick(const shared_ptr<idle_tracker_state>& self)
+{
+  op_queue<operation> ops;
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(self->mutex_);
+
+  self->timer_armed_ = false;
+  if (!self->timer_)
+    return;
+
+  // Entries in the bucket being reused were last touched a full revolution
+  // ago.
+  self->current_ = (self->current_ + 1) % self->buckets_.size();
+  while (idle_tracker_hook* h = self->buckets_[self->current_])
+  {
+    self->unlink(*h);
+    ops.push(h->op_);
+    h->op_ = 0;
+    --self->count_;
+  }
+
+  // The timer is left idle while there is nothing to track.
+  if (self->count_ > 0)
+  {
+    self->timer_armed_ = true;
+    self->next_tick_ += self->resolution_;
+    self->timer_->expires_at(self->next_tick_);
+    self->timer_->async_wait(timer_handler(self));
+  }
+  lock.unlock();
+
+  self->io_context_impl_.post_deferred_completions(ops);
+}
+
+std::size_t idle_tracker_state::bucket_count(
+    const clock_type::duration& timeout,
+    const clock_type::duration& resolution)
+{
+  if (timeout <= clock_type::duration::zero()
+      || resolution <= clock_type::duration::zero())
+  {
+    std::error_code ec = std::experimental::net::v1::error::invalid_argument;
+    std::experimental::net::v1::detail::throw_error(ec, "idle_tracker");
+  }
+
+  // One more bucket than the timeout spans, as entries in the current bucket
+  // may have been touched at any time during the current tick.
+  return static_cast<std::size_t>(
+      (timeout + resolution - clock_type::duration(1)) / resolution) + 1;
+}
+
+void idle_tracker_state::link(idle_tracker_hook& h)
+{
+  h.bucket_ = current_;
+  h.prev_ = 0;
+  h.next_ = buckets_[current_];
+  if (h.next_)
+    h.next_->prev_ = &h;
+  buckets_[current_] = &h;
+}
+
+void idle_tracker_state::unlink(idle_tracker_hook& h)
+{
+  if (h.prev_)
+    h.prev_->next_ = h.next_;
+  else
+    buckets_[h.bucket_] = h.next_;
+  if (h.next_)
+    h.next_->prev_ = h.prev_;
+  h.next_ = h.prev_ = 0;
+}
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // defined(NET_TS_HAS_CHRONO)
+
+#endif // NET_TS_DETAIL_IMPL_IDLE_TRACKER_STATE_IPP
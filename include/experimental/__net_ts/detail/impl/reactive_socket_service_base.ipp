@@ -153,6 +153,61 @@ socket_type reactive_socket_service_base::release(
   return sock;
 }
 
+std::error_code reactive_socket_service_base::migrate(
+    reactive_socket_service_base::base_implementation_type& impl,
+    reactive_socket_service_base& target_service,
+    reactive_socket_service_base::base_implementation_type& target_impl,
+    std::error_code& ec)
+{
+  if (!is_open(impl))
+  {
+    ec = std::experimental::net::v1::error::bad_descriptor;
+    return ec;
+  }
+
+  if (target_service.is_open(target_impl))
+  {
+    ec = std::experimental::net::v1::error::already_open;
+    return ec;
+  }
+
+  NET_TS_HANDLER_OPERATION((reactor_.context(),
+        "socket", &impl, impl.socket_, "migrate"));
+
+#if defined(NET_TS_HAS_EPOLL)
+  uint64_t op_timeout = reactor_.op_timeout(impl.reactor_data_);
+#endif // defined(NET_TS_HAS_EPOLL)
+
+  reactor_.deregister_descriptor(impl.socket_, impl.reactor_data_, false);
+  reactor_.cleanup_descriptor_data(impl.reactor_data_);
+
+  if (int err = target_service.reactor_.register_descriptor(
+        impl.socket_, target_impl.reactor_data_))
+  {
+    ec = std::error_code(err,
+        std::experimental::net::v1::error::get_system_category());
+
+    // Leave the socket usable with its original io_context.
+    reactor_.register_descriptor(impl.socket_, impl.reactor_data_);
+#if defined(NET_TS_HAS_EPOLL)
+    reactor_.set_op_timeout(impl.reactor_data_, op_timeout);
+#endif // defined(NET_TS_HAS_EPOLL)
+    return ec;
+  }
+
+#if defined(NET_TS_HAS_EPOLL)
+  target_service.reactor_.set_op_timeout(
+      target_impl.reactor_data_, op_timeout);
+#endif // defined(NET_TS_HAS_EPOLL)
+
+  // The descriptor keeps its flags, such as whether it is non-blocking.
+  target_impl.socket_ = impl.socket_;
+  target_impl.state_ = impl.state_;
+  construct(impl);
+  ec = std::error_code();
+  return ec;
+}
+
 std::error_code reactive_socket_service_base::cancel(
     reactive_socket_service_base::base_implementation_type& impl,
     std::error_code& ec)
@@ -171,6 +226,74 @@ std::error_code reactive_socket_service_base::cancel(
   return ec;
 }
 
+std::error_code reactive_socket_service_base::set_exclusive_wakeup(
+    reactive_socket_service_base::base_implementation_type& impl,
+    bool enable, std::error_code& ec)
+{
+  if (!is_open(impl))
+  {
+    ec = std::experimental::net::v1::error::bad_descriptor;
+    return ec;
+  }
+
+#if defined(NET_TS_HAS_EPOLL)
+  if (int err = reactor_.set_exclusive_wakeup(
+        impl.socket_, impl.reactor_data_, enable))
+  {
+    ec = std::error_code(err,
+        std::experimental::net::v1::error::get_system_category());
+    return ec;
+  }
+
+  // The socket is shared with other io_contexts through duplicates, so
+  // closing it does not remove its registration.
+  if (enable)
+    impl.state_ |= socket_ops::possible_dup;
+  ec = std::error_code();
+#else // defined(NET_TS_HAS_EPOLL)
+  (void)enable;
+  ec = std::experimental::net::v1::error::operation_not_supported;
+#endif // defined(NET_TS_HAS_EPOLL)
+  return ec;
+}
+
+std::error_code reactive_socket_service_base::set_operation_timeout(
+    reactive_socket_service_base::base_implementation_type& impl,
+    uint64_t usec, std::error_code& ec)
+{
+  if (!is_open(impl))
+  {
+    ec = std::experimental::net::v1::error::bad_descriptor;
+    return ec;
+  }
+
+#if defined(NET_TS_HAS_EPOLL)
+  if (int err = reactor_.set_op_timeout(impl.reactor_data_, usec))
+  {
+    ec = std::error_code(err,
+        std::experimental::net::v1::error::get_system_category());
+    return ec;
+  }
+
+  ec = std::error_code();
+#else // defined(NET_TS_HAS_EPOLL)
+  (void)usec;
+  ec = std::experimental::net::v1::error::operation_not_supported;
+#endif // defined(NET_TS_HAS_EPOLL)
+  return ec;
+}
+
+uint64_t reactive_socket_service_base::operation_timeout(
+    const reactive_socket_service_base::base_implementation_type& impl) const
+{
+#if defined(NET_TS_HAS_EPOLL)
+  return reactor_.op_timeout(impl.reactor_data_);
+#else // defined(NET_TS_HAS_EPOLL)
+  (void)impl;
+  return 0;
+#endif // defined(NET_TS_HAS_EPOLL)
+}
+
 std::error_code reactive_socket_service_base::do_open(
     reactive_socket_service_base::base_implementation_type& impl,
     int af, int type, int protocol, std::error_code& ec)
@@ -246,7 +369,8 @@ void reactive_socket_service_base::start_op(
           impl.socket_, impl.state_, true, op->ec_))
     {
       reactor_.start_op(op_type, impl.socket_,
-          impl.reactor_data_, op, is_continuation, is_non_blocking);
+          impl.reactor_data_, op, is_continuation, is_non_blocking,
+          (impl.state_ & socket_ops::inline_completion) != 0);
       return;
     }
   }
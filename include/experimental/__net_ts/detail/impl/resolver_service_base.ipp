@@ -17,6 +17,7 @@
 
 #include <experimental/__net_ts/detail/config.hpp>
 #include <experimental/__net_ts/detail/resolver_service_base.hpp>
+#include <experimental/__net_ts/ip/detail/resolver_option.hpp>
 
 #include <experimental/__net_ts/detail/push_options.hpp>
 
@@ -43,7 +44,8 @@ resolver_service_base::resolver_service_base(
     work_io_context_impl_(std::experimental::net::v1::use_service<
         io_context_impl>(*work_io_context_)),
     work_(std::experimental::net::v1::make_work_guard(*work_io_context_)),
-    work_thread_(0)
+    num_work_threads_(0),
+    thread_pool_size_(1)
 {
 }
 
@@ -58,11 +60,8 @@ void resolver_service_base::base_shutdown()
   if (work_io_context_.get())
   {
     work_io_context_->stop();
-    if (work_thread_.get())
-    {
-      work_thread_->join();
-      work_thread_.reset();
-    }
+    work_threads_.join();
+    num_work_threads_ = 0;
     work_io_context_.reset();
   }
 }
@@ -70,18 +69,18 @@ void resolver_service_base::base_shutdown()
 void resolver_service_base::base_notify_fork(
     std::experimental::net::v1::io_context::fork_event fork_ev)
 {
-  if (work_thread_.get())
+  if (num_work_threads_ > 0)
   {
     if (fork_ev == std::experimental::net::v1::io_context::fork_prepare)
     {
       work_io_context_->stop();
-      work_thread_->join();
+      work_threads_.join();
     }
     else
     {
       work_io_context_->restart();
-      work_thread_.reset(new std::experimental::net::v1::detail::thread(
-            work_io_context_runner(*work_io_context_)));
+      work_threads_.create_threads(
+          work_io_context_runner(*work_io_context_), num_work_threads_);
     }
   }
 }
@@ -123,12 +122,43 @@ void resolver_service_base::cancel(
   impl.reset(static_cast<void*>(0), socket_ops::noop_deleter());
 }
 
+std::error_code resolver_service_base::set_option(
+    int name, int value, std::error_code& ec)
+{
+  namespace opt = std::experimental::net::v1::ip::detail::resolver_option;
+  if (name != opt::thread_pool_size_name || value < 1)
+  {
+    ec = std::experimental::net::v1::error::invalid_argument;
+    return ec;
+  }
+
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+  thread_pool_size_ = static_cast<std::size_t>(value);
+  ec = std::error_code();
+  return ec;
+}
+
+std::error_code resolver_service_base::get_option(
+    int name, int& value, std::error_code& ec) const
+{
+  namespace opt = std::experimental::net::v1::ip::detail::resolver_option;
+  if (name != opt::thread_pool_size_name)
+  {
+    ec = std::experimental::net::v1::error::invalid_argument;
+    return ec;
+  }
+
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+  value = static_cast<int>(thread_pool_size_);
+  ec = std::error_code();
+  return ec;
+}
+
 void resolver_service_base::start_resolve_op(resolve_op* op)
 {
-  if (NET_TS_CONCURRENCY_HINT_IS_LOCKING(SCHEDULER,
-        io_context_impl_.concurrency_hint()))
+  if (can_resolve_in_background())
   {
-    start_work_thread();
+    start_work_threads();
     io_context_impl_.work_started();
     work_io_context_impl_.post_immediate_completion(op, false);
   }
@@ -139,13 +169,13 @@ void resolver_service_base::start_resolve_op(resolve_op* op)
   }
 }
 
-void resolver_service_base::start_work_thread()
+void resolver_service_base::start_work_threads()
 {
   std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
-  if (!work_thread_.get())
+  while (num_work_threads_ < thread_pool_size_)
   {
-    work_thread_.reset(new std::experimental::net::v1::detail::thread(
-          work_io_context_runner(*work_io_context_)));
+    work_threads_.create_thread(work_io_context_runner(*work_io_context_));
+    ++num_work_threads_;
   }
 }
 
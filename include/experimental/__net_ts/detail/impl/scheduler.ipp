@@ -17,12 +17,15 @@
 
 #include <experimental/__net_ts/detail/config.hpp>
 
+#include <experimental/__net_ts/detail/chrono.hpp>
 #include <experimental/__net_ts/detail/concurrency_hint.hpp>
+#include <experimental/__net_ts/detail/cpu_relax.hpp>
 #include <experimental/__net_ts/detail/event.hpp>
 #include <experimental/__net_ts/detail/limits.hpp>
 #include <experimental/__net_ts/detail/reactor.hpp>
 #include <experimental/__net_ts/detail/scheduler.hpp>
 #include <experimental/__net_ts/detail/scheduler_thread_info.hpp>
+#include <experimental/__net_ts/detail/thread.hpp>
 
 #include <experimental/__net_ts/detail/push_options.hpp>
 
@@ -44,10 +47,21 @@ struct scheduler::task_cleanup
     }
     this_thread_->private_outstanding_work = 0;
 
+#if defined(NET_TS_HAS_CHRONO)
+    // The task may have blocked, so the cached time is out of date.
+    scheduler_->time_cache_.invalidate();
+#endif // defined(NET_TS_HAS_CHRONO)
+
+    if (injection_wait_)
+      scheduler_->end_injection_wait();
+
     // Enqueue the completed operations and reinsert the task at the end of
     // the operation queue.
     lock_->lock();
     scheduler_->task_interrupted_ = true;
+    scheduler_->task_spinning_ = false;
+    if (!this_thread_->private_op_queue.empty())
+      scheduler_->notify_spinning_threads();
     scheduler_->op_queue_.push(this_thread_->private_op_queue);
     scheduler_->op_queue_.push(&scheduler_->task_operation_);
   }
@@ -55,6 +69,7 @@ struct scheduler::task_cleanup
   scheduler* scheduler_;
   mutex::scoped_lock* lock_;
   thread_info* this_thread_;
+  bool injection_wait_;
 };
 
 struct scheduler::work_cleanup
@@ -77,6 +92,7 @@ struct scheduler::work_cleanup
     if (!this_thread_->private_op_queue.empty())
     {
       lock_->lock();
+      scheduler_->notify_spinning_threads();
       scheduler_->op_queue_.push(this_thread_->private_op_queue);
     }
 #endif // defined(NET_TS_HAS_THREADS)
@@ -87,6 +103,16 @@ struct scheduler::work_cleanup
   thread_info* this_thread_;
 };
 
+struct scheduler::inline_completion_cleanup
+{
+  ~inline_completion_cleanup()
+  {
+    --this_thread_->inline_completion_depth;
+  }
+
+  thread_info* this_thread_;
+};
+
 scheduler::scheduler(
     std::experimental::net::v1::execution_context& ctx, int concurrency_hint)
   : std::experimental::net::v1::detail::execution_context_service_base<scheduler>(ctx),
@@ -99,18 +125,37 @@ scheduler::scheduler(
           SCHEDULER, concurrency_hint)),
     task_(0),
     task_interrupted_(true),
+    wakeup_pending_(false),
     outstanding_work_(0),
     stopped_(false),
     shutdown_(false),
-    concurrency_hint_(concurrency_hint)
+    concurrency_hint_(concurrency_hint),
+    spin_budget_usec_(0),
+    spin_usec_(0),
+    task_spinning_(false),
+    spinning_threads_(0),
+    spin_wakeups_(0),
+    inline_completion_(false),
+    inline_completion_depth_(default_inline_completion_depth),
+#if defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+    running_thread_(0),
+#endif // defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+    injection_rings_(0),
+    injection_waiters_(0)
 {
   NET_TS_HANDLER_TRACKING_INIT;
+
+  spin_statistics_.spins = 0;
+  spin_statistics_.spin_hits = 0;
+  spin_statistics_.parks = 0;
 }
 
 void scheduler::shutdown()
 {
   mutex::scoped_lock lock(mutex_);
   shutdown_ = true;
+  for (injection_ring* r = injection_rings_; r; r = r->next_)
+    r->pop_all(op_queue_);
   lock.unlock();
 
   // Destroy handler objects.
@@ -148,7 +193,9 @@ std::size_t scheduler::run(std::error_code& ec)
 
   thread_info this_thread;
   this_thread.private_outstanding_work = 0;
+  this_thread.inline_completion_depth = 0;
   thread_call_stack::context ctx(this, this_thread);
+  running_context running(this, this_thread);
 
   mutex::scoped_lock lock(mutex_);
 
@@ -170,7 +217,9 @@ std::size_t scheduler::run_one(std::error_code& ec)
 
   thread_info this_thread;
   this_thread.private_outstanding_work = 0;
+  this_thread.inline_completion_depth = 0;
   thread_call_stack::context ctx(this, this_thread);
+  running_context running(this, this_thread);
 
   mutex::scoped_lock lock(mutex_);
 
@@ -188,7 +237,9 @@ std::size_t scheduler::wait_one(long usec, std::error_code& ec)
 
   thread_info this_thread;
   this_thread.private_outstanding_work = 0;
+  this_thread.inline_completion_depth = 0;
   thread_call_stack::context ctx(this, this_thread);
+  running_context running(this, this_thread);
 
   mutex::scoped_lock lock(mutex_);
 
@@ -206,7 +257,9 @@ std::size_t scheduler::poll(std::error_code& ec)
 
   thread_info this_thread;
   this_thread.private_outstanding_work = 0;
+  this_thread.inline_completion_depth = 0;
   thread_call_stack::context ctx(this, this_thread);
+  running_context running(this, this_thread);
 
   mutex::scoped_lock lock(mutex_);
 
@@ -237,7 +290,9 @@ std::size_t scheduler::poll_one(std::error_code& ec)
 
   thread_info this_thread;
   this_thread.private_outstanding_work = 0;
+  this_thread.inline_completion_depth = 0;
   thread_call_stack::context ctx(this, this_thread);
+  running_context running(this, this_thread);
 
   mutex::scoped_lock lock(mutex_);
 
@@ -271,9 +326,32 @@ void scheduler::restart()
   stopped_ = false;
 }
 
+void scheduler::set_spin_budget(long usec)
+{
+  // Spinning on a single processor only delays the thread that is to provide
+  // the work.
+  bool can_spin = thread::hardware_concurrency() != 1;
+
+  mutex::scoped_lock lock(mutex_);
+  spin_budget_usec_ = usec > 0 ? usec : 0;
+  spin_usec_ = can_spin ? spin_budget_usec_ : 0;
+}
+
+long scheduler::spin_budget() const
+{
+  mutex::scoped_lock lock(mutex_);
+  return spin_budget_usec_;
+}
+
+spin_statistics scheduler::get_spin_statistics() const
+{
+  mutex::scoped_lock lock(mutex_);
+  return spin_statistics_;
+}
+
 void scheduler::compensating_work_started()
 {
-  thread_info_base* this_thread = thread_call_stack::contains(this);
+  thread_info_base* this_thread = running_thread_info();
   ++static_cast<thread_info*>(this_thread)->private_outstanding_work;
 }
 
@@ -283,7 +361,7 @@ void scheduler::post_immediate_completion(
 #if defined(NET_TS_HAS_THREADS)
   if (one_thread_ || is_continuation)
   {
-    if (thread_info_base* this_thread = thread_call_stack::contains(this))
+    if (thread_info_base* this_thread = running_thread_info())
     {
       ++static_cast<thread_info*>(this_thread)->private_outstanding_work;
       static_cast<thread_info*>(this_thread)->private_op_queue.push(op);
@@ -300,12 +378,69 @@ void scheduler::post_immediate_completion(
   wake_one_thread_and_unlock(lock);
 }
 
+void scheduler::complete_immediately(
+    scheduler::operation* op, bool is_continuation, bool allow_inline)
+{
+  if (allow_inline || inline_completion_)
+  {
+    if (thread_info_base* this_thread = running_thread_info())
+    {
+      thread_info* t = static_cast<thread_info*>(this_thread);
+      if (t->inline_completion_depth < inline_completion_depth_)
+      {
+        ++t->inline_completion_depth;
+        inline_completion_cleanup on_exit = { t };
+        (void)on_exit;
+
+        std::error_code ec;
+        op->complete(this, ec, op->task_result_);
+        return;
+      }
+    }
+  }
+
+  post_immediate_completion(op, is_continuation);
+}
+
+void scheduler::set_inline_completion(bool enable)
+{
+  inline_completion_ = enable;
+}
+
+bool scheduler::inline_completion() const
+{
+  return inline_completion_;
+}
+
+void scheduler::set_inline_completion_depth(std::size_t depth)
+{
+  inline_completion_depth_ = depth;
+}
+
+std::size_t scheduler::inline_completion_depth() const
+{
+  return inline_completion_depth_;
+}
+
+void scheduler::post_immediate_completions(
+    op_queue<scheduler::operation>& ops, std::size_t n)
+{
+  if (!ops.empty())
+  {
+    std::experimental::net::v1::detail::increment(
+        outstanding_work_, static_cast<long>(n));
+    mutex::scoped_lock lock(mutex_);
+    op_queue_.push(ops);
+    wake_one_thread_and_unlock(lock);
+  }
+}
+
 void scheduler::post_deferred_completion(scheduler::operation* op)
 {
 #if defined(NET_TS_HAS_THREADS)
   if (one_thread_)
   {
-    if (thread_info_base* this_thread = thread_call_stack::contains(this))
+    if (thread_info_base* this_thread = running_thread_info())
     {
       static_cast<thread_info*>(this_thread)->private_op_queue.push(op);
       return;
@@ -326,7 +461,7 @@ void scheduler::post_deferred_completions(
 #if defined(NET_TS_HAS_THREADS)
     if (one_thread_)
     {
-      if (thread_info_base* this_thread = thread_call_stack::contains(this))
+      if (thread_info_base* this_thread = running_thread_info())
       {
         static_cast<thread_info*>(this_thread)->private_op_queue.push(ops);
         return;
@@ -340,6 +475,64 @@ void scheduler::post_deferred_completions(
   }
 }
 
+void scheduler::register_injection_ring(injection_ring& r)
+{
+  work_started();
+  mutex::scoped_lock lock(mutex_);
+  r.next_ = injection_rings_;
+  injection_rings_ = &r;
+}
+
+void scheduler::deregister_injection_ring(injection_ring& r)
+{
+  mutex::scoped_lock lock(mutex_);
+  injection_ring** p = &injection_rings_;
+  while (*p && *p != &r)
+    p = &(*p)->next_;
+  if (*p)
+    *p = r.next_;
+  r.next_ = 0;
+
+  // After shutdown the ring's destructor destroys what is left in it.
+  std::size_t n = shutdown_ ? 0 : r.pop_all(op_queue_);
+  if (n > 0)
+  {
+    std::experimental::net::v1::detail::increment(
+        outstanding_work_, static_cast<long>(n));
+    wake_one_thread_and_unlock(lock);
+  }
+  else
+    lock.unlock();
+
+  work_finished();
+}
+
+void scheduler::post_injected_completion(
+    injection_ring& r, scheduler::operation* op)
+{
+  if (!r.push(op))
+  {
+    // The ring is full. Move its contents to the queue ahead of the new
+    // operation so that the operations are still run in order.
+    mutex::scoped_lock lock(mutex_);
+    std::size_t n = r.pop_all(op_queue_) + 1;
+    std::experimental::net::v1::detail::increment(
+        outstanding_work_, static_cast<long>(n));
+    op_queue_.push(op);
+    wake_one_thread_and_unlock(lock);
+    return;
+  }
+
+  // A thread announces that it is about to wait before it makes its final
+  // check of the rings. Either that check finds the operation, or we see the
+  // announcement here and wake the thread.
+  if (injection_waiters_ > 0)
+  {
+    mutex::scoped_lock lock(mutex_);
+    wake_one_thread_and_unlock(lock);
+  }
+}
+
 void scheduler::do_dispatch(
     scheduler::operation* op)
 {
@@ -362,6 +555,14 @@ std::size_t scheduler::do_run_one(mutex::scoped_lock& lock,
 {
   while (!stopped_)
   {
+#if defined(NET_TS_HAS_CHRONO)
+    // Time has passed since the last handler ran or this thread last waited.
+    time_cache_.invalidate();
+#endif // defined(NET_TS_HAS_CHRONO)
+
+    if (injection_rings_)
+      drain_injection_rings();
+
     if (!op_queue_.empty())
     {
       // Prepare to execute first handler from queue.
@@ -371,20 +572,46 @@ std::size_t scheduler::do_run_one(mutex::scoped_lock& lock,
 
       if (o == &task_operation_)
       {
+        bool injection_wait = false;
+        if (!more_handlers)
+        {
+          injection_wait = begin_injection_wait();
+          more_handlers = !injection_wait;
+        }
+
         task_interrupted_ = more_handlers;
 
+        // A spinning task watches for new work itself, so there is no need
+        // for other threads to interrupt it.
+        long spin_usec = more_handlers ? 0 : spin_usec_;
+        long spin_wakeups = spin_wakeups_;
+        if (spin_usec > 0)
+        {
+          task_interrupted_ = true;
+          task_spinning_ = true;
+          ++spin_statistics_.spins;
+        }
+        else if (!more_handlers && spin_budget_usec_ > 0)
+          ++spin_statistics_.parks;
+
         if (more_handlers && !one_thread_)
+        {
+          notify_spinning_threads();
           wakeup_event_.unlock_and_signal_one(lock);
+        }
         else
           lock.unlock();
 
-        task_cleanup on_exit = { this, &lock, &this_thread };
+        task_cleanup on_exit = { this, &lock, &this_thread, injection_wait };
         (void)on_exit;
 
         // Run the task. May throw an exception. Only block if the operation
         // queue is empty and we're not polling, otherwise we want to return
         // as soon as possible.
-        task_->run(more_handlers ? 0 : -1, this_thread.private_op_queue);
+        if (spin_usec > 0)
+          spin_task(lock, this_thread, spin_usec, spin_wakeups);
+        else
+          task_->run(more_handlers ? 0 : -1, this_thread.private_op_queue);
       }
       else
       {
@@ -407,8 +634,24 @@ std::size_t scheduler::do_run_one(mutex::scoped_lock& lock,
     }
     else
     {
+      if (!begin_injection_wait())
+        continue;
+
+      if (spin_usec_ > 0 && spin_for_work(lock))
+      {
+        end_injection_wait();
+        continue;
+      }
+
+      // Clearing the event consumes any signal that has not yet been acted
+      // on, so a later post must signal again.
+      if (spin_budget_usec_ > 0)
+        ++spin_statistics_.parks;
       wakeup_event_.clear(lock);
+      wakeup_pending_ = false;
       wakeup_event_.wait(lock);
+      wakeup_pending_ = false;
+      end_injection_wait();
     }
   }
 
@@ -422,11 +665,27 @@ std::size_t scheduler::do_wait_one(mutex::scoped_lock& lock,
   if (stopped_)
     return 0;
 
+#if defined(NET_TS_HAS_CHRONO)
+  time_cache_.invalidate();
+#endif // defined(NET_TS_HAS_CHRONO)
+
+  if (injection_rings_)
+    drain_injection_rings();
+
   operation* o = op_queue_.front();
   if (o == 0)
   {
-    wakeup_event_.clear(lock);
-    wakeup_event_.wait_for_usec(lock, usec);
+    if (begin_injection_wait())
+    {
+      wakeup_event_.clear(lock);
+      wakeup_pending_ = false;
+      wakeup_event_.wait_for_usec(lock, usec);
+      wakeup_pending_ = false;
+      end_injection_wait();
+#if defined(NET_TS_HAS_CHRONO)
+      time_cache_.invalidate();
+#endif // defined(NET_TS_HAS_CHRONO)
+    }
     usec = 0; // Wait at most once.
     o = op_queue_.front();
   }
@@ -436,15 +695,25 @@ std::size_t scheduler::do_wait_one(mutex::scoped_lock& lock,
     op_queue_.pop();
     bool more_handlers = (!op_queue_.empty());
 
+    bool injection_wait = false;
+    if (!more_handlers && usec != 0)
+    {
+      injection_wait = begin_injection_wait();
+      more_handlers = !injection_wait;
+    }
+
     task_interrupted_ = more_handlers;
 
     if (more_handlers && !one_thread_)
+    {
+      notify_spinning_threads();
       wakeup_event_.unlock_and_signal_one(lock);
+    }
     else
       lock.unlock();
 
     {
-      task_cleanup on_exit = { this, &lock, &this_thread };
+      task_cleanup on_exit = { this, &lock, &this_thread, injection_wait };
       (void)on_exit;
 
       // Run the task. May throw an exception. Only block if the operation
@@ -457,7 +726,10 @@ std::size_t scheduler::do_wait_one(mutex::scoped_lock& lock,
     if (o == &task_operation_)
     {
       if (!one_thread_)
+      {
+        notify_spinning_threads();
         wakeup_event_.maybe_unlock_and_signal_one(lock);
+      }
       return 0;
     }
   }
@@ -492,6 +764,13 @@ std::size_t scheduler::do_poll_one(mutex::scoped_lock& lock,
   if (stopped_)
     return 0;
 
+#if defined(NET_TS_HAS_CHRONO)
+  time_cache_.invalidate();
+#endif // defined(NET_TS_HAS_CHRONO)
+
+  if (injection_rings_)
+    drain_injection_rings();
+
   operation* o = op_queue_.front();
   if (o == &task_operation_)
   {
@@ -499,7 +778,7 @@ std::size_t scheduler::do_poll_one(mutex::scoped_lock& lock,
     lock.unlock();
 
     {
-      task_cleanup c = { this, &lock, &this_thread };
+      task_cleanup c = { this, &lock, &this_thread, false };
       (void)c;
 
       // Run the task. May throw an exception. Only block if the operation
@@ -511,6 +790,7 @@ std::size_t scheduler::do_poll_one(mutex::scoped_lock& lock,
     o = op_queue_.front();
     if (o == &task_operation_)
     {
+      notify_spinning_threads();
       wakeup_event_.maybe_unlock_and_signal_one(lock);
       return 0;
     }
@@ -539,10 +819,136 @@ std::size_t scheduler::do_poll_one(mutex::scoped_lock& lock,
   return 1;
 }
 
+void scheduler::spin_task(mutex::scoped_lock& lock,
+    scheduler::thread_info& this_thread, long usec, long wakeups)
+{
+#if defined(NET_TS_HAS_CHRONO)
+  const chrono::steady_clock::time_point deadline =
+    chrono::steady_clock::now() + chrono::microseconds(usec);
+
+  for (;;)
+  {
+    task_->run(0, this_thread.private_op_queue);
+    bool found = !this_thread.private_op_queue.empty();
+    bool expired = !found && chrono::steady_clock::now() >= deadline;
+
+    if (found || expired || spin_wakeups_ != wakeups)
+    {
+      lock.lock();
+      if (injection_rings_)
+        drain_injection_rings();
+      found = found || !op_queue_.empty() || stopped_;
+      if (found)
+      {
+        ++spin_statistics_.spin_hits;
+        task_spinning_ = false;
+        lock.unlock();
+        return;
+      }
+
+      if (expired)
+      {
+        // Nothing arrived, so block in the task. From here on, threads that
+        // post work must interrupt the task to wake it.
+        ++spin_statistics_.parks;
+        task_spinning_ = false;
+        task_interrupted_ = false;
+        lock.unlock();
+        task_->run(-1, this_thread.private_op_queue);
+        return;
+      }
+
+      wakeups = spin_wakeups_;
+      lock.unlock();
+    }
+
+    cpu_relax();
+  }
+#else // defined(NET_TS_HAS_CHRONO)
+  (void)usec;
+  (void)wakeups;
+  lock.lock();
+  ++spin_statistics_.parks;
+  task_spinning_ = false;
+  task_interrupted_ = false;
+  lock.unlock();
+  task_->run(-1, this_thread.private_op_queue);
+#endif // defined(NET_TS_HAS_CHRONO)
+}
+
+bool scheduler::spin_for_work(mutex::scoped_lock& lock)
+{
+#if defined(NET_TS_HAS_CHRONO)
+  const chrono::steady_clock::time_point deadline =
+    chrono::steady_clock::now() + chrono::microseconds(spin_usec_);
+
+  ++spin_statistics_.spins;
+  ++spinning_threads_;
+  long wakeups = spin_wakeups_;
+  lock.unlock();
+
+  // Watch the wakeup count without holding the lock, so that threads posting
+  // work are not held up. The queue itself is only examined once the count
+  // changes or the budget has been used up.
+  bool found = false;
+  for (;;)
+  {
+    cpu_relax();
+    bool expired = chrono::steady_clock::now() >= deadline;
+    if (expired || spin_wakeups_ != wakeups)
+    {
+      lock.lock();
+      if (injection_rings_)
+        drain_injection_rings();
+      found = !op_queue_.empty() || stopped_;
+      if (found || expired)
+        break;
+      wakeups = spin_wakeups_;
+      lock.unlock();
+    }
+  }
+
+  --spinning_threads_;
+  if (found)
+    ++spin_statistics_.spin_hits;
+  return found;
+#else // defined(NET_TS_HAS_CHRONO)
+  (void)lock;
+  return false;
+#endif // defined(NET_TS_HAS_CHRONO)
+}
+
+bool scheduler::drain_injection_rings()
+{
+  std::size_t n = 0;
+  for (injection_ring* r = injection_rings_; r; r = r->next_)
+    n += r->pop_all(op_queue_);
+
+  if (n > 0)
+  {
+    std::experimental::net::v1::detail::increment(
+        outstanding_work_, static_cast<long>(n));
+  }
+
+  return n > 0;
+}
+
+bool scheduler::begin_injection_wait()
+{
+  ++injection_waiters_;
+  if (injection_rings_ && drain_injection_rings())
+  {
+    --injection_waiters_;
+    return false;
+  }
+  return true;
+}
+
 void scheduler::stop_all_threads(
     mutex::scoped_lock& lock)
 {
   stopped_ = true;
+  ++spin_wakeups_;
   wakeup_event_.signal_all(lock);
 
   if (!task_interrupted_ && task_)
@@ -555,8 +961,25 @@ void scheduler::stop_all_threads(
 void scheduler::wake_one_thread_and_unlock(
     mutex::scoped_lock& lock)
 {
+  // A spinning thread will find the work without being woken.
+  if (spinning_threads_ > 0 || task_spinning_)
+  {
+    notify_spinning_threads();
+    lock.unlock();
+    return;
+  }
+
+  // A thread that has already been signalled will pick up the work.
+  if (wakeup_pending_)
+  {
+    lock.unlock();
+    return;
+  }
+
+  wakeup_pending_ = true;
   if (!wakeup_event_.maybe_unlock_and_signal_one(lock))
   {
+    wakeup_pending_ = false;
     if (!task_interrupted_ && task_)
     {
       task_interrupted_ = true;
@@ -144,7 +144,7 @@ void select_reactor::move_descriptor(socket_type,
 
 void select_reactor::start_op(int op_type, socket_type descriptor,
     select_reactor::per_descriptor_data&, reactor_op* op,
-    bool is_continuation, bool)
+    bool is_continuation, bool, bool)
 {
   std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
 
@@ -167,6 +167,19 @@ void select_reactor::cancel_ops(socket_type descriptor,
   cancel_ops_unlocked(descriptor, std::experimental::net::v1::error::operation_aborted);
 }
 
+void select_reactor::cancel_ops_by_key(socket_type descriptor,
+    select_reactor::per_descriptor_data&, int op_type, void* cancellation_key)
+{
+  std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+  op_queue<operation> ops;
+  bool need_interrupt = op_queue_[op_type].cancel_operations_by_key(
+      descriptor, ops, cancellation_key,
+      std::experimental::net::v1::error::operation_aborted);
+  scheduler_.post_deferred_completions(ops);
+  if (need_interrupt)
+    interrupter_.interrupt();
+}
+
 void select_reactor::deregister_descriptor(socket_type descriptor,
     select_reactor::per_descriptor_data&, bool)
 {
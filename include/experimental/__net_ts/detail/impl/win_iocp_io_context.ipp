@@ -74,7 +74,10 @@ win_iocp_io_context::win_iocp_io_context(
     shutdown_(0),
     gqcs_timeout_(get_gqcs_timeout()),
     dispatch_required_(0),
-    concurrency_hint_(concurrency_hint)
+    concurrency_hint_(concurrency_hint),
+    spin_budget_usec_(0),
+    inline_completion_(false),
+    inline_completion_depth_(8)
 {
   NET_TS_HANDLER_TRACKING_INIT;
 
@@ -385,6 +388,10 @@ size_t win_iocp_io_context::do_one(DWORD msec, std::error_code& ec)
         msec < gqcs_timeout_ ? msec : gqcs_timeout_);
     DWORD last_error = ::GetLastError();
 
+#if defined(NET_TS_HAS_CHRONO)
+    time_cache_.invalidate();
+#endif // defined(NET_TS_HAS_CHRONO)
+
     if (overlapped)
     {
       win_iocp_operation* op = static_cast<win_iocp_operation*>(overlapped);
@@ -0,0 +1,162 @@
+//
+// detail/injection_ring.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_INJECTION_RING_HPP
+#define NET_TS_DETAIL_INJECTION_RING_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <experimental/__net_ts/detail/noncopyable.hpp>
+#include <experimental/__net_ts/detail/op_queue.hpp>
+#include <experimental/__net_ts/detail/operation.hpp>
+
+#if defined(NET_TS_HAS_STD_ATOMIC)
+# include <atomic>
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+// A bounded single-producer, single-consumer queue of operations. The
+// producer pushes without locking. The consumer is whichever thread is running
+// the scheduler, and pops while holding the scheduler's lock.
+class injection_ring
+  : private noncopyable
+{
+public:
+  // Constructor. The capacity is rounded up to a power of two.
+  explicit injection_ring(std::size_t capacity)
+    : slots_(0),
+      mask_(0),
+      next_(0)
+  {
+    std::size_t n = 2;
+    while (n < capacity)
+      n <<= 1;
+    slots_ = new operation*[n];
+    mask_ = n - 1;
+
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+    cached_head_ = 0;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+  }
+
+  // Destructor destroys any operations that were never popped.
+  ~injection_ring()
+  {
+    op_queue<operation> ops;
+    pop_all(ops);
+    delete[] slots_;
+  }
+
+  // Get the number of operations the ring can hold.
+  std::size_t capacity() const
+  {
+    return mask_ + 1;
+  }
+
+  // Add an operation to the ring. Returns false if the ring is full. Must only
+  // be called by the producer.
+  bool push(operation* op)
+  {
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cached_head_ > mask_)
+    {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail - cached_head_ > mask_)
+        return false;
+    }
+
+    slots_[tail & mask_] = op;
+
+    // The store is sequentially consistent so that it is ordered before the
+    // producer's subsequent check for blocked consumers.
+    tail_.store(tail + 1, std::memory_order_seq_cst);
+    return true;
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+    // Without atomics the producer must use the locked path.
+    (void)op;
+    return false;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+  }
+
+  // Move all operations from the ring to the given queue, returning the
+  // number moved. Must only be called by the consumer.
+  std::size_t pop_all(op_queue<operation>& ops)
+  {
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    std::size_t tail = tail_.load(std::memory_order_seq_cst);
+    if (head == tail)
+      return 0;
+
+    for (std::size_t i = head; i != tail; ++i)
+      ops.push(slots_[i & mask_]);
+    head_.store(tail, std::memory_order_release);
+    return tail - head;
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+    (void)ops;
+    return 0;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+  }
+
+private:
+  friend class scheduler;
+
+  // Enough padding to keep the producer and consumer indexes on separate
+  // cache lines.
+  enum { cache_line_size = 64 };
+
+  // The slots, which hold up to mask_ + 1 operations.
+  operation** slots_;
+  std::size_t mask_;
+
+  // The next ring registered with the same scheduler.
+  injection_ring* next_;
+
+#if defined(NET_TS_HAS_STD_ATOMIC)
+  char pad1_[cache_line_size];
+
+  // The index of the next slot to be popped. Written by the consumer.
+  std::atomic<std::size_t> head_;
+
+  char pad2_[cache_line_size];
+
+  // The index of the next slot to be pushed. Written by the producer.
+  std::atomic<std::size_t> tail_;
+
+  // The producer's copy of head_, refreshed only when the ring appears full.
+  std::size_t cached_head_;
+
+  char pad3_[cache_line_size];
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_DETAIL_INJECTION_RING_HPP
@@ -0,0 +1,330 @@
+//
+// detail/light_future_state.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_LIGHT_FUTURE_STATE_HPP
+#define NET_TS_DETAIL_LIGHT_FUTURE_STATE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+
+#if defined(NET_TS_HAS_STD_ATOMIC) \
+  && defined(NET_TS_HAS_MOVE) \
+  && defined(NET_TS_HAS_VARIADIC_TEMPLATES)
+
+#include <atomic>
+#include <climits>
+#include <exception>
+#include <new>
+#include <system_error>
+#include <experimental/__net_ts/detail/executor_function.hpp>
+#include <experimental/__net_ts/detail/memory.hpp>
+#include <experimental/__net_ts/detail/noncopyable.hpp>
+#include <experimental/__net_ts/detail/recycling_allocator.hpp>
+#include <experimental/__net_ts/detail/thread_info_base.hpp>
+#include <experimental/__net_ts/detail/throw_error.hpp>
+#include <experimental/__net_ts/error.hpp>
+
+#if defined(NET_TS_HAS_FUTEX)
+# include <linux/futex.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#else // defined(NET_TS_HAS_FUTEX)
+# include <experimental/__net_ts/detail/event.hpp>
+# include <experimental/__net_ts/detail/mutex.hpp>
+#endif // defined(NET_TS_HAS_FUTEX)
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+// The part of a light_future's shared state that does not depend on the
+// result type. The state is shared by one consumer (the future, or a
+// continuation that has taken its place) and any number of copies of the
+// completion handler, each of which holds a reference.
+class light_future_state_base
+  : private noncopyable
+{
+public:
+  // Add a reference for a copy of the completion handler.
+  void add_producer() NET_TS_NOEXCEPT
+  {
+    producers_.fetch_add(1, std::memory_order_relaxed);
+    refs_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Release a reference held by a copy of the completion handler. If the last
+  // copy is destroyed without being invoked, the operation was abandoned.
+  void release_producer() NET_TS_NOEXCEPT
+  {
+    if (producers_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      if (!(state_.load(std::memory_order_acquire) & ready))
+        set_error(std::experimental::net::v1::error::operation_aborted);
+    release();
+  }
+
+  // Add a reference for the consumer.
+  void add_ref() NET_TS_NOEXCEPT
+  {
+    refs_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Release a reference, destroying the state when none remain.
+  void release() NET_TS_NOEXCEPT
+  {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      destroy_(this);
+  }
+
+  // Complete the state with an error code.
+  void set_error(const std::error_code& ec) NET_TS_NOEXCEPT
+  {
+    ec_ = ec;
+    complete();
+  }
+
+  // Complete the state with an exception.
+  void set_exception(const std::exception_ptr& ex) NET_TS_NOEXCEPT
+  {
+    ex_ = ex;
+    complete();
+  }
+
+  // Whether the state has been completed.
+  bool is_ready() const NET_TS_NOEXCEPT
+  {
+    return (state_.load(std::memory_order_acquire) & ready) != 0;
+  }
+
+  // Block the calling thread until the state has been completed.
+  void wait()
+  {
+    unsigned int s = state_.load(std::memory_order_acquire);
+    if (s & ready)
+      return;
+
+#if defined(NET_TS_HAS_FUTEX)
+    s = state_.fetch_or(waiting, std::memory_order_acq_rel) | waiting;
+    while (!(s & ready))
+    {
+      ::syscall(SYS_futex, reinterpret_cast<unsigned int*>(&state_),
+          FUTEX_WAIT_PRIVATE, s, 0, 0, 0);
+      s = state_.load(std::memory_order_acquire);
+    }
+#else // defined(NET_TS_HAS_FUTEX)
+    mutex::scoped_lock lock(mutex_);
+    state_.fetch_or(waiting, std::memory_order_acq_rel);
+    while (!(state_.load(std::memory_order_acquire) & ready))
+      event_.wait(lock);
+#endif // defined(NET_TS_HAS_FUTEX)
+  }
+
+  // Register a function to be invoked when the state is completed. The
+  // function is invoked immediately if the state is already complete.
+  void set_continuation(executor_function_base* f)
+  {
+    continuation_ = f;
+    unsigned int s = state_.fetch_or(
+        has_continuation, std::memory_order_acq_rel);
+    if (s & ready)
+      f->complete();
+  }
+
+  // Report the error, if any, with which the state was completed. A stored
+  // exception is rethrown. An error code is thrown as a system_error unless ec
+  // is non-null, in which case it is assigned to *ec.
+  void report_error(std::error_code* ec)
+  {
+#if !defined(NET_TS_NO_EXCEPTIONS)
+    if (ex_)
+      std::rethrow_exception(ex_);
+#endif // !defined(NET_TS_NO_EXCEPTIONS)
+    if (ec)
+      *ec = ec_;
+    else
+      std::experimental::net::v1::detail::throw_error(ec_);
+  }
+
+protected:
+  typedef void (*destroy_func_type)(light_future_state_base*);
+
+  light_future_state_base(destroy_func_type destroy_func) NET_TS_NOEXCEPT
+    : state_(0),
+      refs_(1),
+      producers_(1),
+      destroy_(destroy_func),
+      continuation_(0)
+  {
+  }
+
+  // Prevents deletion through this type.
+  ~light_future_state_base()
+  {
+  }
+
+  // Mark the state as complete and wake the consumer.
+  void complete() NET_TS_NOEXCEPT
+  {
+    unsigned int s = state_.fetch_or(ready, std::memory_order_acq_rel);
+
+    if (s & waiting)
+    {
+#if defined(NET_TS_HAS_FUTEX)
+      ::syscall(SYS_futex, reinterpret_cast<unsigned int*>(&state_),
+          FUTEX_WAKE_PRIVATE, INT_MAX, 0, 0, 0);
+#else // defined(NET_TS_HAS_FUTEX)
+      mutex::scoped_lock lock(mutex_);
+      event_.signal_all(lock);
+#endif // defined(NET_TS_HAS_FUTEX)
+    }
+
+    if (s & has_continuation)
+      continuation_->complete();
+  }
+
+private:
+  enum
+  {
+    ready = 1,
+    waiting = 2,
+    has_continuation = 4
+  };
+
+  std::atomic<unsigned int> state_;
+  std::atomic<unsigned int> refs_;
+  std::atomic<unsigned int> producers_;
+  destroy_func_type destroy_;
+  executor_function_base* continuation_;
+  std::error_code ec_;
+  std::exception_ptr ex_;
+
+#if !defined(NET_TS_HAS_FUTEX)
+  mutex mutex_;
+  event event_;
+#endif // !defined(NET_TS_HAS_FUTEX)
+};
+
+// The shared state for a light_future<T>.
+template <typename T>
+class light_future_state
+  : public light_future_state_base
+{
+public:
+  template <typename Arg>
+  void set_value(NET_TS_MOVE_ARG(Arg) arg)
+  {
+    new (&value_) T(NET_TS_MOVE_CAST(Arg)(arg));
+    has_value_ = true;
+    complete();
+  }
+
+  T take_value()
+  {
+    return NET_TS_MOVE_CAST(T)(value_);
+  }
+
+protected:
+  light_future_state(destroy_func_type destroy_func) NET_TS_NOEXCEPT
+    : light_future_state_base(destroy_func),
+      has_value_(false)
+  {
+  }
+
+  ~light_future_state()
+  {
+    if (has_value_)
+      value_.~T();
+  }
+
+private:
+  union
+  {
+    T value_;
+  };
+  bool has_value_;
+};
+
+template <>
+class light_future_state<void>
+  : public light_future_state_base
+{
+public:
+  void set_value()
+  {
+    complete();
+  }
+
+  void take_value()
+  {
+  }
+
+protected:
+  light_future_state(destroy_func_type destroy_func) NET_TS_NOEXCEPT
+    : light_future_state_base(destroy_func)
+  {
+  }
+};
+
+// The shared state with the allocator used to create it.
+template <typename T, typename Allocator>
+class light_future_state_impl
+  : public light_future_state<T>
+{
+public:
+  typedef typename get_recycling_allocator<Allocator,
+    thread_info_base::light_future_tag>::type recycling_allocator_type;
+  typedef NET_TS_REBIND_ALLOC(recycling_allocator_type,
+    light_future_state_impl) allocator_type;
+
+  static light_future_state<T>* create(const Allocator& a)
+  {
+    allocator_type alloc(get_recycling_allocator<Allocator,
+        thread_info_base::light_future_tag>::get(a));
+    void* p = alloc.allocate(1);
+    return new (p) light_future_state_impl(alloc);
+  }
+
+private:
+  explicit light_future_state_impl(const allocator_type& a) NET_TS_NOEXCEPT
+    : light_future_state<T>(&light_future_state_impl::do_destroy),
+      allocator_(a)
+  {
+  }
+
+  static void do_destroy(light_future_state_base* base)
+  {
+    light_future_state_impl* s = static_cast<light_future_state_impl*>(base);
+    allocator_type alloc(s->allocator_);
+    s->~light_future_state_impl();
+    alloc.deallocate(s, 1);
+  }
+
+  allocator_type allocator_;
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+       //   && defined(NET_TS_HAS_MOVE)
+       //   && defined(NET_TS_HAS_VARIADIC_TEMPLATES)
+
+#endif // NET_TS_DETAIL_LIGHT_FUTURE_STATE_HPP
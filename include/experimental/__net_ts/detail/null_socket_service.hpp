@@ -19,11 +19,13 @@
 
 #if defined(NET_TS_WINDOWS_RUNTIME)
 
+#include <vector>
 #include <experimental/__net_ts/buffer.hpp>
 #include <experimental/__net_ts/error.hpp>
 #include <experimental/__net_ts/io_context.hpp>
 #include <experimental/__net_ts/socket_base.hpp>
 #include <experimental/__net_ts/detail/bind_handler.hpp>
+#include <experimental/__net_ts/detail/cstdint.hpp>
 
 #include <experimental/__net_ts/detail/push_options.hpp>
 
@@ -137,6 +139,14 @@ public:
     return 0;
   }
 
+  // Move an open socket to another service.
+  std::error_code migrate(implementation_type&, null_socket_service&,
+      implementation_type&, std::error_code& ec)
+  {
+    ec = std::experimental::net::v1::error::operation_not_supported;
+    return ec;
+  }
+
   // Cancel all operations associated with the socket.
   std::error_code cancel(implementation_type&,
       std::error_code& ec)
@@ -145,6 +155,30 @@ public:
     return ec;
   }
 
+  // Set whether readiness of the socket wakes only one of the io_contexts
+  // waiting on the same open socket.
+  std::error_code set_exclusive_wakeup(implementation_type&,
+      bool, std::error_code& ec)
+  {
+    ec = std::experimental::net::v1::error::operation_not_supported;
+    return ec;
+  }
+
+  // Set the timeout, in microseconds, after which an operation on the socket
+  // that is waiting for readiness fails with the timed_out error.
+  std::error_code set_operation_timeout(implementation_type&,
+      uint64_t, std::error_code& ec)
+  {
+    ec = std::experimental::net::v1::error::operation_not_supported;
+    return ec;
+  }
+
+  // Get the timeout, in microseconds, for operations on the socket.
+  uint64_t operation_timeout(const implementation_type&) const
+  {
+    return 0;
+  }
+
   // Determine whether the socket is at the out-of-band data mark.
   bool at_mark(const implementation_type&,
       std::error_code& ec) const
@@ -192,6 +226,22 @@ public:
     return ec;
   }
 
+  // Gets whether operations that complete immediately invoke their handlers
+  // inline.
+  bool inline_completion(const implementation_type&) const
+  {
+    return false;
+  }
+
+  // Sets whether operations that complete immediately invoke their handlers
+  // inline.
+  std::error_code inline_completion(implementation_type&,
+      bool, std::error_code& ec)
+  {
+    ec = std::experimental::net::v1::error::operation_not_supported;
+    return ec;
+  }
+
   // Gets the non-blocking mode of the native socket implementation.
   bool native_non_blocking(const implementation_type&) const
   {
@@ -480,6 +530,18 @@ public:
     io_context_.post(detail::bind_handler(handler, ec));
   }
 
+  // Start an asynchronous accept of a batch of connections.
+  template <typename Balancer, typename Handler>
+  void async_accept_many(implementation_type&,
+      std::size_t, Balancer&, Handler& handler)
+  {
+    std::error_code ec = std::experimental::net::v1::error::operation_not_supported;
+    io_context_.post(detail::move_binder2<Handler, std::error_code,
+          std::vector<typename Protocol::socket> >(0,
+            NET_TS_MOVE_CAST(Handler)(handler), ec,
+            std::vector<typename Protocol::socket>()));
+  }
+
   // Connect the socket to the specified endpoint.
   std::error_code connect(implementation_type&,
       const endpoint_type&, std::error_code& ec)
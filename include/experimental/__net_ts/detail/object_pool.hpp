@@ -15,6 +15,7 @@
 # pragma once
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
+#include <new>
 #include <experimental/__net_ts/detail/noncopyable.hpp>
 
 #include <experimental/__net_ts/detail/push_options.hpp>
@@ -49,6 +50,18 @@ public:
     delete o;
   }
 
+  template <typename Object, typename Arg>
+  static Object* construct(void* p, Arg arg)
+  {
+    return new (p) Object(arg);
+  }
+
+  template <typename Object>
+  static void destruct(Object* o)
+  {
+    o->~Object();
+  }
+
   template <typename Object>
   static Object*& next(Object* o)
   {
@@ -0,0 +1,256 @@
+//
+// detail/periodic_timer_service.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_PERIODIC_TIMER_SERVICE_HPP
+#define NET_TS_DETAIL_PERIODIC_TIMER_SERVICE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <experimental/__net_ts/error.hpp>
+#include <experimental/__net_ts/io_context.hpp>
+#include <experimental/__net_ts/detail/memory.hpp>
+#include <experimental/__net_ts/detail/noncopyable.hpp>
+#include <experimental/__net_ts/detail/periodic_wait_handler.hpp>
+#include <experimental/__net_ts/detail/timer_queue.hpp>
+#include <experimental/__net_ts/detail/timer_scheduler.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+// Service for timers that wait repeatedly at a fixed interval. A single wait
+// operation is created for each call to async_wait() and is put back into the
+// timer queue after each expiry, so that an expiry does not allocate. The
+// duration type of the time traits must support the arithmetic operators.
+template <typename Time_Traits>
+class periodic_timer_service
+  : public service_base<periodic_timer_service<Time_Traits> >
+{
+public:
+  // The time type.
+  typedef typename Time_Traits::time_type time_type;
+
+  // The duration type.
+  typedef typename Time_Traits::duration_type duration_type;
+
+  // The implementation type of the timer.
+  struct implementation_type
+    : private std::experimental::net::v1::detail::noncopyable
+  {
+    time_type expiry;
+    duration_type period;
+    bool compensate_drift;
+    periodic_wait_op<implementation_type>* op;
+    typename timer_queue<Time_Traits>::per_timer_data timer_data;
+  };
+
+  // Constructor.
+  periodic_timer_service(std::experimental::net::v1::io_context& io_context)
+    : service_base<periodic_timer_service<Time_Traits> >(io_context),
+      scheduler_(std::experimental::net::v1::use_service<timer_scheduler>(io_context))
+  {
+    scheduler_.init_task();
+    scheduler_.add_timer_queue(timer_queue_);
+  }
+
+  // Destructor.
+  ~periodic_timer_service()
+  {
+    scheduler_.remove_timer_queue(timer_queue_);
+  }
+
+  // Destroy all user-defined handler objects owned by the service.
+  void shutdown()
+  {
+  }
+
+  // Construct a new timer implementation.
+  void construct(implementation_type& impl)
+  {
+    impl.expiry = time_type();
+    impl.period = duration_type();
+    impl.compensate_drift = false;
+    impl.op = 0;
+  }
+
+  // Destroy a timer implementation.
+  void destroy(implementation_type& impl)
+  {
+    std::error_code ec;
+    cancel(impl, ec);
+  }
+
+  // Move-construct a new timer implementation.
+  void move_construct(implementation_type& impl,
+      implementation_type& other_impl)
+  {
+    scheduler_.move_timer(timer_queue_, impl.timer_data, other_impl.timer_data);
+
+    impl.expiry = other_impl.expiry;
+    other_impl.expiry = time_type();
+
+    impl.period = other_impl.period;
+    other_impl.period = duration_type();
+
+    impl.compensate_drift = other_impl.compensate_drift;
+    other_impl.compensate_drift = false;
+
+    impl.op = other_impl.op;
+    other_impl.op = 0;
+    if (impl.op)
+      impl.op->impl_ = &impl;
+  }
+
+  // Move-assign from another timer implementation.
+  void move_assign(implementation_type& impl,
+      periodic_timer_service& other_service,
+      implementation_type& other_impl)
+  {
+    std::error_code ec;
+    cancel(impl, ec);
+
+    other_service.move_construct(impl, other_impl);
+  }
+
+  // Cancel the periodic wait, if any. The handler is called one more time,
+  // with the operation_aborted error.
+  std::size_t cancel(implementation_type& impl, std::error_code& ec)
+  {
+    ec = std::error_code();
+    if (!impl.op)
+      return 0;
+
+    NET_TS_HANDLER_OPERATION((scheduler_.context(),
+          "periodic_timer", &impl, 0, "cancel"));
+
+    // Detach the operation before cancelling it, as it may be destroyed as
+    // soon as it is dequeued. If it is not in the queue then its handler is
+    // running, or about to run, and sees that it has been detached.
+    impl.op->impl_ = 0;
+    impl.op = 0;
+    scheduler_.cancel_timer(timer_queue_, impl.timer_data);
+    return 1;
+  }
+
+  // Get the time of the next expiry.
+  time_type expiry(const implementation_type& impl) const
+  {
+    return impl.expiry;
+  }
+
+  // Get the interval between expiries.
+  duration_type period(const implementation_type& impl) const
+  {
+    return impl.period;
+  }
+
+  // Set the interval between expiries. Takes effect from the next expiry.
+  void period(implementation_type& impl,
+      const duration_type& period, std::error_code& ec)
+  {
+    if (period <= duration_type::zero())
+    {
+      ec = std::experimental::net::v1::error::invalid_argument;
+      return;
+    }
+
+    impl.period = period;
+    ec = std::error_code();
+  }
+
+  // Get whether expiries are scheduled at fixed multiples of the period.
+  bool compensate_drift(const implementation_type& impl) const
+  {
+    return impl.compensate_drift;
+  }
+
+  // Set whether expiries are scheduled at fixed multiples of the period.
+  void compensate_drift(implementation_type& impl, bool value)
+  {
+    impl.compensate_drift = value;
+  }
+
+  // Start a periodic wait, replacing any existing one.
+  template <typename Handler>
+  void async_wait(implementation_type& impl, Handler& handler)
+  {
+    std::error_code ec;
+    cancel(impl, ec);
+
+    // Allocate and construct the operation that is used for all expiries.
+    typedef periodic_wait_handler<Handler, periodic_timer_service> op;
+    typename op::ptr p = { std::experimental::net::v1::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(handler, *this);
+
+    p.p->impl_ = &impl;
+    impl.op = p.p;
+    impl.expiry = Time_Traits::add(Time_Traits::now(), impl.period);
+
+    NET_TS_HANDLER_CREATION((scheduler_.context(),
+          *p.p, "periodic_timer", &impl, 0, "async_wait"));
+
+    scheduler_.schedule_timer(timer_queue_, impl.expiry, impl.timer_data, p.p);
+    p.v = p.p = 0;
+  }
+
+  // Put the operation back into the queue to wait for the next expiry. Called
+  // by the operation after each upcall.
+  void schedule_next(implementation_type& impl, wait_op* op)
+  {
+    time_type now = Time_Traits::now();
+    if (impl.compensate_drift)
+    {
+      // Keep expiries at fixed multiples of the period. Expiries that have
+      // been missed entirely are skipped rather than delivered in a burst.
+      impl.expiry = Time_Traits::add(impl.expiry, impl.period);
+      if (!Time_Traits::less_than(now, impl.expiry))
+      {
+        duration_type behind = Time_Traits::subtract(now, impl.expiry);
+        impl.expiry = Time_Traits::add(impl.expiry,
+            impl.period * (behind / impl.period + 1));
+      }
+    }
+    else
+    {
+      impl.expiry = Time_Traits::add(now, impl.period);
+    }
+
+    NET_TS_HANDLER_CREATION((scheduler_.context(),
+          *op, "periodic_timer", &impl, 0, "async_wait"));
+
+    scheduler_.schedule_timer(timer_queue_, impl.expiry, impl.timer_data, op);
+  }
+
+private:
+  // The queue of timers.
+  timer_queue<Time_Traits> timer_queue_;
+
+  // The object that schedules and executes timers. Usually a reactor.
+  timer_scheduler& scheduler_;
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_DETAIL_PERIODIC_TIMER_SERVICE_HPP
@@ -0,0 +1,162 @@
+//
+// detail/periodic_wait_handler.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_PERIODIC_WAIT_HANDLER_HPP
+#define NET_TS_DETAIL_PERIODIC_WAIT_HANDLER_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <experimental/__net_ts/detail/fenced_block.hpp>
+#include <experimental/__net_ts/detail/handler_alloc_helpers.hpp>
+#include <experimental/__net_ts/detail/handler_invoke_helpers.hpp>
+#include <experimental/__net_ts/detail/handler_work.hpp>
+#include <experimental/__net_ts/detail/memory.hpp>
+#include <experimental/__net_ts/detail/wait_op.hpp>
+#include <experimental/__net_ts/error.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+// A wait operation that stays alive across expiries of a periodic timer. The
+// timer implementation points to the operation, and the operation points back
+// to the implementation until the wait is cancelled.
+template <typename Impl>
+class periodic_wait_op
+  : public wait_op
+{
+public:
+  // The implementation of the timer. Cleared to cancel the operation.
+  Impl* impl_;
+
+protected:
+  periodic_wait_op(func_type func)
+    : wait_op(func),
+      impl_(0)
+  {
+  }
+};
+
+template <typename Handler, typename Service>
+class periodic_wait_handler
+  : public periodic_wait_op<typename Service::implementation_type>
+{
+public:
+  NET_TS_DEFINE_HANDLER_PTR(periodic_wait_handler);
+
+  periodic_wait_handler(Handler& h, Service& service)
+    : periodic_wait_op<typename Service::implementation_type>(
+        &periodic_wait_handler::do_complete),
+      handler_(NET_TS_MOVE_CAST(Handler)(h)),
+      service_(&service)
+  {
+    handler_work<Handler>::start(handler_);
+  }
+
+  static void do_complete(void* owner, operation* base,
+      const std::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    periodic_wait_handler* h(static_cast<periodic_wait_handler*>(base));
+
+    if (!owner)
+    {
+      // Destroy the operation without making an upcall. The timer, if it still
+      // exists, must no longer refer to it.
+      ptr p = { std::experimental::net::v1::detail::addressof(h->handler_), h, h };
+      handler_work<Handler> w(h->handler_);
+      if (h->impl_)
+        h->impl_->op = 0;
+      p.reset();
+      return;
+    }
+
+    NET_TS_HANDLER_COMPLETION((*h));
+
+    // Each expiry is dispatched through the handler's executor. The work
+    // counted here is for this expiry only, as the work started when the
+    // operation was created lasts until the final upcall.
+    handler_work<Handler> w(h->handler_);
+    handler_work<Handler>::start(h->handler_);
+    tick t(h);
+    fenced_block b(fenced_block::half);
+    w.complete(t, h->handler_);
+  }
+
+private:
+  // Function object that makes the upcall for one expiry, in the context of
+  // the handler's executor.
+  class tick
+  {
+  public:
+    explicit tick(periodic_wait_handler* h)
+      : h_(h)
+    {
+    }
+
+    void operator()()
+    {
+      h_->run();
+    }
+
+  private:
+    periodic_wait_handler* h_;
+  };
+
+  void run()
+  {
+    // The timer may have been cancelled after the operation was dequeued.
+    if (this->impl_)
+    {
+      handler_(std::error_code());
+
+      // Wait for the next expiry, unless the handler cancelled the timer.
+      if (this->impl_)
+      {
+        service_->schedule_next(*this->impl_, this);
+        return;
+      }
+    }
+
+    // Take ownership of the handler object, releasing the work that was
+    // started when the operation was created.
+    ptr p = { std::experimental::net::v1::detail::addressof(handler_), this, this };
+    handler_work<Handler> w(handler_);
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the final upcall is made.
+    Handler handler(NET_TS_MOVE_CAST(Handler)(handler_));
+    p.h = std::experimental::net::v1::detail::addressof(handler);
+    p.reset();
+
+    std::error_code ec = std::experimental::net::v1::error::operation_aborted;
+    handler(ec);
+  }
+
+  Handler handler_;
+  Service* service_;
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_DETAIL_PERIODIC_WAIT_HANDLER_HPP
@@ -16,6 +16,8 @@
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
 #include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <vector>
 #include <experimental/__net_ts/detail/bind_handler.hpp>
 #include <experimental/__net_ts/detail/buffer_sequence_adapter.hpp>
 #include <experimental/__net_ts/detail/fenced_block.hpp>
@@ -112,6 +114,7 @@ public:
     // Take ownership of the handler object.
     reactive_socket_accept_op* o(static_cast<reactive_socket_accept_op*>(base));
     ptr p = { std::experimental::net::v1::detail::addressof(o->handler_), o, o };
+    o->clear_cancellation_slot(o->handler_);
     handler_work<Handler> w(o->handler_);
 
     // On success, assign new connection to peer socket object.
@@ -175,6 +178,7 @@ public:
     reactive_socket_move_accept_op* o(
         static_cast<reactive_socket_move_accept_op*>(base));
     ptr p = { std::experimental::net::v1::detail::addressof(o->handler_), o, o };
+    o->clear_cancellation_slot(o->handler_);
     handler_work<Handler> w(o->handler_);
 
     // On success, assign new connection to peer socket object.
@@ -210,6 +214,144 @@ private:
   Handler handler_;
 };
 
+template <typename Protocol, typename Balancer, typename Handler>
+class reactive_socket_accept_many_op : public reactor_op
+{
+public:
+  NET_TS_DEFINE_HANDLER_PTR(reactive_socket_accept_many_op);
+
+  reactive_socket_accept_many_op(socket_type socket,
+      socket_ops::state_type state, const Protocol& protocol,
+      std::size_t max_sockets, Balancer& balancer, Handler& handler)
+    : reactor_op(&reactive_socket_accept_many_op::do_perform,
+        &reactive_socket_accept_many_op::do_complete),
+      socket_(socket),
+      state_(state),
+      protocol_(protocol),
+      max_sockets_(max_sockets),
+      balancer_(NET_TS_MOVE_CAST(Balancer)(balancer)),
+      handler_(NET_TS_MOVE_CAST(Handler)(handler))
+  {
+    // Reserve space up front so that the reactor never allocates.
+    new_sockets_.reserve(max_sockets_);
+    handler_work<Handler>::start(handler_);
+  }
+
+  ~reactive_socket_accept_many_op()
+  {
+    // Close any sockets that were accepted but never delivered.
+    for (std::size_t i = 0; i < new_sockets_.size(); ++i)
+    {
+      socket_holder new_socket;
+      new_socket.reset(new_sockets_[i]);
+    }
+  }
+
+  static status do_perform(reactor_op* base)
+  {
+    reactive_socket_accept_many_op* o(
+        static_cast<reactive_socket_accept_many_op*>(base));
+
+    // Drain the backlog until it is empty or the batch is full, so that one
+    // readiness event yields as many connections as are waiting.
+    while (o->new_sockets_.size() < o->max_sockets_)
+    {
+      socket_type new_socket = invalid_socket;
+      std::error_code ec;
+      if (!socket_ops::non_blocking_accept(o->socket_,
+            o->state_, 0, 0, ec, new_socket))
+        break;
+
+      if (new_socket == invalid_socket)
+      {
+        // Report the error only if there is nothing else to deliver. Any
+        // persistent error will be reported by the next operation.
+        if (o->new_sockets_.empty())
+          o->ec_ = ec;
+        break;
+      }
+
+      o->new_sockets_.push_back(new_socket);
+    }
+
+    NET_TS_HANDLER_REACTOR_OPERATION((*o, "non_blocking_accept", o->ec_));
+
+    return (o->ec_ || !o->new_sockets_.empty()) ? done : not_done;
+  }
+
+  static void do_complete(void* owner, operation* base,
+      const std::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    // Take ownership of the handler object.
+    reactive_socket_accept_many_op* o(
+        static_cast<reactive_socket_accept_many_op*>(base));
+    ptr p = { std::experimental::net::v1::detail::addressof(o->handler_), o, o };
+    o->clear_cancellation_slot(o->handler_);
+    handler_work<Handler> w(o->handler_);
+
+    // On success, assign each new connection to a socket object on the
+    // io_context chosen by the balancer.
+    std::vector<typename Protocol::socket> peers;
+    if (owner)
+    {
+      std::error_code assign_ec;
+      peers.reserve(o->new_sockets_.size());
+      for (std::size_t i = 0; i < o->new_sockets_.size(); ++i)
+      {
+        socket_holder new_socket(o->new_sockets_[i]);
+        o->new_sockets_[i] = invalid_socket;
+
+        typename Protocol::socket peer(o->balancer_());
+        peer.assign(o->protocol_, new_socket.get(), assign_ec);
+        if (!assign_ec)
+        {
+          new_socket.release();
+          peers.push_back(NET_TS_MOVE_CAST(typename Protocol::socket)(peer));
+        }
+      }
+      o->new_sockets_.clear();
+
+      // Report a failure to assign only if no sockets can be delivered.
+      if (peers.empty() && !o->ec_)
+        o->ec_ = assign_ec;
+    }
+
+    NET_TS_HANDLER_COMPLETION((*o));
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::move_binder2<Handler,
+      std::error_code, std::vector<typename Protocol::socket> >
+        handler(0, NET_TS_MOVE_CAST(Handler)(o->handler_), o->ec_,
+          NET_TS_MOVE_CAST(std::vector<typename Protocol::socket>)(peers));
+    p.h = std::experimental::net::v1::detail::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      NET_TS_HANDLER_INVOCATION_BEGIN((handler.arg1_, "..."));
+      w.complete(handler, handler.handler_);
+      NET_TS_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  socket_type socket_;
+  socket_ops::state_type state_;
+  Protocol protocol_;
+  std::size_t max_sockets_;
+  std::vector<socket_type> new_sockets_;
+  Balancer balancer_;
+  Handler handler_;
+};
+
 #endif // defined(NET_TS_HAS_MOVE)
 
 } // namespace detail
@@ -79,6 +79,7 @@ public:
     reactive_socket_connect_op* o
       (static_cast<reactive_socket_connect_op*>(base));
     ptr p = { std::experimental::net::v1::detail::addressof(o->handler_), o, o };
+    o->clear_cancellation_slot(o->handler_);
     handler_work<Handler> w(o->handler_);
 
     NET_TS_HANDLER_COMPLETION((*o));
@@ -101,6 +101,7 @@ public:
     // Take ownership of the handler object.
     reactive_socket_recv_op* o(static_cast<reactive_socket_recv_op*>(base));
     ptr p = { std::experimental::net::v1::detail::addressof(o->handler_), o, o };
+    o->clear_cancellation_slot(o->handler_);
     handler_work<Handler> w(o->handler_);
 
     NET_TS_HANDLER_COMPLETION((*o));
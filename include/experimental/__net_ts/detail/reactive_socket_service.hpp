@@ -148,6 +148,18 @@ public:
     return impl.socket_;
   }
 
+  // Move an open socket to another service, which may belong to a different
+  // io_context. Any pending operations are cancelled.
+  std::error_code migrate(implementation_type& impl,
+      reactive_socket_service& target_service,
+      implementation_type& target_impl, std::error_code& ec)
+  {
+    if (!reactive_socket_service_base::migrate(
+          impl, target_service, target_impl, ec))
+      target_impl.protocol_ = impl.protocol_;
+    return ec;
+  }
+
   // Bind the socket to the specified local endpoint.
   std::error_code bind(implementation_type& impl,
       const endpoint_type& endpoint, std::error_code& ec)
@@ -251,6 +263,9 @@ public:
     bool is_continuation =
       networking_ts_handler_cont_helpers::is_continuation(handler);
 
+    typename associated_cancellation_slot<Handler>::type slot =
+      std::experimental::net::v1::get_associated_cancellation_slot(handler);
+
     // Allocate and construct an operation to wrap the handler.
     typedef reactive_socket_sendto_op<ConstBufferSequence,
         endpoint_type, Handler> op;
@@ -261,8 +276,10 @@ public:
     NET_TS_HANDLER_CREATION((reactor_.context(), *p.p, "socket",
           &impl, impl.socket_, "async_send_to"));
 
-    start_op(impl, reactor::write_op, p.p, is_continuation, true, false);
+    assign_cancellation_slot(slot, impl, reactor::write_op, p.p);
+    reactor_op* o = p.p;
     p.v = p.p = 0;
+    start_op(impl, reactor::write_op, o, is_continuation, true, false);
   }
 
   // Start an asynchronous wait until data can be sent without blocking.
@@ -273,6 +290,9 @@ public:
     bool is_continuation =
       networking_ts_handler_cont_helpers::is_continuation(handler);
 
+    typename associated_cancellation_slot<Handler>::type slot =
+      std::experimental::net::v1::get_associated_cancellation_slot(handler);
+
     // Allocate and construct an operation to wrap the handler.
     typedef reactive_null_buffers_op<Handler> op;
     typename op::ptr p = { std::experimental::net::v1::detail::addressof(handler),
@@ -282,8 +302,10 @@ public:
     NET_TS_HANDLER_CREATION((reactor_.context(), *p.p, "socket",
           &impl, impl.socket_, "async_send_to(null_buffers)"));
 
-    start_op(impl, reactor::write_op, p.p, is_continuation, false, false);
+    assign_cancellation_slot(slot, impl, reactor::write_op, p.p);
+    reactor_op* o = p.p;
     p.v = p.p = 0;
+    start_op(impl, reactor::write_op, o, is_continuation, false, false);
   }
 
   // Receive a datagram with the endpoint of the sender. Returns the number of
@@ -333,6 +355,9 @@ public:
     bool is_continuation =
       networking_ts_handler_cont_helpers::is_continuation(handler);
 
+    typename associated_cancellation_slot<Handler>::type slot =
+      std::experimental::net::v1::get_associated_cancellation_slot(handler);
+
     // Allocate and construct an operation to wrap the handler.
     typedef reactive_socket_recvfrom_op<MutableBufferSequence,
         endpoint_type, Handler> op;
@@ -345,11 +370,15 @@ public:
     NET_TS_HANDLER_CREATION((reactor_.context(), *p.p, "socket",
           &impl, impl.socket_, "async_receive_from"));
 
+    assign_cancellation_slot(slot, impl,
+        (flags & socket_base::message_out_of_band)
+          ? reactor::except_op : reactor::read_op, p.p);
+    reactor_op* o = p.p;
+    p.v = p.p = 0;
     start_op(impl,
         (flags & socket_base::message_out_of_band)
           ? reactor::except_op : reactor::read_op,
-        p.p, is_continuation, true, false);
-    p.v = p.p = 0;
+        o, is_continuation, true, false);
   }
 
   // Wait until data can be received without blocking.
@@ -361,6 +390,9 @@ public:
     bool is_continuation =
       networking_ts_handler_cont_helpers::is_continuation(handler);
 
+    typename associated_cancellation_slot<Handler>::type slot =
+      std::experimental::net::v1::get_associated_cancellation_slot(handler);
+
     // Allocate and construct an operation to wrap the handler.
     typedef reactive_null_buffers_op<Handler> op;
     typename op::ptr p = { std::experimental::net::v1::detail::addressof(handler),
@@ -373,11 +405,15 @@ public:
     // Reset endpoint since it can be given no sensible value at this time.
     sender_endpoint = endpoint_type();
 
+    assign_cancellation_slot(slot, impl,
+        (flags & socket_base::message_out_of_band)
+          ? reactor::except_op : reactor::read_op, p.p);
+    reactor_op* o = p.p;
+    p.v = p.p = 0;
     start_op(impl,
         (flags & socket_base::message_out_of_band)
           ? reactor::except_op : reactor::read_op,
-        p.p, is_continuation, false, false);
-    p.v = p.p = 0;
+        o, is_continuation, false, false);
   }
 
   // Accept a new connection.
@@ -447,6 +483,9 @@ public:
     bool is_continuation =
       networking_ts_handler_cont_helpers::is_continuation(handler);
 
+    typename associated_cancellation_slot<Handler>::type slot =
+      std::experimental::net::v1::get_associated_cancellation_slot(handler);
+
     // Allocate and construct an operation to wrap the handler.
     typedef reactive_socket_accept_op<Socket, Protocol, Handler> op;
     typename op::ptr p = { std::experimental::net::v1::detail::addressof(handler),
@@ -457,8 +496,10 @@ public:
     NET_TS_HANDLER_CREATION((reactor_.context(), *p.p, "socket",
           &impl, impl.socket_, "async_accept"));
 
-    start_accept_op(impl, p.p, is_continuation, peer.is_open());
+    assign_cancellation_slot(slot, impl, reactor::read_op, p.p);
+    reactor_op* o = p.p;
     p.v = p.p = 0;
+    start_accept_op(impl, o, is_continuation, peer.is_open());
   }
 
 #if defined(NET_TS_HAS_MOVE)
@@ -472,6 +513,9 @@ public:
     bool is_continuation =
       networking_ts_handler_cont_helpers::is_continuation(handler);
 
+    typename associated_cancellation_slot<Handler>::type slot =
+      std::experimental::net::v1::get_associated_cancellation_slot(handler);
+
     // Allocate and construct an operation to wrap the handler.
     typedef reactive_socket_move_accept_op<Protocol, Handler> op;
     typename op::ptr p = { std::experimental::net::v1::detail::addressof(handler),
@@ -482,8 +526,39 @@ public:
     NET_TS_HANDLER_CREATION((reactor_.context(), *p.p, "socket",
           &impl, impl.socket_, "async_accept"));
 
-    start_accept_op(impl, p.p, is_continuation, false);
+    assign_cancellation_slot(slot, impl, reactor::read_op, p.p);
+    reactor_op* o = p.p;
     p.v = p.p = 0;
+    start_accept_op(impl, o, is_continuation, false);
+  }
+
+  // Start an asynchronous accept of a batch of connections. The balancer is
+  // called from the operation's completion, on a thread running this
+  // service's io_context, to choose the io_context for each new socket.
+  template <typename Balancer, typename Handler>
+  void async_accept_many(implementation_type& impl,
+      std::size_t max_sockets, Balancer& balancer, Handler& handler)
+  {
+    bool is_continuation =
+      networking_ts_handler_cont_helpers::is_continuation(handler);
+
+    typename associated_cancellation_slot<Handler>::type slot =
+      std::experimental::net::v1::get_associated_cancellation_slot(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef reactive_socket_accept_many_op<Protocol, Balancer, Handler> op;
+    typename op::ptr p = { std::experimental::net::v1::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(impl.socket_, impl.state_, impl.protocol_,
+        max_sockets, balancer, handler);
+
+    NET_TS_HANDLER_CREATION((reactor_.context(), *p.p, "socket",
+          &impl, impl.socket_, "async_accept_many"));
+
+    assign_cancellation_slot(slot, impl, reactor::read_op, p.p);
+    reactor_op* o = p.p;
+    p.v = p.p = 0;
+    start_accept_op(impl, o, is_continuation, false);
   }
 #endif // defined(NET_TS_HAS_MOVE)
 
@@ -504,6 +579,9 @@ public:
     bool is_continuation =
       networking_ts_handler_cont_helpers::is_continuation(handler);
 
+    typename associated_cancellation_slot<Handler>::type slot =
+      std::experimental::net::v1::get_associated_cancellation_slot(handler);
+
     // Allocate and construct an operation to wrap the handler.
     typedef reactive_socket_connect_op<Handler> op;
     typename op::ptr p = { std::experimental::net::v1::detail::addressof(handler),
@@ -513,9 +591,11 @@ public:
     NET_TS_HANDLER_CREATION((reactor_.context(), *p.p, "socket",
           &impl, impl.socket_, "async_connect"));
 
-    start_connect_op(impl, p.p, is_continuation,
-        peer_endpoint.data(), peer_endpoint.size());
+    assign_cancellation_slot(slot, impl, reactor::connect_op, p.p);
+    reactor_op* o = p.p;
     p.v = p.p = 0;
+    start_connect_op(impl, o, is_continuation,
+        peer_endpoint.data(), peer_endpoint.size());
   }
 };
 
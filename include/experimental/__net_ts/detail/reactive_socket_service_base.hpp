@@ -20,6 +20,7 @@
 #if !defined(NET_TS_HAS_IOCP) \
   && !defined(NET_TS_WINDOWS_RUNTIME)
 
+#include <experimental/__net_ts/associated_cancellation_slot.hpp>
 #include <experimental/__net_ts/buffer.hpp>
 #include <experimental/__net_ts/error.hpp>
 #include <experimental/__net_ts/io_context.hpp>
@@ -106,10 +107,31 @@ public:
     return impl.socket_;
   }
 
+  // Move an open socket to another service, which may belong to a different
+  // io_context. Any pending operations are cancelled.
+  NET_TS_DECL std::error_code migrate(base_implementation_type& impl,
+      reactive_socket_service_base& target_service,
+      base_implementation_type& target_impl, std::error_code& ec);
+
   // Cancel all operations associated with the socket.
   NET_TS_DECL std::error_code cancel(
       base_implementation_type& impl, std::error_code& ec);
 
+  // Set whether readiness of the socket wakes only one of the io_contexts
+  // waiting on the same open socket.
+  NET_TS_DECL std::error_code set_exclusive_wakeup(
+      base_implementation_type& impl, bool enable, std::error_code& ec);
+
+  // Set the timeout, in microseconds, after which an operation on the socket
+  // that is waiting for readiness fails with the timed_out error. A timeout of
+  // 0 disables it.
+  NET_TS_DECL std::error_code set_operation_timeout(
+      base_implementation_type& impl, uint64_t usec, std::error_code& ec);
+
+  // Get the timeout, in microseconds, for operations on the socket.
+  NET_TS_DECL uint64_t operation_timeout(
+      const base_implementation_type& impl) const;
+
   // Determine whether the socket is at the out-of-band data mark.
   bool at_mark(const base_implementation_type& impl,
       std::error_code& ec) const
@@ -156,6 +178,26 @@ public:
     return ec;
   }
 
+  // Gets whether operations that complete immediately invoke their handlers
+  // inline.
+  bool inline_completion(const base_implementation_type& impl) const
+  {
+    return (impl.state_ & socket_ops::inline_completion) != 0;
+  }
+
+  // Sets whether operations that complete immediately invoke their handlers
+  // inline.
+  std::error_code inline_completion(base_implementation_type& impl,
+      bool mode, std::error_code& ec)
+  {
+    if (mode)
+      impl.state_ |= socket_ops::inline_completion;
+    else
+      impl.state_ &= ~socket_ops::inline_completion;
+    ec = std::error_code();
+    return ec;
+  }
+
   // Gets the non-blocking mode of the native socket implementation.
   bool native_non_blocking(const base_implementation_type& impl) const
   {
@@ -203,6 +245,9 @@ public:
     bool is_continuation =
       networking_ts_handler_cont_helpers::is_continuation(handler);
 
+    typename associated_cancellation_slot<Handler>::type slot =
+      std::experimental::net::v1::get_associated_cancellation_slot(handler);
+
     // Allocate and construct an operation to wrap the handler.
     typedef reactive_wait_op<Handler> op;
     typename op::ptr p = { std::experimental::net::v1::detail::addressof(handler),
@@ -231,8 +276,10 @@ public:
         return;
     }
 
-    start_op(impl, op_type, p.p, is_continuation, false, false);
+    assign_cancellation_slot(slot, impl, op_type, p.p);
+    reactor_op* o = p.p;
     p.v = p.p = 0;
+    start_op(impl, op_type, o, is_continuation, false, false);
   }
 
   // Send the given data to the peer.
@@ -268,6 +315,9 @@ public:
     bool is_continuation =
       networking_ts_handler_cont_helpers::is_continuation(handler);
 
+    typename associated_cancellation_slot<Handler>::type slot =
+      std::experimental::net::v1::get_associated_cancellation_slot(handler);
+
     // Allocate and construct an operation to wrap the handler.
     typedef reactive_socket_send_op<ConstBufferSequence, Handler> op;
     typename op::ptr p = { std::experimental::net::v1::detail::addressof(handler),
@@ -277,11 +327,13 @@ public:
     NET_TS_HANDLER_CREATION((reactor_.context(), *p.p, "socket",
           &impl, impl.socket_, "async_send"));
 
-    start_op(impl, reactor::write_op, p.p, is_continuation, true,
+    assign_cancellation_slot(slot, impl, reactor::write_op, p.p);
+    reactor_op* o = p.p;
+    p.v = p.p = 0;
+    start_op(impl, reactor::write_op, o, is_continuation, true,
         ((impl.state_ & socket_ops::stream_oriented)
           && buffer_sequence_adapter<std::experimental::net::v1::const_buffer,
             ConstBufferSequence>::all_empty(buffers)));
-    p.v = p.p = 0;
   }
 
   // Start an asynchronous wait until data can be sent without blocking.
@@ -292,6 +344,9 @@ public:
     bool is_continuation =
       networking_ts_handler_cont_helpers::is_continuation(handler);
 
+    typename associated_cancellation_slot<Handler>::type slot =
+      std::experimental::net::v1::get_associated_cancellation_slot(handler);
+
     // Allocate and construct an operation to wrap the handler.
     typedef reactive_null_buffers_op<Handler> op;
     typename op::ptr p = { std::experimental::net::v1::detail::addressof(handler),
@@ -301,8 +356,10 @@ public:
     NET_TS_HANDLER_CREATION((reactor_.context(), *p.p, "socket",
           &impl, impl.socket_, "async_send(null_buffers)"));
 
-    start_op(impl, reactor::write_op, p.p, is_continuation, false, false);
+    assign_cancellation_slot(slot, impl, reactor::write_op, p.p);
+    reactor_op* o = p.p;
     p.v = p.p = 0;
+    start_op(impl, reactor::write_op, o, is_continuation, false, false);
   }
 
   // Receive some data from the peer. Returns the number of bytes received.
@@ -338,6 +395,9 @@ public:
     bool is_continuation =
       networking_ts_handler_cont_helpers::is_continuation(handler);
 
+    typename associated_cancellation_slot<Handler>::type slot =
+      std::experimental::net::v1::get_associated_cancellation_slot(handler);
+
     // Allocate and construct an operation to wrap the handler.
     typedef reactive_socket_recv_op<MutableBufferSequence, Handler> op;
     typename op::ptr p = { std::experimental::net::v1::detail::addressof(handler),
@@ -347,15 +407,19 @@ public:
     NET_TS_HANDLER_CREATION((reactor_.context(), *p.p, "socket",
           &impl, impl.socket_, "async_receive"));
 
+    assign_cancellation_slot(slot, impl,
+        (flags & socket_base::message_out_of_band)
+          ? reactor::except_op : reactor::read_op, p.p);
+    reactor_op* o = p.p;
+    p.v = p.p = 0;
     start_op(impl,
         (flags & socket_base::message_out_of_band)
           ? reactor::except_op : reactor::read_op,
-        p.p, is_continuation,
+        o, is_continuation,
         (flags & socket_base::message_out_of_band) == 0,
         ((impl.state_ & socket_ops::stream_oriented)
           && buffer_sequence_adapter<std::experimental::net::v1::mutable_buffer,
             MutableBufferSequence>::all_empty(buffers)));
-    p.v = p.p = 0;
   }
 
   // Wait until data can be received without blocking.
@@ -366,6 +430,9 @@ public:
     bool is_continuation =
       networking_ts_handler_cont_helpers::is_continuation(handler);
 
+    typename associated_cancellation_slot<Handler>::type slot =
+      std::experimental::net::v1::get_associated_cancellation_slot(handler);
+
     // Allocate and construct an operation to wrap the handler.
     typedef reactive_null_buffers_op<Handler> op;
     typename op::ptr p = { std::experimental::net::v1::detail::addressof(handler),
@@ -375,11 +442,15 @@ public:
     NET_TS_HANDLER_CREATION((reactor_.context(), *p.p, "socket",
           &impl, impl.socket_, "async_receive(null_buffers)"));
 
+    assign_cancellation_slot(slot, impl,
+        (flags & socket_base::message_out_of_band)
+          ? reactor::except_op : reactor::read_op, p.p);
+    reactor_op* o = p.p;
+    p.v = p.p = 0;
     start_op(impl,
         (flags & socket_base::message_out_of_band)
           ? reactor::except_op : reactor::read_op,
-        p.p, is_continuation, false, false);
-    p.v = p.p = 0;
+        o, is_continuation, false, false);
   }
 
   // Receive some data with associated flags. Returns the number of bytes
@@ -422,6 +493,9 @@ public:
     bool is_continuation =
       networking_ts_handler_cont_helpers::is_continuation(handler);
 
+    typename associated_cancellation_slot<Handler>::type slot =
+      std::experimental::net::v1::get_associated_cancellation_slot(handler);
+
     // Allocate and construct an operation to wrap the handler.
     typedef reactive_socket_recvmsg_op<MutableBufferSequence, Handler> op;
     typename op::ptr p = { std::experimental::net::v1::detail::addressof(handler),
@@ -431,12 +505,16 @@ public:
     NET_TS_HANDLER_CREATION((reactor_.context(), *p.p, "socket",
           &impl, impl.socket_, "async_receive_with_flags"));
 
+    assign_cancellation_slot(slot, impl,
+        (in_flags & socket_base::message_out_of_band)
+          ? reactor::except_op : reactor::read_op, p.p);
+    reactor_op* o = p.p;
+    p.v = p.p = 0;
     start_op(impl,
         (in_flags & socket_base::message_out_of_band)
           ? reactor::except_op : reactor::read_op,
-        p.p, is_continuation,
+        o, is_continuation,
         (in_flags & socket_base::message_out_of_band) == 0, false);
-    p.v = p.p = 0;
   }
 
   // Wait until data can be received without blocking.
@@ -448,6 +526,9 @@ public:
     bool is_continuation =
       networking_ts_handler_cont_helpers::is_continuation(handler);
 
+    typename associated_cancellation_slot<Handler>::type slot =
+      std::experimental::net::v1::get_associated_cancellation_slot(handler);
+
     // Allocate and construct an operation to wrap the handler.
     typedef reactive_null_buffers_op<Handler> op;
     typename op::ptr p = { std::experimental::net::v1::detail::addressof(handler),
@@ -461,14 +542,60 @@ public:
     // performing a null_buffers operation.
     out_flags = 0;
 
+    assign_cancellation_slot(slot, impl,
+        (in_flags & socket_base::message_out_of_band)
+          ? reactor::except_op : reactor::read_op, p.p);
+    reactor_op* o = p.p;
+    p.v = p.p = 0;
     start_op(impl,
         (in_flags & socket_base::message_out_of_band)
           ? reactor::except_op : reactor::read_op,
-        p.p, is_continuation, false, false);
-    p.v = p.p = 0;
+        o, is_continuation, false, false);
   }
 
 protected:
+  // Cancellation handler that cancels a single operation on the socket.
+  class reactor_op_cancellation
+  {
+  public:
+    reactor_op_cancellation(reactor* r,
+        const reactor::per_descriptor_data& reactor_data,
+        socket_type descriptor, int op_type)
+      : reactor_(r),
+        reactor_data_(reactor_data),
+        descriptor_(descriptor),
+        op_type_(op_type)
+    {
+    }
+
+    void operator()()
+    {
+      reactor_->cancel_ops_by_key(descriptor_,
+          reactor_data_, op_type_, this);
+    }
+
+  private:
+    reactor* reactor_;
+    reactor::per_descriptor_data reactor_data_;
+    socket_type descriptor_;
+    int op_type_;
+  };
+
+  // Install a handler in a connected cancellation slot so that emitting the
+  // slot's signal cancels the operation without affecting other operations on
+  // the socket. The address of the installed handler is the key that
+  // identifies the operation to the reactor.
+  template <typename CancellationSlot>
+  void assign_cancellation_slot(CancellationSlot& slot,
+      base_implementation_type& impl, int op_type, reactor_op* op)
+  {
+    if (slot.is_connected())
+    {
+      op->cancellation_key_ = &slot.template emplace<reactor_op_cancellation>(
+          &reactor_, impl.reactor_data_, impl.socket_, op_type);
+    }
+  }
+
   // Open a new socket implementation.
   NET_TS_DECL std::error_code do_open(
       base_implementation_type& impl, int af,
@@ -479,7 +606,9 @@ protected:
       base_implementation_type& impl, int type,
       const native_handle_type& native_socket, std::error_code& ec);
 
-  // Start the asynchronous read or write operation.
+  // Start the asynchronous read or write operation. The operation may be
+  // completed and destroyed, and its handler invoked, before this function
+  // returns, so the caller must give up ownership of the operation first.
   NET_TS_DECL void start_op(base_implementation_type& impl, int op_type,
       reactor_op* op, bool is_continuation, bool is_non_blocking, bool noop);
 
@@ -16,6 +16,8 @@
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
 #include <experimental/__net_ts/detail/config.hpp>
+#include <experimental/__net_ts/associated_cancellation_slot.hpp>
+#include <experimental/__net_ts/detail/cstdint.hpp>
 #include <experimental/__net_ts/detail/operation.hpp>
 
 #include <experimental/__net_ts/detail/push_options.hpp>
@@ -36,6 +38,16 @@ public:
   // The number of bytes transferred, to be passed to the completion handler.
   std::size_t bytes_transferred_;
 
+  // The time, in microseconds of the reactor's monotonic clock, at which the
+  // operation times out while it is waiting for readiness, or 0 if it has no
+  // deadline. Set by reactors that support operation timeouts.
+  uint64_t deadline_;
+
+  // The key used to cancel the operation individually, or 0 if it is not
+  // bound to a cancellation slot. Reactors that support per-operation
+  // cancellation match this against the key passed to cancel_ops_by_key().
+  void* cancellation_key_;
+
   // Status returned by perform function. May be used to decide whether it is
   // worth performing more operations on the descriptor immediately.
   enum status { not_done, done, done_and_exhausted };
@@ -52,10 +64,25 @@ protected:
   reactor_op(perform_func_type perform_func, func_type complete_func)
     : operation(complete_func),
       bytes_transferred_(0),
+      deadline_(0),
+      cancellation_key_(0),
       perform_func_(perform_func)
   {
   }
 
+  // Remove the cancellation handler installed for the operation, if any, so
+  // that a later emit does not reach a descriptor the operation no longer
+  // refers to. Called before the operation is completed or destroyed.
+  template <typename Handler>
+  void clear_cancellation_slot(Handler& handler)
+  {
+    if (cancellation_key_)
+    {
+      (get_associated_cancellation_slot)(handler).clear();
+      cancellation_key_ = 0;
+    }
+  }
+
 private:
   perform_func_type perform_func_;
 };
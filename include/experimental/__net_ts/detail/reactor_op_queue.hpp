@@ -103,6 +103,41 @@ public:
     return this->cancel_operations(operations_.find(descriptor), ops, ec);
   }
 
+  // Cancel the operation associated with the descriptor that has the given
+  // cancellation key. Other operations pending for the descriptor are not
+  // affected. Returns true if an operation was cancelled, in which case the
+  // reactor's event demultiplexing function may need to be interrupted and
+  // restarted.
+  bool cancel_operations_by_key(Descriptor descriptor,
+      op_queue<operation>& ops, void* cancellation_key,
+      const std::error_code& ec =
+        std::experimental::net::v1::error::operation_aborted)
+  {
+    iterator i = operations_.find(descriptor);
+    if (i == operations_.end())
+      return false;
+
+    bool cancelled = false;
+    op_queue<reactor_op> other_ops;
+    while (reactor_op* op = i->second.front())
+    {
+      i->second.pop();
+      if (op->cancellation_key_ == cancellation_key)
+      {
+        op->ec_ = ec;
+        ops.push(op);
+        cancelled = true;
+      }
+      else
+        other_ops.push(op);
+    }
+    i->second.push(other_ops);
+
+    if (i->second.empty())
+      operations_.erase(i);
+    return cancelled;
+  }
+
   // Whether there are no operations in the queue.
   bool empty() const
   {
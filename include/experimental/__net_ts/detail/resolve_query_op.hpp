@@ -25,7 +25,8 @@
 #include <experimental/__net_ts/detail/handler_alloc_helpers.hpp>
 #include <experimental/__net_ts/detail/handler_invoke_helpers.hpp>
 #include <experimental/__net_ts/detail/memory.hpp>
-#include <experimental/__net_ts/detail/resolve_op.hpp>
+#include <experimental/__net_ts/detail/op_queue.hpp>
+#include <experimental/__net_ts/detail/resolver_cache.hpp>
 #include <experimental/__net_ts/detail/socket_ops.hpp>
 
 #include <experimental/__net_ts/detail/push_options.hpp>
@@ -37,7 +38,7 @@ inline namespace v1 {
 namespace detail {
 
 template <typename Protocol, typename Handler>
-class resolve_query_op : public resolve_op
+class resolve_query_op : public resolver_cache<Protocol>::op
 {
 public:
   NET_TS_DEFINE_HANDLER_PTR(resolve_query_op);
@@ -46,10 +47,12 @@ public:
   typedef std::experimental::net::v1::ip::basic_resolver_results<Protocol> results_type;
 
   resolve_query_op(socket_ops::weak_cancel_token_type cancel_token,
-      const query_type& query, io_context_impl& ioc, Handler& handler)
-    : resolve_op(&resolve_query_op::do_complete),
-      cancel_token_(cancel_token),
+      const query_type& query, resolver_cache<Protocol>& cache,
+      io_context_impl& ioc, Handler& handler)
+    : resolver_cache<Protocol>::op(&resolve_query_op::do_complete,
+        cancel_token),
       query_(query),
+      cache_(cache),
       io_context_impl_(ioc),
       handler_(NET_TS_MOVE_CAST(Handler)(handler)),
       addrinfo_(0)
@@ -74,12 +77,38 @@ public:
     if (owner && owner != &o->io_context_impl_)
     {
       // The operation is being run on the worker io_context. Time to perform
-      // the resolver operation.
-    
-      // Perform the blocking host resolution operation.
-      socket_ops::background_getaddrinfo(o->cancel_token_,
-          o->query_.host_name().c_str(), o->query_.service_name().c_str(),
-          o->query_.hints(), &o->addrinfo_, o->ec_);
+      // the resolver operation, unless it has been cancelled and there are no
+      // other operations waiting on its result.
+      bool cancelled = o->cancel_token_.expired();
+      if (cancelled && o->cache_.abandon(o->query_))
+      {
+        o->ec_ = std::experimental::net::v1::error::operation_aborted;
+      }
+      else
+      {
+        // Perform the blocking host resolution operation.
+        socket_ops::getaddrinfo(o->query_.host_name().c_str(),
+            o->query_.service_name().c_str(), o->query_.hints(),
+            &o->addrinfo_, o->ec_);
+        if (o->addrinfo_)
+        {
+          o->results_ = results_type::create(o->addrinfo_,
+              o->query_.host_name(), o->query_.service_name());
+          socket_ops::freeaddrinfo(o->addrinfo_);
+          o->addrinfo_ = 0;
+        }
+
+        // Pass the result to any operations that joined this lookup.
+        op_queue<operation> ops;
+        o->cache_.complete(o->query_, o->ec_, o->results_, ops);
+        o->io_context_impl_.post_deferred_completions(ops);
+
+        if (cancelled)
+        {
+          o->ec_ = std::experimental::net::v1::error::operation_aborted;
+          o->results_ = results_type();
+        }
+      }
 
       // Pass operation back to main io_context for completion.
       o->io_context_impl_.post_deferred_completion(o);
@@ -102,13 +131,8 @@ public:
       // is required to ensure that any owning sub-object remains valid until
       // after we have deallocated the memory here.
       detail::binder2<Handler, std::error_code, results_type>
-        handler(o->handler_, o->ec_, results_type());
+        handler(o->handler_, o->ec_, o->results_);
       p.h = std::experimental::net::v1::detail::addressof(handler.handler_);
-      if (o->addrinfo_)
-      {
-        handler.arg2_ = results_type::create(o->addrinfo_,
-            o->query_.host_name(), o->query_.service_name());
-      }
       p.reset();
 
       if (owner)
@@ -122,8 +146,8 @@ public:
   }
 
 private:
-  socket_ops::weak_cancel_token_type cancel_token_;
   query_type query_;
+  resolver_cache<Protocol>& cache_;
   io_context_impl& io_context_impl_;
   Handler handler_;
   std::experimental::net::v1::detail::addrinfo_type* addrinfo_;
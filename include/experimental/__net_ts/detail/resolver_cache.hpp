@@ -0,0 +1,392 @@
+//
+// detail/resolver_cache.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_RESOLVER_CACHE_HPP
+#define NET_TS_DETAIL_RESOLVER_CACHE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <experimental/__net_ts/error.hpp>
+#include <experimental/__net_ts/ip/basic_resolver_query.hpp>
+#include <experimental/__net_ts/ip/basic_resolver_results.hpp>
+#include <experimental/__net_ts/ip/detail/resolver_option.hpp>
+#include <experimental/__net_ts/detail/mutex.hpp>
+#include <experimental/__net_ts/detail/noncopyable.hpp>
+#include <experimental/__net_ts/detail/op_queue.hpp>
+#include <experimental/__net_ts/detail/resolve_op.hpp>
+#include <experimental/__net_ts/detail/socket_ops.hpp>
+
+#if defined(NET_TS_HAS_CHRONO)
+# include <experimental/__net_ts/detail/chrono.hpp>
+#endif // defined(NET_TS_HAS_CHRONO)
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+// Holds the results of recent forward lookups, and the set of lookups that are
+// currently being performed, so that identical queries may share a result.
+template <typename Protocol>
+class resolver_cache
+  : private noncopyable
+{
+public:
+  // The query type.
+  typedef std::experimental::net::v1::ip::basic_resolver_query<Protocol> query_type;
+
+  // The results type.
+  typedef std::experimental::net::v1::ip::basic_resolver_results<Protocol> results_type;
+
+  // Base class for forward resolution operations.
+  class op : public resolve_op
+  {
+  public:
+    // The results to be passed to the completion handler.
+    results_type results_;
+
+    // Token used to determine whether the operation has been cancelled.
+    socket_ops::weak_cancel_token_type cancel_token_;
+
+  protected:
+    op(func_type complete_func,
+        const socket_ops::weak_cancel_token_type& cancel_token)
+      : resolve_op(complete_func),
+        cancel_token_(cancel_token)
+    {
+    }
+  };
+
+  // Constructor.
+  resolver_cache()
+    : ttl_(0),
+      negative_ttl_(0),
+      max_entries_(default_max_entries)
+  {
+  }
+
+  // Destructor.
+  ~resolver_cache()
+  {
+    shutdown();
+  }
+
+  // Destroy all operations that are waiting on another lookup.
+  void shutdown()
+  {
+    op_queue<operation> ops;
+
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    for (typename pending_map::iterator i = pending_.begin();
+        i != pending_.end(); ++i)
+    {
+      ops.push(i->second->waiters_);
+      delete i->second;
+    }
+    pending_.clear();
+#if defined(NET_TS_HAS_CHRONO)
+    cache_.clear();
+#endif // defined(NET_TS_HAS_CHRONO)
+  }
+
+  // Determine whether the named option is handled by the cache.
+  static bool is_cache_option(int name)
+  {
+    namespace opt = std::experimental::net::v1::ip::detail::resolver_option;
+    return name == opt::cache_ttl_name
+      || name == opt::negative_cache_ttl_name
+      || name == opt::cache_max_entries_name;
+  }
+
+  // Set a cache option.
+  std::error_code set_option(int name, int value, std::error_code& ec)
+  {
+    namespace opt = std::experimental::net::v1::ip::detail::resolver_option;
+    if (!is_cache_option(name) || value < 0)
+    {
+      ec = std::experimental::net::v1::error::invalid_argument;
+      return ec;
+    }
+
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    switch (name)
+    {
+    case opt::cache_ttl_name: ttl_ = value; break;
+    case opt::negative_cache_ttl_name: negative_ttl_ = value; break;
+    default: max_entries_ = static_cast<std::size_t>(value); break;
+    }
+#if defined(NET_TS_HAS_CHRONO)
+    if (ttl_ == 0 && negative_ttl_ == 0)
+      cache_.clear();
+#endif // defined(NET_TS_HAS_CHRONO)
+    ec = std::error_code();
+    return ec;
+  }
+
+  // Get a cache option.
+  std::error_code get_option(int name, int& value, std::error_code& ec) const
+  {
+    namespace opt = std::experimental::net::v1::ip::detail::resolver_option;
+    if (!is_cache_option(name))
+    {
+      ec = std::experimental::net::v1::error::invalid_argument;
+      return ec;
+    }
+
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    switch (name)
+    {
+    case opt::cache_ttl_name: value = ttl_; break;
+    case opt::negative_cache_ttl_name: value = negative_ttl_; break;
+    default: value = static_cast<int>(max_entries_); break;
+    }
+    ec = std::error_code();
+    return ec;
+  }
+
+  // Look up a cached result for the query. Returns true if one was found.
+  bool lookup(const query_type& query,
+      results_type& results, std::error_code& ec)
+  {
+#if defined(NET_TS_HAS_CHRONO)
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    if (cache_.empty())
+      return false;
+
+    typename cache_map::iterator i = cache_.find(key(query));
+    if (i == cache_.end())
+      return false;
+
+    if (i->second.expiry_ <= clock_type::now())
+    {
+      cache_.erase(i);
+      return false;
+    }
+
+    results = i->second.results_;
+    ec = i->second.ec_;
+    return true;
+#else // defined(NET_TS_HAS_CHRONO)
+    (void)query;
+    (void)results;
+    (void)ec;
+    return false;
+#endif // defined(NET_TS_HAS_CHRONO)
+  }
+
+  // Record the result of a lookup, if caching is enabled for it.
+  void insert(const query_type& query,
+      const std::error_code& ec, const results_type& results)
+  {
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    do_insert(key(query), ec, results);
+  }
+
+  // Join a lookup that is already in progress for an identical query. If
+  // there is no such lookup, the caller becomes responsible for performing it
+  // and false is returned.
+  bool join(const query_type& query, op* o)
+  {
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    typename pending_map::iterator i = pending_.find(key(query));
+    if (i != pending_.end())
+    {
+      i->second->waiters_.push(o);
+      return true;
+    }
+
+    pending_lookup* p = new pending_lookup;
+    pending_.insert(typename pending_map::value_type(key(query), p));
+    return false;
+  }
+
+  // Abandon a lookup that is no longer required by the caller. Returns false,
+  // leaving the lookup in progress, if other operations are waiting on it.
+  bool abandon(const query_type& query)
+  {
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    typename pending_map::iterator i = pending_.find(key(query));
+    if (i == pending_.end())
+      return true;
+    if (!i->second->waiters_.empty())
+      return false;
+    delete i->second;
+    pending_.erase(i);
+    return true;
+  }
+
+  // Complete a lookup, caching the result as appropriate and passing it to
+  // all operations that were waiting on it.
+  void complete(const query_type& query, const std::error_code& ec,
+      const results_type& results, op_queue<operation>& ops)
+  {
+    key_type k(key(query));
+
+    std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+    do_insert(k, ec, results);
+
+    typename pending_map::iterator i = pending_.find(k);
+    if (i == pending_.end())
+      return;
+
+    while (op* o = static_cast<op*>(i->second->waiters_.front()))
+    {
+      i->second->waiters_.pop();
+      if (o->cancel_token_.expired())
+        o->ec_ = std::experimental::net::v1::error::operation_aborted;
+      else
+      {
+        o->ec_ = ec;
+        o->results_ = results;
+      }
+      ops.push(o);
+    }
+
+    delete i->second;
+    pending_.erase(i);
+  }
+
+private:
+  // The key used to identify identical queries.
+  struct key_type
+  {
+    std::string host_name_;
+    std::string service_name_;
+    int flags_;
+    int family_;
+    int socktype_;
+    int protocol_;
+
+    friend bool operator<(const key_type& a, const key_type& b)
+    {
+      if (a.flags_ != b.flags_) return a.flags_ < b.flags_;
+      if (a.family_ != b.family_) return a.family_ < b.family_;
+      if (a.socktype_ != b.socktype_) return a.socktype_ < b.socktype_;
+      if (a.protocol_ != b.protocol_) return a.protocol_ < b.protocol_;
+      if (a.service_name_ != b.service_name_)
+        return a.service_name_ < b.service_name_;
+      return a.host_name_ < b.host_name_;
+    }
+  };
+
+  // Build the key for a query.
+  static key_type key(const query_type& query)
+  {
+    key_type k;
+    k.host_name_ = query.host_name();
+    k.service_name_ = query.service_name();
+    k.flags_ = query.hints().ai_flags;
+    k.family_ = query.hints().ai_family;
+    k.socktype_ = query.hints().ai_socktype;
+    k.protocol_ = query.hints().ai_protocol;
+    return k;
+  }
+
+  // Insert an entry into the cache. The mutex must be held by the caller.
+  void do_insert(const key_type& k,
+      const std::error_code& ec, const results_type& results)
+  {
+#if defined(NET_TS_HAS_CHRONO)
+    if (ec == std::experimental::net::v1::error::operation_aborted)
+      return;
+
+    int ttl = ec ? negative_ttl_ : ttl_;
+    if (ttl == 0)
+      return;
+
+    typename clock_type::time_point now = clock_type::now();
+    if (cache_.size() >= max_entries_)
+    {
+      typename cache_map::iterator i = cache_.begin();
+      while (i != cache_.end())
+      {
+        if (i->second.expiry_ <= now)
+          cache_.erase(i++);
+        else
+          ++i;
+      }
+
+      if (cache_.size() >= max_entries_)
+        return;
+    }
+
+    cache_entry& entry = cache_[k];
+    entry.results_ = results;
+    entry.ec_ = ec;
+    entry.expiry_ = now + chrono::seconds(ttl);
+#else // defined(NET_TS_HAS_CHRONO)
+    (void)k;
+    (void)ec;
+    (void)results;
+#endif // defined(NET_TS_HAS_CHRONO)
+  }
+
+  // The default limit on the number of cached entries.
+  enum { default_max_entries = 1024 };
+
+#if defined(NET_TS_HAS_CHRONO)
+  // The clock used to expire cache entries.
+  typedef chrono::steady_clock clock_type;
+
+  // A cached lookup result.
+  struct cache_entry
+  {
+    results_type results_;
+    std::error_code ec_;
+    typename clock_type::time_point expiry_;
+  };
+
+  // The cached lookup results.
+  typedef std::map<key_type, cache_entry> cache_map;
+  cache_map cache_;
+#endif // defined(NET_TS_HAS_CHRONO)
+
+  // A lookup that is in progress.
+  struct pending_lookup
+  {
+    // The operations waiting on the result of the lookup.
+    op_queue<operation> waiters_;
+  };
+
+  // The lookups that are in progress.
+  typedef std::map<key_type, pending_lookup*> pending_map;
+  pending_map pending_;
+
+  // Mutex to protect access to internal data.
+  mutable std::experimental::net::v1::detail::mutex mutex_;
+
+  // The number of seconds for which successful lookups are cached.
+  int ttl_;
+
+  // The number of seconds for which failed lookups are cached.
+  int negative_ttl_;
+
+  // The maximum number of cached entries.
+  std::size_t max_entries_;
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_DETAIL_RESOLVER_CACHE_HPP
@@ -25,6 +25,7 @@
 #include <experimental/__net_ts/detail/memory.hpp>
 #include <experimental/__net_ts/detail/resolve_endpoint_op.hpp>
 #include <experimental/__net_ts/detail/resolve_query_op.hpp>
+#include <experimental/__net_ts/detail/resolver_cache.hpp>
 #include <experimental/__net_ts/detail/resolver_service_base.hpp>
 
 #include <experimental/__net_ts/detail/push_options.hpp>
@@ -65,6 +66,7 @@ public:
   void shutdown()
   {
     this->base_shutdown();
+    cache_.shutdown();
   }
 
   // Perform any fork-related housekeeping.
@@ -73,18 +75,49 @@ public:
     this->base_notify_fork(fork_ev);
   }
 
+  // Set a resolver option.
+  template <typename Option>
+  std::error_code set_option(implementation_type&,
+      const Option& option, std::error_code& ec)
+  {
+    if (resolver_cache<Protocol>::is_cache_option(option.name()))
+      return cache_.set_option(option.name(), option.value(), ec);
+    return resolver_service_base::set_option(
+        option.name(), option.value(), ec);
+  }
+
+  // Get a resolver option.
+  template <typename Option>
+  std::error_code get_option(const implementation_type&,
+      Option& option, std::error_code& ec) const
+  {
+    if (resolver_cache<Protocol>::is_cache_option(option.name()))
+      return cache_.get_option(option.name(), option.data(), ec);
+    return resolver_service_base::get_option(
+        option.name(), option.data(), ec);
+  }
+
   // Resolve a query to a list of entries.
   results_type resolve(implementation_type&, const query_type& query,
       std::error_code& ec)
   {
+    results_type results;
+    if (cache_.lookup(query, results, ec))
+      return results;
+
     std::experimental::net::v1::detail::addrinfo_type* address_info = 0;
 
     socket_ops::getaddrinfo(query.host_name().c_str(),
         query.service_name().c_str(), query.hints(), &address_info, ec);
     auto_addrinfo auto_address_info(address_info);
 
-    return ec ? results_type() : results_type::create(
-        address_info, query.host_name(), query.service_name());
+    if (!ec)
+    {
+      results = results_type::create(
+          address_info, query.host_name(), query.service_name());
+    }
+    cache_.insert(query, ec, results);
+    return results;
   }
 
   // Asynchronously resolve a query to a list of entries.
@@ -96,12 +129,19 @@ public:
     typedef resolve_query_op<Protocol, Handler> op;
     typename op::ptr p = { std::experimental::net::v1::detail::addressof(handler),
       op::ptr::allocate(handler), 0 };
-    p.p = new (p.v) op(impl, query, io_context_impl_, handler);
+    p.p = new (p.v) op(impl, query, cache_, io_context_impl_, handler);
 
     NET_TS_HANDLER_CREATION((io_context_impl_.context(),
           *p.p, "resolver", &impl, 0, "async_resolve"));
 
-    start_resolve_op(p.p);
+    // Complete immediately from the cache if possible, otherwise share the
+    // result of an identical lookup that is already in progress.
+    if (cache_.lookup(query, p.p->results_, p.p->ec_))
+      io_context_impl_.post_immediate_completion(p.p, false);
+    else if (!can_resolve_in_background() || !cache_.join(query, p.p))
+      start_resolve_op(p.p);
+    else
+      io_context_impl_.work_started();
     p.v = p.p = 0;
   }
 
@@ -136,6 +176,10 @@ public:
     start_resolve_op(p.p);
     p.v = p.p = 0;
   }
+
+private:
+  // Cached results and in-progress lookups for forward resolution.
+  resolver_cache<Protocol> cache_;
 };
 
 } // namespace detail
@@ -19,13 +19,14 @@
 #include <experimental/__net_ts/error.hpp>
 #include <experimental/__net_ts/executor_work_guard.hpp>
 #include <experimental/__net_ts/io_context.hpp>
+#include <experimental/__net_ts/detail/concurrency_hint.hpp>
 #include <experimental/__net_ts/detail/mutex.hpp>
 #include <experimental/__net_ts/detail/noncopyable.hpp>
 #include <experimental/__net_ts/detail/resolve_op.hpp>
 #include <experimental/__net_ts/detail/socket_ops.hpp>
 #include <experimental/__net_ts/detail/socket_types.hpp>
 #include <experimental/__net_ts/detail/scoped_ptr.hpp>
-#include <experimental/__net_ts/detail/thread.hpp>
+#include <experimental/__net_ts/detail/thread_group.hpp>
 
 #include <experimental/__net_ts/detail/push_options.hpp>
 
@@ -73,7 +74,22 @@ public:
   // Cancel pending asynchronous operations.
   NET_TS_DECL void cancel(implementation_type& impl);
 
+  // Set a resolver option.
+  NET_TS_DECL std::error_code set_option(
+      int name, int value, std::error_code& ec);
+
+  // Get a resolver option.
+  NET_TS_DECL std::error_code get_option(
+      int name, int& value, std::error_code& ec) const;
+
 protected:
+  // Determine whether operations can be performed by the work threads.
+  bool can_resolve_in_background() const
+  {
+    return NET_TS_CONCURRENCY_HINT_IS_LOCKING(SCHEDULER,
+        io_context_impl_.concurrency_hint());
+  }
+
   // Helper function to start an asynchronous resolve operation.
   NET_TS_DECL void start_resolve_op(resolve_op* op);
 
@@ -107,15 +123,15 @@ protected:
   // Helper class to run the work io_context in a thread.
   class work_io_context_runner;
 
-  // Start the work thread if it's not already running.
-  NET_TS_DECL void start_work_thread();
+  // Start the work threads if they're not already running.
+  NET_TS_DECL void start_work_threads();
 
   // The io_context implementation used to post completions.
   io_context_impl& io_context_impl_;
 
 private:
   // Mutex to protect access to internal data.
-  std::experimental::net::v1::detail::mutex mutex_;
+  mutable std::experimental::net::v1::detail::mutex mutex_;
 
   // Private io_context used for performing asynchronous host resolution.
   std::experimental::net::v1::detail::scoped_ptr<std::experimental::net::v1::io_context> work_io_context_;
@@ -127,8 +143,14 @@ private:
   std::experimental::net::v1::executor_work_guard<
       std::experimental::net::v1::io_context::executor_type> work_;
 
-  // Thread used for running the work io_context's run loop.
-  std::experimental::net::v1::detail::scoped_ptr<std::experimental::net::v1::detail::thread> work_thread_;
+  // Threads used for running the work io_context's run loop.
+  std::experimental::net::v1::detail::thread_group work_threads_;
+
+  // The number of threads that have been started in the work thread group.
+  std::size_t num_work_threads_;
+
+  // The number of threads to be used for running the work io_context.
+  std::size_t thread_pool_size_;
 };
 
 } // namespace detail
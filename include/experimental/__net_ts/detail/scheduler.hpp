@@ -22,9 +22,12 @@
 #include <experimental/__net_ts/detail/atomic_count.hpp>
 #include <experimental/__net_ts/detail/conditionally_enabled_event.hpp>
 #include <experimental/__net_ts/detail/conditionally_enabled_mutex.hpp>
+#include <experimental/__net_ts/detail/injection_ring.hpp>
 #include <experimental/__net_ts/detail/op_queue.hpp>
 #include <experimental/__net_ts/detail/reactor_fwd.hpp>
 #include <experimental/__net_ts/detail/scheduler_operation.hpp>
+#include <experimental/__net_ts/detail/spin_statistics.hpp>
+#include <experimental/__net_ts/detail/steady_time_cache.hpp>
 #include <experimental/__net_ts/detail/thread_context.hpp>
 
 #include <experimental/__net_ts/detail/push_options.hpp>
@@ -77,6 +80,13 @@ public:
   // Determine whether the scheduler is stopped.
   NET_TS_DECL bool stopped() const;
 
+  // Get the count of unfinished work.
+  std::size_t outstanding_work() const
+  {
+    long n = outstanding_work_;
+    return n > 0 ? static_cast<std::size_t>(n) : 0;
+  }
+
   // Restart in preparation for a subsequent run invocation.
   NET_TS_DECL void restart();
 
@@ -100,7 +110,18 @@ public:
   // Return whether a handler can be dispatched immediately.
   bool can_dispatch()
   {
-    return thread_call_stack::contains(this) != 0;
+    return running_thread_info() != 0;
+  }
+
+  // Get the calling thread's innermost thread information for this scheduler,
+  // or 0 if the calling thread is not running the scheduler.
+  thread_info_base* running_thread_info()
+  {
+#if defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+    return running_thread_;
+#else // defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+    return thread_call_stack::contains(this);
+#endif // defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
   }
 
   // Request invocation of the given operation and return immediately. Assumes
@@ -108,6 +129,35 @@ public:
   NET_TS_DECL void post_immediate_completion(
       operation* op, bool is_continuation);
 
+  // Invoke the given operation, which has completed immediately, before
+  // returning if inline completion is allowed by the caller or by the
+  // scheduler, the calling thread is running the scheduler, and the depth of
+  // nested inline completions is below the limit. Otherwise behaves as
+  // post_immediate_completion().
+  NET_TS_DECL void complete_immediately(operation* op,
+      bool is_continuation, bool allow_inline);
+
+  // Set whether all operations that complete immediately may be invoked
+  // inline. Must not be called while a thread is running the scheduler.
+  NET_TS_DECL void set_inline_completion(bool enable);
+
+  // Get whether all operations that complete immediately may be invoked
+  // inline.
+  NET_TS_DECL bool inline_completion() const;
+
+  // Set the maximum depth of nested inline completions on a thread. Must not
+  // be called while a thread is running the scheduler.
+  NET_TS_DECL void set_inline_completion_depth(std::size_t depth);
+
+  // Get the maximum depth of nested inline completions on a thread.
+  NET_TS_DECL std::size_t inline_completion_depth() const;
+
+  // Request invocation of the given operations and return immediately.
+  // Assumes that work_started() has not yet been called for the operations.
+  // At most one thread is woken.
+  NET_TS_DECL void post_immediate_completions(
+      op_queue<operation>& ops, std::size_t n);
+
   // Request invocation of the given operation and return immediately. Assumes
   // that work_started() was previously called for the operation.
   NET_TS_DECL void post_deferred_completion(operation* op);
@@ -116,6 +166,20 @@ public:
   // that work_started() was previously called for each operation.
   NET_TS_DECL void post_deferred_completions(op_queue<operation>& ops);
 
+  // Register a ring through which a single producer thread may post
+  // operations without locking. The ring counts as outstanding work until it
+  // is deregistered.
+  NET_TS_DECL void register_injection_ring(injection_ring& r);
+
+  // Deregister a ring. Operations still in the ring are moved to the queue.
+  NET_TS_DECL void deregister_injection_ring(injection_ring& r);
+
+  // Request invocation of the given operation through the given ring and
+  // return immediately. Falls back to post_immediate_completion() if the ring
+  // is full. Must only be called by the ring's producer.
+  NET_TS_DECL void post_injected_completion(
+      injection_ring& r, operation* op);
+
   // Enqueue the given operation following a failed attempt to dispatch the
   // operation for immediate invocation.
   NET_TS_DECL void do_dispatch(operation* op);
@@ -124,16 +188,45 @@ public:
   // work_started() was previously called for the operations.
   NET_TS_DECL void abandon_operations(op_queue<operation>& ops);
 
+  // The default maximum depth of nested inline completions.
+  enum { default_inline_completion_depth = 8 };
+
   // Get the concurrency hint that was used to initialise the scheduler.
   int concurrency_hint() const
   {
     return concurrency_hint_;
   }
 
+  // Set the time, in microseconds, for which a thread without work spins
+  // before blocking. A budget of zero disables spinning.
+  NET_TS_DECL void set_spin_budget(long usec);
+
+  // Get the spin budget in microseconds.
+  NET_TS_DECL long spin_budget() const;
+
+  // Get the counts of spins and blocking waits.
+  NET_TS_DECL spin_statistics get_spin_statistics() const;
+
+#if defined(NET_TS_HAS_CHRONO)
+  // Get the time of the steady clock. Inside the scheduler, the clock is read
+  // at most once per handler or wait. Other threads read the clock directly.
+  chrono::steady_clock::time_point cached_now()
+  {
+    if (running_thread_info() == 0)
+      return chrono::steady_clock::now();
+    return time_cache_.now();
+  }
+#endif // defined(NET_TS_HAS_CHRONO)
+
 private:
   // The mutex type used by this scheduler.
   typedef conditionally_enabled_mutex mutex;
 
+#if defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+  // The counts are only ever accessed by the thread running the scheduler.
+  typedef long atomic_count;
+#endif // defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+
   // The event type used by this scheduler.
   typedef conditionally_enabled_event event;
 
@@ -152,13 +245,78 @@ private:
   NET_TS_DECL std::size_t do_poll_one(mutex::scoped_lock& lock,
       thread_info& this_thread, const std::error_code& ec);
 
+  // Run the task without blocking until it produces work, other work arrives,
+  // or the spin budget is used up, then block in the task if necessary. The
+  // lock is not held on entry or on exit.
+  NET_TS_DECL void spin_task(mutex::scoped_lock& lock,
+      thread_info& this_thread, long usec, long wakeups);
+
+  // Spin until work arrives or the spin budget is used up. Returns true if
+  // work arrived or the scheduler was stopped. The lock is held on entry and
+  // on exit.
+  NET_TS_DECL bool spin_for_work(mutex::scoped_lock& lock);
+
+  // Move operations from the injection rings to the queue. Returns true if
+  // any were found. The lock must be held.
+  NET_TS_DECL bool drain_injection_rings();
+
+  // Called by a thread that is about to block or spin. Announces the wait to
+  // producers and then drains the rings. Returns true if the caller must call
+  // end_injection_wait() once it has woken, or false if the rings yielded
+  // work. The lock must be held.
+  NET_TS_DECL bool begin_injection_wait();
+
+  // Called when a wait announced by begin_injection_wait() has finished.
+  void end_injection_wait()
+  {
+    --injection_waiters_;
+  }
+
   // Stop the task and all idle threads.
   NET_TS_DECL void stop_all_threads(mutex::scoped_lock& lock);
 
+  // Tell any spinning threads that work may have been queued, so that they
+  // look at the queue. The lock must be held.
+  void notify_spinning_threads()
+  {
+    if (spinning_threads_ > 0 || task_spinning_)
+      ++spin_wakeups_;
+  }
+
   // Wake a single idle thread, or the task, and always unlock the mutex.
   NET_TS_DECL void wake_one_thread_and_unlock(
       mutex::scoped_lock& lock);
 
+  // Helper class to record the thread running the scheduler, so that a
+  // single-threaded scheduler need not look it up in thread-specific storage.
+  class running_context
+    : private std::experimental::net::v1::detail::noncopyable
+  {
+  public:
+#if defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+    running_context(scheduler* s, thread_info_base& t)
+      : scheduler_(s),
+        outer_(s->running_thread_)
+    {
+      scheduler_->running_thread_ = &t;
+    }
+
+    ~running_context()
+    {
+      scheduler_->running_thread_ = outer_;
+    }
+
+  private:
+    scheduler* scheduler_;
+    thread_info_base* outer_;
+#else // defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+    running_context(scheduler*, thread_info_base&)
+    {
+    }
+#endif // defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+  };
+  friend class running_context;
+
   // Helper class to perform task-related operations on block exit.
   struct task_cleanup;
   friend struct task_cleanup;
@@ -167,6 +325,10 @@ private:
   struct work_cleanup;
   friend struct work_cleanup;
 
+  // Helper class to restore the inline completion depth on block exit.
+  struct inline_completion_cleanup;
+  friend struct inline_completion_cleanup;
+
   // Whether to optimise for single-threaded use cases.
   const bool one_thread_;
 
@@ -188,6 +350,11 @@ private:
   // Whether the task has been interrupted.
   bool task_interrupted_;
 
+  // Whether an idle thread has been signalled and has not yet woken. Further
+  // wakeups are suppressed until it does, as the woken thread passes work on
+  // to other idle threads if there is more than it can handle.
+  bool wakeup_pending_;
+
   // The count of unfinished work.
   atomic_count outstanding_work_;
 
@@ -202,6 +369,49 @@ private:
 
   // The concurrency hint used to initialise the scheduler.
   const int concurrency_hint_;
+
+  // The spin budget, in microseconds, as requested.
+  long spin_budget_usec_;
+
+  // The spin budget in effect. Zero if spinning is not worthwhile.
+  long spin_usec_;
+
+  // Whether the task is being run without blocking until work arrives.
+  bool task_spinning_;
+
+  // The number of idle threads that are spinning on the queue.
+  std::size_t spinning_threads_;
+
+  // Incremented when work is posted while a thread is spinning.
+  atomic_count spin_wakeups_;
+
+  // Counts of spins and blocking waits.
+  spin_statistics spin_statistics_;
+
+  // Whether all operations that complete immediately may be invoked inline.
+  // Read without locking, so only changed while no thread is running.
+  bool inline_completion_;
+
+  // The maximum depth of nested inline completions on a thread.
+  std::size_t inline_completion_depth_;
+
+#if defined(NET_TS_HAS_CHRONO)
+  // The time of the steady clock, invalidated each time the task has run.
+  steady_time_cache time_cache_;
+#endif // defined(NET_TS_HAS_CHRONO)
+
+#if defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+  // The innermost thread information of the thread running the scheduler.
+  thread_info_base* running_thread_;
+#endif // defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+
+  // The registered rings through which producers post without locking.
+  injection_ring* injection_rings_;
+
+  // The number of threads that are blocked, or about to block. Producers
+  // posting through a ring take the lock to wake a thread only when this is
+  // non-zero.
+  atomic_count injection_waiters_;
 };
 
 } // namespace detail
@@ -0,0 +1,120 @@
+//
+// detail/scheduler_allocator.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_SCHEDULER_ALLOCATOR_HPP
+#define NET_TS_DETAIL_SCHEDULER_ALLOCATOR_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <memory>
+
+#if defined(NET_TS_DISABLE_IO_CONTEXT_THREADS) && !defined(NET_TS_HAS_IOCP)
+# include <experimental/__net_ts/detail/scheduler.hpp>
+# include <experimental/__net_ts/detail/thread_info_base.hpp>
+#endif // defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+       //   && !defined(NET_TS_HAS_IOCP)
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+#if defined(NET_TS_DISABLE_IO_CONTEXT_THREADS) && !defined(NET_TS_HAS_IOCP)
+
+// Allocator that recycles memory through the thread running a single-threaded
+// scheduler. It plays the part of recycling_allocator for functions posted to
+// an io_context, but finds the thread's information through the scheduler
+// rather than by looking it up in thread-specific storage.
+template <typename T>
+class scheduler_allocator
+{
+public:
+  typedef T value_type;
+
+  template <typename U>
+  struct rebind
+  {
+    typedef scheduler_allocator<U> other;
+  };
+
+  explicit scheduler_allocator(scheduler& s)
+    : scheduler_(&s)
+  {
+  }
+
+  template <typename U>
+  scheduler_allocator(const scheduler_allocator<U>& other)
+    : scheduler_(other.scheduler_)
+  {
+  }
+
+  T* allocate(std::size_t n)
+  {
+    void* p = thread_info_base::allocate(thread_info_base::default_tag(),
+        scheduler_->running_thread_info(), sizeof(T) * n);
+    return static_cast<T*>(p);
+  }
+
+  void deallocate(T* p, std::size_t n)
+  {
+    thread_info_base::deallocate(thread_info_base::default_tag(),
+        scheduler_->running_thread_info(), p, sizeof(T) * n);
+  }
+
+private:
+  template <typename> friend class scheduler_allocator;
+  scheduler* scheduler_;
+};
+
+// Use the scheduler's allocator in place of the default allocator.
+template <typename Allocator>
+struct get_scheduler_allocator
+{
+  typedef Allocator type;
+  static const type& get(const Allocator& a, scheduler&) { return a; }
+};
+
+template <typename T>
+struct get_scheduler_allocator<std::allocator<T> >
+{
+  typedef scheduler_allocator<T> type;
+  static type get(const std::allocator<T>&, scheduler& s) { return type(s); }
+};
+
+#else // defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+      //   && !defined(NET_TS_HAS_IOCP)
+
+// The default allocator already recycles memory through the calling thread.
+template <typename Allocator>
+struct get_scheduler_allocator
+{
+  typedef Allocator type;
+  template <typename Scheduler>
+  static const type& get(const Allocator& a, Scheduler&) { return a; }
+};
+
+#endif // defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+       //   && !defined(NET_TS_HAS_IOCP)
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_DETAIL_SCHEDULER_ALLOCATOR_HPP
@@ -101,13 +101,22 @@ public:
   // Start a new operation. The reactor operation will be performed when the
   // given descriptor is flagged as ready, or an error has occurred.
   NET_TS_DECL void start_op(int op_type, socket_type descriptor,
-      per_descriptor_data&, reactor_op* op, bool is_continuation, bool);
+      per_descriptor_data&, reactor_op* op, bool is_continuation,
+      bool, bool = false);
 
   // Cancel all operations associated with the given descriptor. The
   // handlers associated with the descriptor will be invoked with the
   // operation_aborted error.
   NET_TS_DECL void cancel_ops(socket_type descriptor, per_descriptor_data&);
 
+  // Cancel the operation of the given type that is associated with the given
+  // key. The handler for the operation, if it is still pending, will be
+  // invoked with the operation_aborted error. Other operations associated
+  // with the descriptor are not affected.
+  NET_TS_DECL void cancel_ops_by_key(socket_type descriptor,
+      per_descriptor_data& descriptor_data, int op_type,
+      void* cancellation_key);
+
   // Cancel any operations that are running against the descriptor and remove
   // its registration from the reactor. The reactor resources associated with
   // the descriptor must be released by calling cleanup_descriptor_data.
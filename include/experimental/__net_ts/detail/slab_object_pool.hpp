@@ -0,0 +1,444 @@
+//
+// detail/slab_object_pool.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_SLAB_OBJECT_POOL_HPP
+#define NET_TS_DETAIL_SLAB_OBJECT_POOL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <experimental/__net_ts/detail/cstdint.hpp>
+#include <experimental/__net_ts/detail/mutex.hpp>
+#include <experimental/__net_ts/detail/noncopyable.hpp>
+#include <experimental/__net_ts/detail/object_pool.hpp>
+#include <experimental/__net_ts/detail/throw_exception.hpp>
+#include <experimental/__net_ts/thread_placement.hpp>
+
+#if defined(NET_TS_HAS_STD_ATOMIC)
+# include <atomic>
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+
+#if defined(__linux__)
+# include <sched.h>
+#endif // defined(__linux__)
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+// A pool of objects with the same interface as object_pool, for objects that
+// are allocated and freed concurrently by many threads.
+//
+// Objects live in slabs, each slot padded to a whole number of cache lines so
+// that no two objects share a line. There is one shard of slabs per NUMA node,
+// and a thread allocates from the shard of the node it is running on. A slab
+// is first touched by the thread that creates it, so its memory is normally
+// placed on that thread's node. Freed objects go back to their own shard's
+// free list, which is a lock-free stack. A lock is taken only when a shard
+// has no free objects and must construct a new one.
+template <typename Object>
+class slab_object_pool
+  : private noncopyable
+{
+public:
+  // Constructor.
+  slab_object_pool()
+  {
+    std::size_t nodes = numa_node_count();
+    if (nodes > max_shards)
+      nodes = max_shards;
+    shards_.reserve(nodes);
+    for (std::size_t n = 0; n < nodes; ++n)
+      shards_.push_back(new shard);
+
+    // Map each processor to the shard for its node.
+    if (nodes > 1)
+    {
+      for (std::size_t n = 0; n < nodes; ++n)
+      {
+        std::error_code ec;
+        cpu_set cpus = cpu_set::numa_node(n, ec);
+        if (cpus.limit() > cpu_shards_.size())
+          cpu_shards_.resize(cpus.limit());
+        for (std::size_t cpu = 0; cpu < cpus.limit(); ++cpu)
+          if (cpus.contains(cpu))
+            cpu_shards_[cpu] = static_cast<uint16_t>(n);
+      }
+    }
+  }
+
+  // Destructor destroys all objects.
+  ~slab_object_pool()
+  {
+    for (std::size_t n = 0; n < shards_.size(); ++n)
+    {
+      shard* s = shards_[n];
+      for (uint32_t i = 0; i < s->size_; ++i)
+        object_pool_access::destruct(object(slot(*s, i)));
+      for (std::size_t k = 0; k < max_slabs; ++k)
+        ::operator delete(s->raw_slabs_[k]);
+      delete s;
+    }
+  }
+
+  // Get the first live object. Must not be called concurrently with alloc or
+  // free.
+  Object* first()
+  {
+    return find_live(0, 0);
+  }
+
+  // Get the live object that follows the given one. Must not be called
+  // concurrently with alloc or free.
+  Object* next(Object* o)
+  {
+    slot_header* h = header(o);
+    return find_live(h->shard_, h->index_ + 1);
+  }
+
+  // Allocate an object, constructing it with an argument if there are no free
+  // objects to reuse.
+  template <typename Arg>
+  Object* alloc(Arg arg)
+  {
+    std::size_t home = this_thread_shard();
+
+    // Prefer the local node's free objects, then any other node's, before
+    // growing the local node's slabs.
+    for (std::size_t n = 0; n < shards_.size(); ++n)
+    {
+      shard& s = *shards_[(home + n) % shards_.size()];
+      if (slot_header* h = pop(s))
+      {
+        h->live_ = true;
+        return object(h);
+      }
+    }
+
+    return construct(home, arg);
+  }
+
+  // Free an object. Moves it to the free list of its shard. No destructors are
+  // run.
+  void free(Object* o)
+  {
+    slot_header* h = header(o);
+    h->live_ = false;
+    push(*shards_[h->shard_], h);
+  }
+
+private:
+  enum
+  {
+    // Slots are padded to a multiple of this size.
+    cache_line_size = 64,
+
+    // The alignment of objects within their slots, which is enough for any
+    // fundamental type.
+    object_alignment = 16,
+
+    // The number of slots in a shard's first slab. Each subsequent slab is
+    // twice the size of the one before, so that a slot index maps to its slab
+    // without a search.
+    first_slab_size = 64,
+
+    // The number of slabs a shard may have. Keeps the highest slot index, plus
+    // one, within 32 bits.
+    max_slabs = 25,
+
+    // The number of shards a pool may have.
+    max_shards = 64,
+
+    // The number of allocations for which a thread reuses its cached
+    // processor number.
+    cpu_sample_interval = 64
+  };
+
+  // The header at the start of each slot.
+  struct slot_header
+  {
+    // The index of the next slot on the free list, plus one.
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    std::atomic<uint32_t> next_free_;
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+    uint32_t next_free_;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+
+    // The slot's index within its shard.
+    uint32_t index_;
+
+    // The shard that owns the slot.
+    uint16_t shard_;
+
+    // Whether the object is allocated.
+    bool live_;
+  };
+
+  // The slabs belonging to one NUMA node.
+  struct shard
+  {
+    shard()
+      : size_(0)
+    {
+#if defined(NET_TS_HAS_STD_ATOMIC)
+      free_head_.store(0, std::memory_order_relaxed);
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+      free_head_ = 0;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+      for (std::size_t k = 0; k < max_slabs; ++k)
+      {
+        slabs_[k] = 0;
+        raw_slabs_[k] = 0;
+      }
+    }
+
+    char pad1_[cache_line_size];
+
+    // The free list. The low 32 bits hold the index of the top slot plus one,
+    // or zero if the list is empty. The high 32 bits are a tag that changes on
+    // every update, so that a pop cannot succeed against a stale top.
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    std::atomic<uint64_t> free_head_;
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+    uint64_t free_head_;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+
+    char pad2_[cache_line_size];
+
+    // Protects construction of new objects, and the free list when atomics
+    // are not available.
+    mutex mutex_;
+
+    // The number of slots that hold constructed objects.
+    uint32_t size_;
+
+    // The slabs, aligned to the cache line size, and the allocations that hold
+    // them.
+    char* slabs_[max_slabs];
+    void* raw_slabs_[max_slabs];
+  };
+
+  // The offset of the object within its slot.
+  static std::size_t object_offset()
+  {
+    return (sizeof(slot_header) + object_alignment - 1)
+      / object_alignment * object_alignment;
+  }
+
+  // The size of each slot.
+  static std::size_t slot_size()
+  {
+    std::size_t size = object_offset() + sizeof(Object);
+    return (size + cache_line_size - 1) / cache_line_size * cache_line_size;
+  }
+
+  // Get the slab that holds the slot with the given index.
+  static std::size_t slab_of(uint32_t index)
+  {
+    uint32_t n = index / first_slab_size + 1;
+    std::size_t k = 0;
+    while (n >>= 1)
+      ++k;
+    return k;
+  }
+
+  // Get the slot with the given index. The slot's slab must exist.
+  static slot_header* slot(shard& s, uint32_t index)
+  {
+    std::size_t k = slab_of(index);
+    std::size_t offset = index - first_slab_size * ((1u << k) - 1);
+    return reinterpret_cast<slot_header*>(s.slabs_[k] + offset * slot_size());
+  }
+
+  static Object* object(slot_header* h)
+  {
+    return reinterpret_cast<Object*>(
+        reinterpret_cast<char*>(h) + object_offset());
+  }
+
+  static slot_header* header(Object* o)
+  {
+    return reinterpret_cast<slot_header*>(
+        reinterpret_cast<char*>(o) - object_offset());
+  }
+
+  // Get the shard for the node on which the calling thread is running.
+  std::size_t this_thread_shard() const
+  {
+#if defined(__linux__)
+    if (!cpu_shards_.empty())
+    {
+      int cpu = this_thread_cpu();
+      if (cpu >= 0 && static_cast<std::size_t>(cpu) < cpu_shards_.size())
+        return cpu_shards_[cpu];
+    }
+#endif // defined(__linux__)
+    return 0;
+  }
+
+#if defined(__linux__)
+  // Get the processor on which the calling thread is running. Where thread
+  // local storage is available the result is cached, and refreshed only every
+  // cpu_sample_interval calls so that a thread that migrates is picked up.
+  static int this_thread_cpu()
+  {
+#if defined(NET_TS_HAS_THREAD_KEYWORD_EXTENSION)
+    if (cpu_samples_left_ == 0)
+    {
+      cached_cpu_ = ::sched_getcpu();
+      cpu_samples_left_ = cpu_sample_interval;
+    }
+    --cpu_samples_left_;
+    return cached_cpu_;
+#else // defined(NET_TS_HAS_THREAD_KEYWORD_EXTENSION)
+    return ::sched_getcpu();
+#endif // defined(NET_TS_HAS_THREAD_KEYWORD_EXTENSION)
+  }
+#endif // defined(__linux__)
+
+  // Find the first live object at or after the given position.
+  Object* find_live(std::size_t n, uint32_t index)
+  {
+    for (; n < shards_.size(); ++n, index = 0)
+    {
+      shard& s = *shards_[n];
+      for (; index < s.size_; ++index)
+      {
+        slot_header* h = slot(s, index);
+        if (h->live_)
+          return object(h);
+      }
+    }
+    return 0;
+  }
+
+  // Construct a new object in the next unused slot of a shard.
+  template <typename Arg>
+  Object* construct(std::size_t n, Arg arg)
+  {
+    shard& s = *shards_[n];
+    mutex::scoped_lock lock(s.mutex_);
+
+    uint32_t index = s.size_;
+    std::size_t k = slab_of(index);
+    if (k >= max_slabs)
+      std::experimental::net::v1::detail::throw_exception(std::bad_alloc());
+    if (!s.slabs_[k])
+    {
+      std::size_t bytes = (first_slab_size << k) * slot_size();
+      void* raw = ::operator new(bytes + cache_line_size - 1);
+      std::size_t addr = reinterpret_cast<std::size_t>(raw);
+      addr = (addr + cache_line_size - 1) / cache_line_size * cache_line_size;
+      s.raw_slabs_[k] = raw;
+      s.slabs_[k] = reinterpret_cast<char*>(addr);
+    }
+
+    slot_header* h = new (slot(s, index)) slot_header;
+    Object* o = object_pool_access::construct<Object>(object(h), arg);
+    h->index_ = index;
+    h->shard_ = static_cast<uint16_t>(n);
+    h->live_ = true;
+    ++s.size_;
+    return o;
+  }
+
+  // Push a slot on to a shard's free list.
+  static void push(shard& s, slot_header* h)
+  {
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    uint64_t head = s.free_head_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      h->next_free_.store(static_cast<uint32_t>(head),
+          std::memory_order_relaxed);
+      uint64_t new_head = ((((head >> 32) + 1) & 0xFFFFFFFFu) << 32)
+        | (static_cast<uint64_t>(h->index_) + 1);
+      if (s.free_head_.compare_exchange_weak(head, new_head,
+            std::memory_order_release, std::memory_order_relaxed))
+        return;
+    }
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+    mutex::scoped_lock lock(s.mutex_);
+    h->next_free_ = static_cast<uint32_t>(s.free_head_);
+    s.free_head_ = static_cast<uint64_t>(h->index_) + 1;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+  }
+
+  // Pop a slot from a shard's free list. Returns 0 if the list is empty.
+  static slot_header* pop(shard& s)
+  {
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    uint64_t head = s.free_head_.load(std::memory_order_acquire);
+    for (;;)
+    {
+      uint32_t top = static_cast<uint32_t>(head);
+      if (top == 0)
+        return 0;
+
+      // The top slot may be popped and reused by another thread while its
+      // next index is read. The tag ensures the exchange then fails.
+      slot_header* h = slot(s, top - 1);
+      uint64_t new_head = ((((head >> 32) + 1) & 0xFFFFFFFFu) << 32)
+        | h->next_free_.load(std::memory_order_relaxed);
+      if (s.free_head_.compare_exchange_weak(head, new_head,
+            std::memory_order_acquire, std::memory_order_acquire))
+        return h;
+    }
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+    mutex::scoped_lock lock(s.mutex_);
+    uint32_t top = static_cast<uint32_t>(s.free_head_);
+    if (top == 0)
+      return 0;
+    slot_header* h = slot(s, top - 1);
+    s.free_head_ = h->next_free_;
+    return h;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+  }
+
+  // The shards, one per NUMA node.
+  std::vector<shard*> shards_;
+
+  // The shard for each processor. Empty if there is only one shard.
+  std::vector<uint16_t> cpu_shards_;
+
+#if defined(__linux__) && defined(NET_TS_HAS_THREAD_KEYWORD_EXTENSION)
+  // The calling thread's cached processor number, and the number of calls
+  // left before it is sampled again.
+  static NET_TS_THREAD_KEYWORD int cached_cpu_;
+  static NET_TS_THREAD_KEYWORD int cpu_samples_left_;
+#endif // defined(__linux__) && defined(NET_TS_HAS_THREAD_KEYWORD_EXTENSION)
+};
+
+#if defined(__linux__) && defined(NET_TS_HAS_THREAD_KEYWORD_EXTENSION)
+template <typename Object>
+NET_TS_THREAD_KEYWORD int slab_object_pool<Object>::cached_cpu_;
+
+template <typename Object>
+NET_TS_THREAD_KEYWORD int slab_object_pool<Object>::cpu_samples_left_;
+#endif // defined(__linux__) && defined(NET_TS_HAS_THREAD_KEYWORD_EXTENSION)
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_DETAIL_SLAB_OBJECT_POOL_HPP
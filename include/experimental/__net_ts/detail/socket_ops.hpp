@@ -55,7 +55,11 @@ enum
   datagram_oriented = 32,
 
   // The socket may have been dup()-ed.
-  possible_dup = 64
+  possible_dup = 64,
+
+  // The user wants operations that complete immediately to invoke their
+  // handlers inline.
+  inline_completion = 128
 };
 
 typedef unsigned char state_type;
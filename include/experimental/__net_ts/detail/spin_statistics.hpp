@@ -0,0 +1,50 @@
+//
+// detail/spin_statistics.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_SPIN_STATISTICS_HPP
+#define NET_TS_DETAIL_SPIN_STATISTICS_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+// Counts of how the threads running a scheduler have waited for work.
+struct spin_statistics
+{
+  // The number of times a thread ran out of work and started spinning.
+  std::size_t spins;
+
+  // The number of spins that found work before the spin budget ran out.
+  std::size_t spin_hits;
+
+  // The number of times a thread blocked waiting for work.
+  std::size_t parks;
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_DETAIL_SPIN_STATISTICS_HPP
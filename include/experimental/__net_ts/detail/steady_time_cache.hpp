@@ -0,0 +1,116 @@
+//
+// detail/steady_time_cache.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_DETAIL_STEADY_TIME_CACHE_HPP
+#define NET_TS_DETAIL_STEADY_TIME_CACHE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+
+#if defined(NET_TS_HAS_CHRONO)
+
+#include <experimental/__net_ts/detail/chrono.hpp>
+#include <experimental/__net_ts/detail/cstdint.hpp>
+#include <experimental/__net_ts/detail/noncopyable.hpp>
+
+#if defined(NET_TS_HAS_STD_ATOMIC)
+# include <atomic>
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+// A reading of the steady clock that is shared by all threads until it is
+// invalidated, so that the clock is read at most once per invalidation. The
+// time is held in nanoseconds, shifted left by one to make room for a flag
+// that indicates whether it is current. Without atomics, the clock is read
+// every time.
+class steady_time_cache
+  : private noncopyable
+{
+public:
+  // Construct with no current time.
+  steady_time_cache()
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    : value_(0)
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+  {
+  }
+
+  // Mark the time as out of date, so that the clock is read again when the
+  // time is next requested.
+  void invalidate()
+  {
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    if (value_.load(std::memory_order_relaxed) & 1)
+      value_.fetch_and(~static_cast<uint64_t>(1), std::memory_order_relaxed);
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+  }
+
+  // Get the cached time, reading the clock if it is out of date. The time
+  // returned never goes backwards.
+  chrono::steady_clock::time_point now()
+  {
+#if defined(NET_TS_HAS_STD_ATOMIC)
+    uint64_t v = value_.load(std::memory_order_relaxed);
+    if (v & 1)
+      return to_time_point(v >> 1);
+
+    uint64_t t = static_cast<uint64_t>(
+        chrono::duration_cast<chrono::nanoseconds>(
+          chrono::steady_clock::now().time_since_epoch()).count());
+    for (;;)
+    {
+      // Another thread may have read the clock first.
+      if (v & 1)
+        return to_time_point(v >> 1);
+
+      uint64_t n = ((v >> 1) > t ? (v >> 1) : t);
+      if (value_.compare_exchange_weak(v, (n << 1) | 1,
+            std::memory_order_relaxed))
+        return to_time_point(n);
+    }
+#else // defined(NET_TS_HAS_STD_ATOMIC)
+    return chrono::steady_clock::now();
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+  }
+
+private:
+  static chrono::steady_clock::time_point to_time_point(uint64_t nsec)
+  {
+    return chrono::steady_clock::time_point(
+        chrono::duration_cast<chrono::steady_clock::duration>(
+          chrono::nanoseconds(static_cast<int64_t>(nsec))));
+  }
+
+#if defined(NET_TS_HAS_STD_ATOMIC)
+  std::atomic<uint64_t> value_;
+#endif // defined(NET_TS_HAS_STD_ATOMIC)
+};
+
+} // namespace detail
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // defined(NET_TS_HAS_CHRONO)
+
+#endif // NET_TS_DETAIL_STEADY_TIME_CACHE_HPP
@@ -46,6 +46,11 @@ public:
     enum { mem_index = 2 };
   };
 
+  struct light_future_tag
+  {
+    enum { mem_index = 3 };
+  };
+
   thread_info_base()
   {
     for (int i = 0; i < max_mem_index; ++i)
@@ -117,7 +122,7 @@ public:
 
 private:
   enum { chunk_size = 4 };
-  enum { max_mem_index = 3 };
+  enum { max_mem_index = 4 };
   void* reusable_memory_[max_mem_index];
 };
 
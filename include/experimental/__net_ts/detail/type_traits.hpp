@@ -21,14 +21,17 @@
 # include <type_traits>
 #else // defined(NET_TS_HAS_TYPE_TRAITS)
 # include <boost/type_traits/add_const.hpp>
+# include <boost/type_traits/alignment_of.hpp>
 # include <boost/type_traits/conditional.hpp>
 # include <boost/type_traits/decay.hpp>
+# include <boost/type_traits/has_nothrow_copy.hpp>
 # include <boost/type_traits/integral_constant.hpp>
 # include <boost/type_traits/is_base_of.hpp>
 # include <boost/type_traits/is_class.hpp>
 # include <boost/type_traits/is_const.hpp>
 # include <boost/type_traits/is_convertible.hpp>
 # include <boost/type_traits/is_function.hpp>
+# include <boost/type_traits/is_nothrow_move_constructible.hpp>
 # include <boost/type_traits/is_same.hpp>
 # include <boost/type_traits/remove_pointer.hpp>
 # include <boost/type_traits/remove_reference.hpp>
@@ -43,6 +46,7 @@ inline namespace v1 {
 
 #if defined(NET_TS_HAS_STD_TYPE_TRAITS)
 using std::add_const;
+using std::alignment_of;
 using std::conditional;
 using std::decay;
 using std::enable_if;
@@ -53,6 +57,8 @@ using std::is_class;
 using std::is_const;
 using std::is_convertible;
 using std::is_function;
+using std::is_nothrow_copy_constructible;
+using std::is_nothrow_move_constructible;
 using std::is_same;
 using std::remove_pointer;
 using std::remove_reference;
@@ -66,6 +72,7 @@ using std::result_of;
 using std::true_type;
 #else // defined(NET_TS_HAS_STD_TYPE_TRAITS)
 using boost::add_const;
+using boost::alignment_of;
 template <bool Condition, typename Type = void>
 struct enable_if : boost::enable_if_c<Condition, Type> {};
 using boost::conditional;
@@ -77,6 +84,9 @@ using boost::is_class;
 using boost::is_const;
 using boost::is_convertible;
 using boost::is_function;
+template <typename T>
+struct is_nothrow_copy_constructible : boost::has_nothrow_copy<T> {};
+using boost::is_nothrow_move_constructible;
 using boost::is_same;
 using boost::remove_pointer;
 using boost::remove_reference;
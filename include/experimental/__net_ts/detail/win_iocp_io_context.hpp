@@ -19,11 +19,14 @@
 
 #if defined(NET_TS_HAS_IOCP)
 
+#include <experimental/__net_ts/detail/injection_ring.hpp>
 #include <experimental/__net_ts/detail/limits.hpp>
 #include <experimental/__net_ts/detail/mutex.hpp>
 #include <experimental/__net_ts/detail/op_queue.hpp>
 #include <experimental/__net_ts/detail/scoped_ptr.hpp>
 #include <experimental/__net_ts/detail/socket_types.hpp>
+#include <experimental/__net_ts/detail/spin_statistics.hpp>
+#include <experimental/__net_ts/detail/steady_time_cache.hpp>
 #include <experimental/__net_ts/detail/thread.hpp>
 #include <experimental/__net_ts/detail/thread_context.hpp>
 #include <experimental/__net_ts/detail/timer_queue_base.hpp>
@@ -89,6 +92,13 @@ public:
     return ::InterlockedExchangeAdd(&stopped_, 0) != 0;
   }
 
+  // Get the count of unfinished work.
+  std::size_t outstanding_work() const
+  {
+    long n = ::InterlockedExchangeAdd(&outstanding_work_, 0);
+    return n > 0 ? static_cast<std::size_t>(n) : 0;
+  }
+
   // Restart in preparation for a subsequent run invocation.
   void restart()
   {
@@ -122,6 +132,35 @@ public:
     post_deferred_completion(op);
   }
 
+  // Request invocation of the given operations and return immediately.
+  // Assumes that work_started() has not yet been called for the operations.
+  void post_immediate_completions(
+      op_queue<win_iocp_operation>& ops, std::size_t n)
+  {
+    ::InterlockedExchangeAdd(&outstanding_work_, static_cast<long>(n));
+    post_deferred_completions(ops);
+  }
+
+  // Register a ring for a producer thread. Posting to the completion port
+  // does not take a lock, so the ring itself is not used.
+  void register_injection_ring(injection_ring&)
+  {
+    work_started();
+  }
+
+  // Deregister a ring.
+  void deregister_injection_ring(injection_ring&)
+  {
+    work_finished();
+  }
+
+  // Request invocation of the given operation on behalf of a ring's producer
+  // and return immediately.
+  void post_injected_completion(injection_ring&, win_iocp_operation* op)
+  {
+    post_immediate_completion(op, false);
+  }
+
   // Request invocation of the given operation and return immediately. Assumes
   // that work_started() was previously called for the operation.
   NET_TS_DECL void post_deferred_completion(win_iocp_operation* op);
@@ -209,6 +248,64 @@ public:
     return concurrency_hint_;
   }
 
+  // Set the spin budget. Spinning is not implemented for I/O completion
+  // ports, so the budget is only recorded.
+  void set_spin_budget(long usec)
+  {
+    ::InterlockedExchange(&spin_budget_usec_, usec > 0 ? usec : 0);
+  }
+
+  // Get the spin budget in microseconds.
+  long spin_budget() const
+  {
+    return spin_budget_usec_;
+  }
+
+  // Set whether operations that complete immediately may be invoked inline.
+  // Completions are always delivered through the port, so the setting is
+  // only recorded.
+  void set_inline_completion(bool enable)
+  {
+    inline_completion_ = enable;
+  }
+
+  // Get whether operations that complete immediately may be invoked inline.
+  bool inline_completion() const
+  {
+    return inline_completion_;
+  }
+
+  // Set the maximum depth of nested inline completions on a thread.
+  void set_inline_completion_depth(std::size_t depth)
+  {
+    inline_completion_depth_ = depth;
+  }
+
+  // Get the maximum depth of nested inline completions on a thread.
+  std::size_t inline_completion_depth() const
+  {
+    return inline_completion_depth_;
+  }
+
+  // Get the counts of spins and blocking waits. No counts are kept.
+  spin_statistics get_spin_statistics() const
+  {
+    spin_statistics s = { 0, 0, 0 };
+    return s;
+  }
+
+#if defined(NET_TS_HAS_CHRONO)
+  // Get the time of the steady clock. Inside the io_context, the clock is
+  // read at most once per dequeued completion. Other threads read the clock
+  // directly.
+  chrono::steady_clock::time_point cached_now()
+  {
+    if (!can_dispatch())
+      return chrono::steady_clock::now();
+    return time_cache_.now();
+  }
+#endif // defined(NET_TS_HAS_CHRONO)
+
 private:
 #if defined(WINVER) && (WINVER < 0x0500)
   typedef DWORD dword_ptr_t;
@@ -250,7 +347,7 @@ private:
   auto_handle iocp_;
 
   // The count of unfinished work.
-  long outstanding_work_;
+  mutable long outstanding_work_;
 
   // Flag to indicate whether the event loop has been stopped.
   mutable long stopped_;
@@ -314,6 +411,19 @@ private:
 
   // The concurrency hint used to initialise the io_context.
   const int concurrency_hint_;
+
+  // The spin budget, in microseconds.
+  long spin_budget_usec_;
+
+  // The recorded inline completion settings.
+  bool inline_completion_;
+  std::size_t inline_completion_depth_;
+
+#if defined(NET_TS_HAS_CHRONO)
+  // The time of the steady clock, invalidated each time a thread returns from
+  // waiting on the completion port.
+  steady_time_cache time_cache_;
+#endif // defined(NET_TS_HAS_CHRONO)
 };
 
 } // namespace detail
@@ -20,8 +20,10 @@
 #if defined(NET_TS_HAS_IOCP)
 
 #include <cstring>
+#include <vector>
 #include <experimental/__net_ts/error.hpp>
 #include <experimental/__net_ts/io_context.hpp>
+#include <experimental/__net_ts/post.hpp>
 #include <experimental/__net_ts/socket_base.hpp>
 #include <experimental/__net_ts/detail/bind_handler.hpp>
 #include <experimental/__net_ts/detail/buffer_sequence_adapter.hpp>
@@ -232,6 +234,36 @@ public:
     return native_handle_type(impl.socket_);
   }
 
+  // Move an open socket to another service, which may belong to a different
+  // io_context. Any pending operations are cancelled.
+  std::error_code migrate(implementation_type& impl,
+      win_iocp_socket_service& target_service,
+      implementation_type& target_impl, std::error_code& ec)
+  {
+    if (!is_open(impl))
+    {
+      ec = std::experimental::net::v1::error::bad_descriptor;
+      return ec;
+    }
+
+    if (target_service.is_open(target_impl))
+    {
+      ec = std::experimental::net::v1::error::already_open;
+      return ec;
+    }
+
+    // Dissociate the socket from this completion port and associate it with
+    // the target's.
+    native_handle_type native_socket = native_handle(impl);
+    protocol_type protocol = impl.protocol_;
+    socket_holder sock(release(impl, ec));
+    if (ec)
+      return ec;
+    if (!target_service.assign(target_impl, protocol, native_socket, ec))
+      sock.release();
+    return ec;
+  }
+
   // Bind the socket to the specified local endpoint.
   std::error_code bind(implementation_type& impl,
       const endpoint_type& endpoint, std::error_code& ec)
@@ -561,6 +593,21 @@ public:
         p.p->address_length(), p.p);
     p.v = p.p = 0;
   }
+
+  // Start an asynchronous accept of a batch of connections. Completion ports
+  // report one accepted connection per operation, so batches are not
+  // supported.
+  template <typename Balancer, typename Handler>
+  void async_accept_many(implementation_type&,
+      std::size_t, Balancer&, Handler& handler)
+  {
+    std::error_code ec = std::experimental::net::v1::error::operation_not_supported;
+    std::experimental::net::v1::post(io_context_.get_executor(),
+        detail::move_binder2<Handler, std::error_code,
+          std::vector<typename Protocol::socket> >(0,
+            NET_TS_MOVE_CAST(Handler)(handler), ec,
+            std::vector<typename Protocol::socket>()));
+  }
 #endif // defined(NET_TS_HAS_MOVE)
 
   // Connect the socket to the specified endpoint.
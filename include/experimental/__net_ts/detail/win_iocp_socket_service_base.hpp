@@ -127,6 +127,30 @@ public:
   NET_TS_DECL std::error_code cancel(
       base_implementation_type& impl, std::error_code& ec);
 
+  // Set whether readiness of the socket wakes only one of the io_contexts
+  // waiting on the same open socket.
+  std::error_code set_exclusive_wakeup(base_implementation_type&,
+      bool, std::error_code& ec)
+  {
+    ec = std::experimental::net::v1::error::operation_not_supported;
+    return ec;
+  }
+
+  // Set the timeout, in microseconds, after which an operation on the socket
+  // that is waiting for readiness fails with the timed_out error.
+  std::error_code set_operation_timeout(base_implementation_type&,
+      uint64_t, std::error_code& ec)
+  {
+    ec = std::experimental::net::v1::error::operation_not_supported;
+    return ec;
+  }
+
+  // Get the timeout, in microseconds, for operations on the socket.
+  uint64_t operation_timeout(const base_implementation_type&) const
+  {
+    return 0;
+  }
+
   // Determine whether the socket is at the out-of-band data mark.
   bool at_mark(const base_implementation_type& impl,
       std::error_code& ec) const
@@ -173,6 +197,22 @@ public:
     return ec;
   }
 
+  // Gets whether operations that complete immediately invoke their handlers
+  // inline.
+  bool inline_completion(const base_implementation_type&) const
+  {
+    return false;
+  }
+
+  // Sets whether operations that complete immediately invoke their handlers
+  // inline. Completions are always delivered through the port.
+  std::error_code inline_completion(base_implementation_type&,
+      bool, std::error_code& ec)
+  {
+    ec = std::experimental::net::v1::error::operation_not_supported;
+    return ec;
+  }
+
   // Gets the non-blocking mode of the native socket implementation.
   bool native_non_blocking(const base_implementation_type& impl) const
   {
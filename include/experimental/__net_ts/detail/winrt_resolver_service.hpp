@@ -105,6 +105,24 @@ public:
   {
   }
 
+  // Set a resolver option.
+  template <typename Option>
+  std::error_code set_option(implementation_type&,
+      const Option&, std::error_code& ec)
+  {
+    ec = std::experimental::net::v1::error::operation_not_supported;
+    return ec;
+  }
+
+  // Get a resolver option.
+  template <typename Option>
+  std::error_code get_option(const implementation_type&,
+      Option&, std::error_code& ec) const
+  {
+    ec = std::experimental::net::v1::error::operation_not_supported;
+    return ec;
+  }
+
   // Resolve a query to a list of entries.
   results_type resolve(implementation_type&,
       const query_type& query, std::error_code& ec)
@@ -20,6 +20,7 @@
 #include <experimental/__net_ts/detail/cstddef.hpp>
 #include <experimental/__net_ts/detail/memory.hpp>
 #include <experimental/__net_ts/detail/throw_exception.hpp>
+#include <experimental/__net_ts/detail/type_traits.hpp>
 #include <experimental/__net_ts/execution_context.hpp>
 
 #include <experimental/__net_ts/detail/push_options.hpp>
@@ -60,25 +61,34 @@ public:
 
   /// Copy constructor.
   executor(const executor& other) NET_TS_NOEXCEPT
-    : impl_(other.clone())
+    : impl_(0)
   {
+    impl_ = other.clone(space_);
   }
 
 #if defined(NET_TS_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
   /// Move constructor.
   executor(executor&& other) NET_TS_NOEXCEPT
-    : impl_(other.impl_)
+    : impl_(0)
   {
-    other.impl_ = 0;
+    impl_ = other.release(space_);
   }
 #endif // defined(NET_TS_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
 
   /// Construct a polymorphic wrapper for the specified executor.
+  /**
+   * Small executors, such as io_context::executor_type and strands of it, are
+   * stored within the polymorphic wrapper itself and no memory is allocated.
+   */
   template <typename Executor>
   executor(Executor e);
 
   /// Allocator-aware constructor to create a polymorphic wrapper for the
   /// specified executor.
+  /**
+   * The allocator is used only when the executor is too large to be stored
+   * within the polymorphic wrapper itself.
+   */
   template <typename Executor, typename Allocator>
   executor(allocator_arg_t, const Allocator& a, Executor e);
 
@@ -91,8 +101,12 @@ public:
   /// Assignment operator.
   executor& operator=(const executor& other) NET_TS_NOEXCEPT
   {
-    destroy();
-    impl_ = other.clone();
+    if (this != &other)
+    {
+      destroy();
+      impl_ = 0;
+      impl_ = other.clone(space_);
+    }
     return *this;
   }
 
@@ -100,9 +114,12 @@ public:
   // Move assignment operator.
   executor& operator=(executor&& other) NET_TS_NOEXCEPT
   {
-    destroy();
-    impl_ = other.impl_;
-    other.impl_ = 0;
+    if (this != &other)
+    {
+      destroy();
+      impl_ = 0;
+      impl_ = other.release(space_);
+    }
     return *this;
   }
 #endif // defined(NET_TS_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
@@ -122,8 +139,8 @@ public:
   {
     executor tmp(NET_TS_MOVE_CAST(Executor)(e));
     destroy();
-    impl_ = tmp.impl_;
-    tmp.impl_ = 0;
+    impl_ = 0;
+    impl_ = tmp.release(space_);
     return *this;
   }
 
@@ -258,6 +275,7 @@ private:
 #if !defined(GENERATING_DOCUMENTATION)
   class function;
   template <typename, typename> class impl;
+  template <typename, typename> class inline_impl;
 
 #if !defined(NET_TS_NO_TYPEID)
   typedef const std::type_info& type_id_result_type;
@@ -280,7 +298,8 @@ private:
   class impl_base
   {
   public:
-    virtual impl_base* clone() const NET_TS_NOEXCEPT = 0;
+    virtual impl_base* clone(void* space) const NET_TS_NOEXCEPT = 0;
+    virtual impl_base* move(void* space) NET_TS_NOEXCEPT = 0;
     virtual void destroy() NET_TS_NOEXCEPT = 0;
     virtual execution_context& context() NET_TS_NOEXCEPT = 0;
     virtual void on_work_started() NET_TS_NOEXCEPT = 0;
@@ -313,12 +332,37 @@ private:
     return impl_;
   }
 
-  // Helper function to clone another implementation.
-  impl_base* clone() const NET_TS_NOEXCEPT
+  // Helper function to clone the implementation. Implementations stored
+  // inline are copied into the specified space.
+  impl_base* clone(void* space) const NET_TS_NOEXCEPT
+  {
+    return impl_ ? impl_->clone(space) : 0;
+  }
+
+  // Helper function to transfer ownership of the implementation. Implementations
+  // stored inline are moved into the specified space.
+  impl_base* release(void* space) NET_TS_NOEXCEPT
   {
-    return impl_ ? impl_->clone() : 0;
+    impl_base* i = impl_ ? impl_->move(space) : 0;
+    impl_ = 0;
+    return i;
   }
 
+  // Helper functions to create an implementation for an executor, either within
+  // the wrapper or using the allocator.
+  template <typename Executor, typename Allocator>
+  impl_base* create(const Executor& e, const Allocator& a);
+
+  template <typename Executor, typename Allocator>
+  impl_base* create(const Executor& e, const Allocator& a, true_type);
+
+  template <typename Executor, typename Allocator>
+  impl_base* create(const Executor& e, const Allocator& a, false_type);
+
+  // The number of pointers' worth of space available for inline storage. This
+  // is sufficient for a strand of io_context::executor_type.
+  enum { space_size = 6 };
+
   // Helper function to destroy an implementation.
   void destroy() NET_TS_NOEXCEPT
   {
@@ -327,6 +371,7 @@ private:
   }
 
   impl_base* impl_;
+  void* space_[space_size];
 #endif // !defined(GENERATING_DOCUMENTATION)
 };
 
@@ -0,0 +1,299 @@
+//
+// idle_tracker.hpp
+// ~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_IDLE_TRACKER_HPP
+#define NET_TS_IDLE_TRACKER_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+
+#if defined(NET_TS_HAS_CHRONO) || defined(GENERATING_DOCUMENTATION)
+
+#include <cstddef>
+#include <experimental/__net_ts/async_result.hpp>
+#include <experimental/__net_ts/io_context.hpp>
+#include <experimental/__net_ts/steady_timer.hpp>
+#include <experimental/__net_ts/detail/chrono.hpp>
+#include <experimental/__net_ts/detail/handler_type_requirements.hpp>
+#include <experimental/__net_ts/detail/idle_tracker_state.hpp>
+#include <experimental/__net_ts/detail/memory.hpp>
+#include <experimental/__net_ts/detail/noncopyable.hpp>
+#include <experimental/__net_ts/detail/wait_handler.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+
+/// Detects connections that have been idle for longer than a timeout.
+/**
+ * The idle_tracker class keeps one entry for each connection, typically as a
+ * member of the connection object. An asynchronous wait on an entry completes
+ * when the entry has not been touched for the tracker's timeout. Touching an
+ * entry, for example each time data is received, takes constant time and does
+ * not involve a timer.
+ *
+ * Entries are kept in a wheel of buckets that is advanced by a single timer
+ * once per resolution interval. An entry expires between @c timeout() and
+ * <tt>timeout() + resolution()</tt> after it was last touched. The timer does
+ * not run while no entries are being tracked.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Safe. Entries may be touched and cancelled from any
+ * thread.
+ *
+ * @par Example
+ * @code
+ * struct connection
+ * {
+ *   tcp::socket socket;
+ *   std::experimental::net::idle_tracker::entry idle;
+ *   ...
+ * };
+ *
+ * ...
+ *
+ * tracker.async_wait(conn->idle,
+ *     [conn](const std::error_code& error)
+ *     {
+ *       if (!error)
+ *         conn->socket.close();
+ *     });
+ *
+ * ...
+ *
+ * void read_handler(const std::error_code& error, std::size_t n)
+ * {
+ *   if (!error)
+ *   {
+ *     tracker.touch(conn->idle);
+ *     ...
+ *   }
+ * }
+ * @endcode
+ */
+class idle_tracker
+  : private noncopyable
+{
+public:
+  /// The clock type.
+  typedef chrono::steady_clock clock_type;
+
+  /// The duration type of the clock.
+  typedef clock_type::duration duration;
+
+  /// An entry in the tracker.
+  /**
+   * An entry is bound to the tracker that first waits on it, and may not be
+   * used with any other tracker. Destroying an entry that is being tracked
+   * cancels its wait.
+   */
+  class entry
+    : private noncopyable
+  {
+  public:
+    /// Construct an entry that is not being tracked.
+    entry()
+    {
+      hook_.next_ = 0;
+      hook_.prev_ = 0;
+      hook_.bucket_ = 0;
+      hook_.op_ = 0;
+    }
+
+    /// Destructor.
+    ~entry()
+    {
+      if (hook_.state_)
+        hook_.state_->cancel(hook_);
+    }
+
+  private:
+    friend class idle_tracker;
+    detail::idle_tracker_hook hook_;
+  };
+
+  /// Constructor.
+  /**
+   * Entries are checked for expiry eight times per timeout.
+   *
+   * @param io_context The io_context object that the tracker will use to
+   * dispatch handlers.
+   *
+   * @param timeout The time after which an entry that has not been touched
+   * expires. Must be positive.
+   */
+  idle_tracker(std::experimental::net::v1::io_context& io_context,
+      const duration& timeout)
+    : timer_(io_context),
+      state_(new detail::idle_tracker_state(io_context, timer_,
+            timeout, default_resolution(timeout)))
+  {
+  }
+
+  /// Constructor.
+  /**
+   * @param io_context The io_context object that the tracker will use to
+   * dispatch handlers.
+   *
+   * @param timeout The time after which an entry that has not been touched
+   * expires. Must be positive. It is rounded up to a multiple of
+   * @c resolution.
+   *
+   * @param resolution The interval at which entries are checked for expiry.
+   * Must be positive. A smaller value makes expiry more precise, at the cost
+   * of more frequent timer wakeups and more memory for the wheel.
+   */
+  idle_tracker(std::experimental::net::v1::io_context& io_context,
+      const duration& timeout, const duration& resolution)
+    : timer_(io_context),
+      state_(new detail::idle_tracker_state(io_context, timer_,
+            timeout, resolution))
+  {
+  }
+
+  /// Destructor.
+  /**
+   * Stops tracking all entries. The handler for each outstanding wait is
+   * invoked with the std::experimental::net::v1::error::operation_aborted
+   * error code.
+   */
+  ~idle_tracker()
+  {
+    state_->close();
+  }
+
+  /// Get the time after which an entry that has not been touched expires.
+  duration timeout() const
+  {
+    return state_->timeout();
+  }
+
+  /// Get the interval at which entries are checked for expiry.
+  duration resolution() const
+  {
+    return state_->resolution();
+  }
+
+  /// Get the number of entries being tracked.
+  std::size_t size() const
+  {
+    return state_->size();
+  }
+
+  /// Start tracking an entry.
+  /**
+   * This function starts an asynchronous wait that completes when the entry
+   * has not been touched for the tracker's timeout. It always returns
+   * immediately. The entry counts as touched when the wait starts. If the
+   * entry is already being tracked, its existing wait is cancelled.
+   *
+   * @param e The entry to track. It must not be destroyed while the tracker
+   * is touching or cancelling it.
+   *
+   * @param handler The handler to be called when the entry expires or the
+   * wait is cancelled. Copies will be made of the handler as required. The
+   * function signature of the handler must be:
+   * @code void handler(
+   *   const std::error_code& error // Result of operation.
+   * ); @endcode
+   * On expiry @c error is clear. If the wait is cancelled it is
+   * std::experimental::net::v1::error::operation_aborted. If the entry is
+   * bound to another tracker it is
+   * std::experimental::net::v1::error::invalid_argument. Regardless of
+   * whether the asynchronous operation completes immediately or not, the
+   * handler will not be invoked from within this function. Invocation of the
+   * handler will be performed in a manner equivalent to using
+   * std::experimental::net::v1::io_context::post().
+   */
+  template <typename WaitHandler>
+  NET_TS_INITFN_RESULT_TYPE(WaitHandler,
+      void (std::error_code))
+  async_wait(entry& e, NET_TS_MOVE_ARG(WaitHandler) handler)
+  {
+    // If you get an error on the following line it means that your handler does
+    // not meet the documented type requirements for a WaitHandler.
+    NET_TS_WAIT_HANDLER_CHECK(WaitHandler, handler) type_check;
+
+    async_completion<WaitHandler,
+      void (std::error_code)> init(handler);
+
+    cancel(e);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef detail::wait_handler<typename async_completion<WaitHandler,
+      void (std::error_code)>::completion_handler_type> op;
+    typename op::ptr p = { detail::addressof(init.completion_handler),
+      op::ptr::allocate(init.completion_handler), 0 };
+    p.p = new (p.v) op(init.completion_handler);
+
+    detail::idle_tracker_state::start(state_, e.hook_, p.p);
+    p.v = p.p = 0;
+
+    return init.result.get();
+  }
+
+  /// Record activity on an entry.
+  /**
+   * Resets the time since the entry was last touched. Has no effect if the
+   * entry is not being tracked by this tracker.
+   */
+  void touch(entry& e)
+  {
+    state_->touch(e.hook_);
+  }
+
+  /// Stop tracking an entry.
+  /**
+   * The handler for the entry's wait is invoked with the
+   * std::experimental::net::v1::error::operation_aborted error code.
+   *
+   * @return The number of asynchronous operations that were cancelled. That
+   * is, either 0 or 1.
+   */
+  std::size_t cancel(entry& e)
+  {
+    return state_->cancel(e.hook_);
+  }
+
+private:
+  // Check for expiry eight times per timeout, but no more often than once per
+  // millisecond.
+  static duration default_resolution(const duration& timeout)
+  {
+    duration resolution = timeout / 8;
+    if (resolution < chrono::milliseconds(1))
+      resolution = chrono::milliseconds(1);
+    return resolution;
+  }
+
+  // The timer used to advance the wheel.
+  steady_timer timer_;
+
+  // The state shared with the tracked entries.
+  detail::shared_ptr<detail::idle_tracker_state> state_;
+};
+
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // defined(NET_TS_HAS_CHRONO) || defined(GENERATING_DOCUMENTATION)
+
+#endif // NET_TS_IDLE_TRACKER_HPP
@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <experimental/__net_ts/associated_allocator.hpp>
+#include <experimental/__net_ts/associated_cancellation_slot.hpp>
 #include <experimental/__net_ts/associated_executor.hpp>
 #include <experimental/__net_ts/detail/bind_handler.hpp>
 #include <experimental/__net_ts/detail/handler_alloc_helpers.hpp>
@@ -27,6 +28,15 @@
 #include <experimental/__net_ts/error.hpp>
 #include <experimental/__net_ts/post.hpp>
 
+#if defined(NET_TS_HAS_CHRONO) && defined(NET_TS_HAS_MOVE)
+# include <utility>
+# include <vector>
+# include <experimental/__net_ts/steady_timer.hpp>
+# include <experimental/__net_ts/detail/memory.hpp>
+# include <experimental/__net_ts/detail/mutex.hpp>
+# include <experimental/__net_ts/detail/noncopyable.hpp>
+#endif // defined(NET_TS_HAS_CHRONO) && defined(NET_TS_HAS_MOVE)
+
 #include <experimental/__net_ts/detail/push_options.hpp>
 
 namespace std {
@@ -560,6 +570,296 @@ namespace detail
     networking_ts_handler_invoke_helpers::invoke(
         function, this_handler->handler_);
   }
+#if defined(NET_TS_HAS_CHRONO) && defined(NET_TS_HAS_MOVE)
+  // State shared by the connection attempts of a staggered connect operation.
+  template <typename Protocol NET_TS_SVC_TPARAM, typename RangeConnectHandler>
+  class staggered_connect_state : private noncopyable
+  {
+  public:
+    typedef typename Protocol::endpoint endpoint_type;
+
+    // Socket type used for the individual connection attempts.
+    class attempt_socket : public basic_socket<Protocol NET_TS_SVC_TARG>
+    {
+    public:
+      explicit attempt_socket(std::experimental::net::v1::io_context& io_context)
+        : basic_socket<Protocol NET_TS_SVC_TARG>(io_context)
+      {
+      }
+    };
+
+    template <typename EndpointSequence>
+    staggered_connect_state(basic_socket<Protocol NET_TS_SVC_TARG>& sock,
+        const EndpointSequence& endpoints,
+        const chrono::steady_clock::duration& attempt_delay,
+        RangeConnectHandler& handler)
+      : socket_(sock),
+        timer_(sock.get_executor().context()),
+        attempt_delay_(attempt_delay),
+        next_(0),
+        in_flight_(0),
+        done_(false),
+        cancelled_(false),
+        handler_(NET_TS_MOVE_CAST(RangeConnectHandler)(handler))
+    {
+      // Interleave the address families, starting with the family of the
+      // first endpoint.
+      std::vector<endpoint_type> first, second;
+      for (typename EndpointSequence::const_iterator iter = endpoints.begin(),
+          end = endpoints.end(); iter != end; ++iter)
+      {
+        endpoint_type endpoint = *iter;
+        if (first.empty() || endpoint.protocol() == first[0].protocol())
+          first.push_back(endpoint);
+        else
+          second.push_back(endpoint);
+      }
+      for (std::size_t i = 0; i < first.size() || i < second.size(); ++i)
+      {
+        if (i < first.size())
+          endpoints_.push_back(first[i]);
+        if (i < second.size())
+          endpoints_.push_back(second[i]);
+      }
+      attempts_.resize(endpoints_.size());
+    }
+
+    ~staggered_connect_state()
+    {
+      for (std::size_t i = 0; i < attempts_.size(); ++i)
+        delete attempts_[i];
+    }
+
+    // Abandon the operation, cancelling the connection attempts that are in
+    // flight and the attempt timer. The operation completes with the
+    // operation_aborted error once the attempts have finished, unless one of
+    // them has already connected.
+    void cancel()
+    {
+      std::experimental::net::v1::detail::mutex::scoped_lock lock(mutex_);
+      if (done_ || cancelled_)
+        return;
+      cancelled_ = true;
+      std::error_code ignored_ec;
+      for (std::size_t i = 0; i < attempts_.size(); ++i)
+        if (attempts_[i])
+          attempts_[i]->cancel(ignored_ec);
+      timer_.cancel();
+    }
+
+  //private:
+    basic_socket<Protocol NET_TS_SVC_TARG>& socket_;
+    std::vector<endpoint_type> endpoints_;
+    std::vector<attempt_socket*> attempts_;
+    std::experimental::net::v1::steady_timer timer_;
+    chrono::steady_clock::duration attempt_delay_;
+    std::size_t next_;
+    std::size_t in_flight_;
+    bool done_;
+    bool cancelled_;
+    std::error_code last_ec_;
+    std::experimental::net::v1::detail::mutex mutex_;
+    RangeConnectHandler handler_;
+  };
+
+  // Intermediate handler for a staggered connect operation. The index
+  // identifies the connection attempt that completed, or the attempt timer.
+  template <typename Protocol NET_TS_SVC_TPARAM, typename RangeConnectHandler>
+  class staggered_connect_op
+  {
+  public:
+    typedef staggered_connect_state<Protocol NET_TS_SVC_TARG,
+      RangeConnectHandler> state_type;
+
+    staggered_connect_op(const shared_ptr<state_type>& state,
+        std::size_t index)
+      : state_(state),
+        index_(index)
+    {
+    }
+
+    // Start the first connection attempt.
+    static void start(const shared_ptr<state_type>& state)
+    {
+      std::experimental::net::v1::detail::mutex::scoped_lock lock(
+          state->mutex_);
+      std::error_code ignored_ec;
+      state->socket_.close(ignored_ec);
+
+      // Allow the whole operation to be cancelled through the handler's
+      // cancellation slot.
+      typename associated_cancellation_slot<RangeConnectHandler>::type slot =
+        (get_associated_cancellation_slot)(state->handler_);
+      if (slot.is_connected())
+        slot.template emplace<cancellation_handler>(state);
+
+      start_next(state);
+    }
+
+    void operator()(const std::error_code& ec)
+    {
+      state_type& st = *state_;
+      std::experimental::net::v1::detail::mutex::scoped_lock lock(st.mutex_);
+
+      if (index_ == timer_index())
+      {
+        // Start another attempt if the delay elapsed without being restarted.
+        if (!ec && !st.done_ && !st.cancelled_
+            && st.next_ < st.endpoints_.size())
+          start_next(state_);
+        return;
+      }
+
+      --st.in_flight_;
+      if (st.done_)
+        return;
+
+      if (!ec)
+      {
+        // Keep the first connection established and abandon the others.
+        st.done_ = true;
+        std::error_code ignored_ec;
+        for (std::size_t i = 0; i < st.attempts_.size(); ++i)
+          if (i != index_ && st.attempts_[i])
+            st.attempts_[i]->close(ignored_ec);
+        st.timer_.cancel();
+        st.socket_ = std::move(static_cast<
+            basic_socket<Protocol NET_TS_SVC_TARG>&>(*st.attempts_[index_]));
+        lock.unlock();
+
+        clear_cancellation_slot(st);
+        st.handler_(static_cast<const std::error_code&>(ec),
+            static_cast<const typename Protocol::endpoint&>(
+              st.endpoints_[index_]));
+        return;
+      }
+
+      // A failed attempt causes the next one to start immediately, unless the
+      // operation has been cancelled.
+      st.last_ec_ = st.cancelled_
+        ? std::error_code(std::experimental::net::v1::error::operation_aborted)
+        : ec;
+      if (!st.cancelled_ && st.next_ < st.endpoints_.size())
+        start_next(state_);
+      else if (st.in_flight_ == 0)
+      {
+        st.done_ = true;
+        lock.unlock();
+
+        clear_cancellation_slot(st);
+        st.handler_(static_cast<const std::error_code&>(st.last_ec_),
+            static_cast<const typename Protocol::endpoint&>(
+              typename Protocol::endpoint()));
+      }
+    }
+
+  //private:
+    // Handler installed in the cancellation slot associated with the user's
+    // handler. It does not keep the operation alive.
+    class cancellation_handler
+    {
+    public:
+      explicit cancellation_handler(const shared_ptr<state_type>& state)
+        : state_(state)
+      {
+      }
+
+      void operator()()
+      {
+        if (shared_ptr<state_type> state = state_.lock())
+          state->cancel();
+      }
+
+    private:
+      weak_ptr<state_type> state_;
+    };
+
+    // Remove the cancellation handler before the user's handler is invoked.
+    static void clear_cancellation_slot(state_type& st)
+    {
+      typename associated_cancellation_slot<RangeConnectHandler>::type slot =
+        (get_associated_cancellation_slot)(st.handler_);
+      if (slot.is_connected())
+        slot.clear();
+    }
+
+    // The index used to identify the attempt timer.
+    static std::size_t timer_index()
+    {
+      return ~std::size_t(0);
+    }
+
+    // Start an attempt for the next endpoint and restart the attempt timer.
+    // The state's mutex must be held by the caller.
+    static void start_next(const shared_ptr<state_type>& state)
+    {
+      std::size_t index = state->next_++;
+      state->attempts_[index] = new typename state_type::attempt_socket(
+          state->socket_.get_executor().context());
+      state->attempts_[index]->async_connect(state->endpoints_[index],
+          staggered_connect_op(state, index));
+      ++state->in_flight_;
+
+      if (state->next_ < state->endpoints_.size())
+      {
+        state->timer_.expires_after(state->attempt_delay_);
+        state->timer_.async_wait(staggered_connect_op(state, timer_index()));
+      }
+      else
+        state->timer_.cancel();
+    }
+
+    shared_ptr<state_type> state_;
+    std::size_t index_;
+  };
+
+  template <typename Protocol NET_TS_SVC_TPARAM, typename RangeConnectHandler>
+  inline void* networking_ts_handler_allocate(std::size_t size,
+      staggered_connect_op<Protocol NET_TS_SVC_TARG,
+        RangeConnectHandler>* this_handler)
+  {
+    return networking_ts_handler_alloc_helpers::allocate(
+        size, this_handler->state_->handler_);
+  }
+
+  template <typename Protocol NET_TS_SVC_TPARAM, typename RangeConnectHandler>
+  inline void networking_ts_handler_deallocate(void* pointer, std::size_t size,
+      staggered_connect_op<Protocol NET_TS_SVC_TARG,
+        RangeConnectHandler>* this_handler)
+  {
+    networking_ts_handler_alloc_helpers::deallocate(
+        pointer, size, this_handler->state_->handler_);
+  }
+
+  template <typename Protocol NET_TS_SVC_TPARAM, typename RangeConnectHandler>
+  inline bool networking_ts_handler_is_continuation(
+      staggered_connect_op<Protocol NET_TS_SVC_TARG,
+        RangeConnectHandler>* this_handler)
+  {
+    return networking_ts_handler_cont_helpers::is_continuation(
+        this_handler->state_->handler_);
+  }
+
+  template <typename Function, typename Protocol
+      NET_TS_SVC_TPARAM, typename RangeConnectHandler>
+  inline void networking_ts_handler_invoke(Function& function,
+      staggered_connect_op<Protocol NET_TS_SVC_TARG,
+        RangeConnectHandler>* this_handler)
+  {
+    networking_ts_handler_invoke_helpers::invoke(
+        function, this_handler->state_->handler_);
+  }
+
+  template <typename Function, typename Protocol
+      NET_TS_SVC_TPARAM, typename RangeConnectHandler>
+  inline void networking_ts_handler_invoke(const Function& function,
+      staggered_connect_op<Protocol NET_TS_SVC_TARG,
+        RangeConnectHandler>* this_handler)
+  {
+    networking_ts_handler_invoke_helpers::invoke(
+        function, this_handler->state_->handler_);
+  }
+#endif // defined(NET_TS_HAS_CHRONO) && defined(NET_TS_HAS_MOVE)
 } // namespace detail
 
 #if !defined(GENERATING_DOCUMENTATION)
@@ -648,6 +948,50 @@ struct associated_executor<
   }
 };
 
+#if defined(NET_TS_HAS_CHRONO) && defined(NET_TS_HAS_MOVE)
+
+template <typename Protocol NET_TS_SVC_TPARAM,
+    typename RangeConnectHandler, typename Allocator>
+struct associated_allocator<
+    detail::staggered_connect_op<Protocol NET_TS_SVC_TARG,
+      RangeConnectHandler>,
+    Allocator>
+{
+  typedef typename associated_allocator<
+      RangeConnectHandler, Allocator>::type type;
+
+  static type get(
+      const detail::staggered_connect_op<Protocol NET_TS_SVC_TARG,
+        RangeConnectHandler>& h,
+      const Allocator& a = Allocator()) NET_TS_NOEXCEPT
+  {
+    return associated_allocator<RangeConnectHandler,
+        Allocator>::get(h.state_->handler_, a);
+  }
+};
+
+template <typename Protocol NET_TS_SVC_TPARAM,
+    typename RangeConnectHandler, typename Executor>
+struct associated_executor<
+    detail::staggered_connect_op<Protocol NET_TS_SVC_TARG,
+      RangeConnectHandler>,
+    Executor>
+{
+  typedef typename associated_executor<
+      RangeConnectHandler, Executor>::type type;
+
+  static type get(
+      const detail::staggered_connect_op<Protocol NET_TS_SVC_TARG,
+        RangeConnectHandler>& h,
+      const Executor& ex = Executor()) NET_TS_NOEXCEPT
+  {
+    return associated_executor<RangeConnectHandler,
+        Executor>::get(h.state_->handler_, ex);
+  }
+};
+
+#endif // defined(NET_TS_HAS_CHRONO) && defined(NET_TS_HAS_MOVE)
+
 #endif // !defined(GENERATING_DOCUMENTATION)
 
 template <typename Protocol NET_TS_SVC_TPARAM,
@@ -757,6 +1101,72 @@ async_connect(basic_socket<Protocol NET_TS_SVC_TARG>& s,
   return init.result.get();
 }
 
+#if defined(NET_TS_HAS_CHRONO) && defined(NET_TS_HAS_MOVE)
+
+template <typename Protocol NET_TS_SVC_TPARAM, typename EndpointSequence,
+    typename Rep, typename Period, typename RangeConnectHandler>
+inline NET_TS_INITFN_RESULT_TYPE(RangeConnectHandler,
+    void (std::error_code, typename Protocol::endpoint))
+async_connect_staggered(basic_socket<Protocol NET_TS_SVC_TARG>& s,
+    const EndpointSequence& endpoints,
+    const chrono::duration<Rep, Period>& attempt_delay,
+    NET_TS_MOVE_ARG(RangeConnectHandler) handler,
+    typename enable_if<is_endpoint_sequence<
+        EndpointSequence>::value>::type*)
+{
+  // If you get an error on the following line it means that your handler does
+  // not meet the documented type requirements for a RangeConnectHandler.
+  NET_TS_RANGE_CONNECT_HANDLER_CHECK(
+      RangeConnectHandler, handler, typename Protocol::endpoint) type_check;
+
+  async_completion<RangeConnectHandler,
+    void (std::error_code, typename Protocol::endpoint)>
+      init(handler);
+
+  typedef detail::staggered_connect_op<Protocol NET_TS_SVC_TARG,
+    NET_TS_HANDLER_TYPE(RangeConnectHandler,
+      void (std::error_code, typename Protocol::endpoint))> op;
+
+  if (endpoints.begin() == endpoints.end())
+  {
+    std::error_code ignored_ec;
+    s.close(ignored_ec);
+    std::experimental::net::v1::post(s.get_executor(),
+        detail::bind_handler(
+          NET_TS_MOVE_CAST(NET_TS_HANDLER_TYPE(RangeConnectHandler,
+            void (std::error_code, typename Protocol::endpoint)))(
+              init.completion_handler),
+          std::experimental::net::v1::error::not_found,
+          typename Protocol::endpoint()));
+    return init.result.get();
+  }
+
+  detail::shared_ptr<typename op::state_type> state(
+      new typename op::state_type(s, endpoints,
+        chrono::duration_cast<chrono::steady_clock::duration>(attempt_delay),
+        init.completion_handler));
+  op::start(state);
+
+  return init.result.get();
+}
+
+template <typename Protocol NET_TS_SVC_TPARAM,
+    typename EndpointSequence, typename RangeConnectHandler>
+inline NET_TS_INITFN_RESULT_TYPE(RangeConnectHandler,
+    void (std::error_code, typename Protocol::endpoint))
+async_connect_staggered(basic_socket<Protocol NET_TS_SVC_TARG>& s,
+    const EndpointSequence& endpoints,
+    NET_TS_MOVE_ARG(RangeConnectHandler) handler,
+    typename enable_if<is_endpoint_sequence<
+        EndpointSequence>::value>::type*)
+{
+  return (async_connect_staggered)(s, endpoints,
+      chrono::milliseconds(250),
+      NET_TS_MOVE_CAST(RangeConnectHandler)(handler));
+}
+
+#endif // defined(NET_TS_HAS_CHRONO) && defined(NET_TS_HAS_MOVE)
+
 } // inline namespace v1
 } // namespace net
 } // namespace experimental
@@ -35,24 +35,30 @@ inline namespace v1 {
 
 #if defined(NET_TS_HAS_MOVE)
 
-// Lightweight, move-only function object wrapper.
+// Lightweight, move-only function object wrapper. Small function objects are
+// stored within the wrapper itself.
 class executor::function
 {
 public:
   template <typename F, typename Alloc>
   explicit function(F f, const Alloc& a)
+    : func_(0),
+      move_(0)
   {
-    // Allocate and construct an operation to wrap the function.
-    typedef detail::executor_function<F, Alloc> func_type;
-    typename func_type::ptr p = {
-      detail::addressof(a), func_type::ptr::allocate(a), 0 };
-    func_ = new (p.v) func_type(NET_TS_MOVE_CAST(F)(f), a);
-    p.v = 0;
+    typedef detail::inline_executor_function<F> inline_func_type;
+    construct(NET_TS_MOVE_CAST(F)(f), a, integral_constant<bool,
+        sizeof(inline_func_type) <= sizeof(space_)
+          && alignment_of<inline_func_type>::value
+            <= alignment_of<void*>::value
+          && is_nothrow_move_constructible<F>::value>());
   }
 
   function(function&& other) NET_TS_NOEXCEPT
-    : func_(other.func_)
+    : func_(other.func_),
+      move_(other.move_)
   {
+    if (move_ && func_)
+      func_ = move_(func_, space_);
     other.func_ = 0;
   }
 
@@ -73,7 +79,33 @@ public:
   }
 
 private:
+  template <typename F, typename Alloc>
+  void construct(F f, const Alloc&, true_type)
+  {
+    // Construct the function object in place.
+    typedef detail::inline_executor_function<F> func_type;
+    func_ = new (space_) func_type(NET_TS_MOVE_CAST(F)(f));
+    move_ = &func_type::move;
+  }
+
+  template <typename F, typename Alloc>
+  void construct(F f, const Alloc& a, false_type)
+  {
+    // Allocate and construct an operation to wrap the function.
+    typedef detail::executor_function<F, Alloc> func_type;
+    typename func_type::ptr p = {
+      detail::addressof(a), func_type::ptr::allocate(a), 0 };
+    func_ = new (p.v) func_type(NET_TS_MOVE_CAST(F)(f), a);
+    p.v = 0;
+  }
+
+  // The number of pointers' worth of space available for inline storage.
+  enum { space_size = 6 };
+
   detail::executor_function_base* func_;
+  detail::executor_function_base* (*move_)(
+      detail::executor_function_base*, void*);
+  void* space_[space_size];
 };
 
 #else // defined(NET_TS_HAS_MOVE)
@@ -141,7 +173,7 @@ public:
     return p;
   }
 
-  impl(const Executor& e, const Allocator& a) NET_TS_NOEXCEPT
+  impl(const Executor& e, const Allocator& a)
     : impl_base(false),
       ref_count_(1),
       executor_(e),
@@ -149,12 +181,17 @@ public:
   {
   }
 
-  impl_base* clone() const NET_TS_NOEXCEPT
+  impl_base* clone(void*) const NET_TS_NOEXCEPT
   {
     ++ref_count_;
     return const_cast<impl_base*>(static_cast<const impl_base*>(this));
   }
 
+  impl_base* move(void*) NET_TS_NOEXCEPT
+  {
+    return this;
+  }
+
   void destroy() NET_TS_NOEXCEPT
   {
     if (--ref_count_ == 0)
@@ -266,11 +303,16 @@ public:
   {
   }
 
-  impl_base* clone() const NET_TS_NOEXCEPT
+  impl_base* clone(void*) const NET_TS_NOEXCEPT
   {
     return const_cast<impl_base*>(static_cast<const impl_base*>(this));
   }
 
+  impl_base* move(void*) NET_TS_NOEXCEPT
+  {
+    return this;
+  }
+
   void destroy() NET_TS_NOEXCEPT
   {
   }
@@ -330,16 +372,144 @@ private:
   Allocator allocator_;
 };
 
+// Polymorphic executor implementation stored within the executor object.
+template <typename Executor, typename Allocator>
+class executor::inline_impl
+  : public executor::impl_base
+{
+public:
+  inline_impl(const Executor& e, const Allocator& a) NET_TS_NOEXCEPT
+    : impl_base(false),
+      executor_(e),
+      allocator_(a)
+  {
+  }
+
+#if defined(NET_TS_HAS_MOVE)
+  inline_impl(Executor&& e, const Allocator& a) NET_TS_NOEXCEPT
+    : impl_base(false),
+      executor_(NET_TS_MOVE_CAST(Executor)(e)),
+      allocator_(a)
+  {
+  }
+#endif // defined(NET_TS_HAS_MOVE)
+
+  impl_base* clone(void* space) const NET_TS_NOEXCEPT
+  {
+    return new (space) inline_impl(executor_, allocator_);
+  }
+
+  impl_base* move(void* space) NET_TS_NOEXCEPT
+  {
+    impl_base* p = new (space) inline_impl(
+        NET_TS_MOVE_CAST(Executor)(executor_), allocator_);
+    this->~inline_impl();
+    return p;
+  }
+
+  void destroy() NET_TS_NOEXCEPT
+  {
+    this->~inline_impl();
+  }
+
+  void on_work_started() NET_TS_NOEXCEPT
+  {
+    executor_.on_work_started();
+  }
+
+  void on_work_finished() NET_TS_NOEXCEPT
+  {
+    executor_.on_work_finished();
+  }
+
+  execution_context& context() NET_TS_NOEXCEPT
+  {
+    return executor_.context();
+  }
+
+  void dispatch(NET_TS_MOVE_ARG(function) f)
+  {
+    executor_.dispatch(NET_TS_MOVE_CAST(function)(f), allocator_);
+  }
+
+  void post(NET_TS_MOVE_ARG(function) f)
+  {
+    executor_.post(NET_TS_MOVE_CAST(function)(f), allocator_);
+  }
+
+  void defer(NET_TS_MOVE_ARG(function) f)
+  {
+    executor_.defer(NET_TS_MOVE_CAST(function)(f), allocator_);
+  }
+
+  type_id_result_type target_type() const NET_TS_NOEXCEPT
+  {
+    return type_id<Executor>();
+  }
+
+  void* target() NET_TS_NOEXCEPT
+  {
+    return &executor_;
+  }
+
+  const void* target() const NET_TS_NOEXCEPT
+  {
+    return &executor_;
+  }
+
+  bool equals(const impl_base* e) const NET_TS_NOEXCEPT
+  {
+    if (this == e)
+      return true;
+    if (target_type() != e->target_type())
+      return false;
+    return executor_ == *static_cast<const Executor*>(e->target());
+  }
+
+private:
+  Executor executor_;
+  Allocator allocator_;
+};
+
 template <typename Executor>
 executor::executor(Executor e)
-  : impl_(impl<Executor, std::allocator<void> >::create(e))
+  : impl_(0)
 {
+  impl_ = create(e, std::allocator<void>());
 }
 
 template <typename Executor, typename Allocator>
 executor::executor(allocator_arg_t, const Allocator& a, Executor e)
-  : impl_(impl<Executor, Allocator>::create(e, a))
+  : impl_(0)
+{
+  impl_ = create(e, a);
+}
+
+template <typename Executor, typename Allocator>
+executor::impl_base* executor::create(const Executor& e, const Allocator& a)
+{
+  typedef inline_impl<Executor, Allocator> inline_impl_type;
+  return create(e, a, integral_constant<bool,
+      !is_same<Executor, system_executor>::value
+        && sizeof(inline_impl_type) <= sizeof(space_)
+        && alignment_of<inline_impl_type>::value
+          <= alignment_of<void*>::value
+        && is_nothrow_copy_constructible<Executor>::value
+        && is_nothrow_move_constructible<Executor>::value>());
+}
+
+template <typename Executor, typename Allocator>
+executor::impl_base* executor::create(
+    const Executor& e, const Allocator& a, true_type)
+{
+  return new (space_) inline_impl<Executor, Allocator>(e, a);
+}
+
+template <typename Executor, typename Allocator>
+executor::impl_base* executor::create(
+    const Executor& e, const Allocator& a, false_type)
 {
+  return impl<Executor, Allocator>::create(e, a);
 }
 
 template <typename Function, typename Allocator>
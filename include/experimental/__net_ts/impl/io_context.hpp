@@ -15,11 +15,14 @@
 # pragma once
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
+#include <iterator>
 #include <experimental/__net_ts/detail/completion_handler.hpp>
 #include <experimental/__net_ts/detail/executor_op.hpp>
 #include <experimental/__net_ts/detail/fenced_block.hpp>
 #include <experimental/__net_ts/detail/handler_type_requirements.hpp>
+#include <experimental/__net_ts/detail/op_queue.hpp>
 #include <experimental/__net_ts/detail/recycling_allocator.hpp>
+#include <experimental/__net_ts/detail/scheduler_allocator.hpp>
 #include <experimental/__net_ts/detail/service_registry.hpp>
 #include <experimental/__net_ts/detail/throw_error.hpp>
 #include <experimental/__net_ts/detail/type_traits.hpp>
@@ -83,6 +86,13 @@ std::size_t io_context::run_for(
   return this->run_until(chrono::steady_clock::now() + rel_time);
 }
 
+template <typename Rep, typename Period>
+void io_context::spin_budget(const chrono::duration<Rep, Period>& budget)
+{
+  impl_.set_spin_budget(static_cast<long>(
+        chrono::duration_cast<chrono::microseconds>(budget).count()));
+}
+
 template <typename Clock, typename Duration>
 std::size_t io_context::run_until(
     const chrono::time_point<Clock, Duration>& abs_time)
@@ -165,9 +175,12 @@ void io_context::executor_type::dispatch(
   }
 
   // Allocate and construct an operation to wrap the function.
-  typedef detail::executor_op<function_type, Allocator, detail::operation> op;
-  typename op::ptr p = { detail::addressof(a), op::ptr::allocate(a), 0 };
-  p.p = new (p.v) op(NET_TS_MOVE_CAST(Function)(f), a);
+  typedef detail::get_scheduler_allocator<Allocator> get_alloc;
+  const typename get_alloc::type& a1 = get_alloc::get(a, io_context_.impl_);
+  typedef detail::executor_op<function_type,
+    typename get_alloc::type, detail::operation> op;
+  typename op::ptr p = { detail::addressof(a1), op::ptr::allocate(a1), 0 };
+  p.p = new (p.v) op(NET_TS_MOVE_CAST(Function)(f), a1);
 
   NET_TS_HANDLER_CREATION((this->context(), *p.p,
         "io_context", &this->context(), 0, "dispatch"));
@@ -183,9 +196,12 @@ void io_context::executor_type::post(
   typedef typename decay<Function>::type function_type;
 
   // Allocate and construct an operation to wrap the function.
-  typedef detail::executor_op<function_type, Allocator, detail::operation> op;
-  typename op::ptr p = { detail::addressof(a), op::ptr::allocate(a), 0 };
-  p.p = new (p.v) op(NET_TS_MOVE_CAST(Function)(f), a);
+  typedef detail::get_scheduler_allocator<Allocator> get_alloc;
+  const typename get_alloc::type& a1 = get_alloc::get(a, io_context_.impl_);
+  typedef detail::executor_op<function_type,
+    typename get_alloc::type, detail::operation> op;
+  typename op::ptr p = { detail::addressof(a1), op::ptr::allocate(a1), 0 };
+  p.p = new (p.v) op(NET_TS_MOVE_CAST(Function)(f), a1);
 
   NET_TS_HANDLER_CREATION((this->context(), *p.p,
         "io_context", &this->context(), 0, "post"));
@@ -194,6 +210,37 @@ void io_context::executor_type::post(
   p.v = p.p = 0;
 }
 
+template <typename InputIterator, typename Allocator>
+void io_context::executor_type::bulk_post(
+    InputIterator first, InputIterator last, const Allocator& a) const
+{
+  typedef typename decay<
+    typename std::iterator_traits<InputIterator>::value_type>::type
+      function_type;
+
+  // Allocate and construct an operation to wrap each function. The queue
+  // destroys any operations already constructed if an exception is thrown.
+  typedef detail::get_scheduler_allocator<Allocator> get_alloc;
+  const typename get_alloc::type& a1 = get_alloc::get(a, io_context_.impl_);
+  typedef detail::executor_op<function_type,
+    typename get_alloc::type, detail::operation> op;
+  detail::op_queue<detail::operation> ops;
+  std::size_t n = 0;
+  for (; first != last; ++first, ++n)
+  {
+    typename op::ptr p = { detail::addressof(a1), op::ptr::allocate(a1), 0 };
+    p.p = new (p.v) op(*first, a1);
+
+    NET_TS_HANDLER_CREATION((this->context(), *p.p,
+          "io_context", &this->context(), 0, "bulk_post"));
+
+    ops.push(p.p);
+    p.v = p.p = 0;
+  }
+
+  io_context_.impl_.post_immediate_completions(ops, n);
+}
+
 template <typename Function, typename Allocator>
 void io_context::executor_type::defer(
     NET_TS_MOVE_ARG(Function) f, const Allocator& a) const
@@ -201,9 +248,12 @@ void io_context::executor_type::defer(
   typedef typename decay<Function>::type function_type;
 
   // Allocate and construct an operation to wrap the function.
-  typedef detail::executor_op<function_type, Allocator, detail::operation> op;
-  typename op::ptr p = { detail::addressof(a), op::ptr::allocate(a), 0 };
-  p.p = new (p.v) op(NET_TS_MOVE_CAST(Function)(f), a);
+  typedef detail::get_scheduler_allocator<Allocator> get_alloc;
+  const typename get_alloc::type& a1 = get_alloc::get(a, io_context_.impl_);
+  typedef detail::executor_op<function_type,
+    typename get_alloc::type, detail::operation> op;
+  typename op::ptr p = { detail::addressof(a1), op::ptr::allocate(a1), 0 };
+  p.p = new (p.v) op(NET_TS_MOVE_CAST(Function)(f), a1);
 
   NET_TS_HANDLER_CREATION((this->context(), *p.p,
         "io_context", &this->context(), 0, "defer"));
@@ -218,6 +268,53 @@ io_context::executor_type::running_in_this_thread() const NET_TS_NOEXCEPT
   return io_context_.impl_.can_dispatch();
 }
 
+inline io_context::producer::producer(
+    std::experimental::net::v1::io_context& io_context, std::size_t capacity)
+  : io_context_(io_context),
+    ring_(capacity)
+{
+  io_context_.impl_.register_injection_ring(ring_);
+}
+
+inline io_context::producer::~producer()
+{
+  io_context_.impl_.deregister_injection_ring(ring_);
+}
+
+inline io_context& io_context::producer::context() const NET_TS_NOEXCEPT
+{
+  return io_context_;
+}
+
+inline std::size_t io_context::producer::capacity() const NET_TS_NOEXCEPT
+{
+  return ring_.capacity();
+}
+
+template <typename Function>
+void io_context::producer::post(NET_TS_MOVE_ARG(Function) f)
+{
+  this->post(NET_TS_MOVE_CAST(Function)(f), std::allocator<void>());
+}
+
+template <typename Function, typename Allocator>
+void io_context::producer::post(
+    NET_TS_MOVE_ARG(Function) f, const Allocator& a)
+{
+  typedef typename decay<Function>::type function_type;
+
+  // Allocate and construct an operation to wrap the function.
+  typedef detail::executor_op<function_type, Allocator, detail::operation> op;
+  typename op::ptr p = { detail::addressof(a), op::ptr::allocate(a), 0 };
+  p.p = new (p.v) op(NET_TS_MOVE_CAST(Function)(f), a);
+
+  NET_TS_HANDLER_CREATION((io_context_, *p.p,
+        "io_context", &io_context_, 0, "post"));
+
+  io_context_.impl_.post_injected_completion(ring_, p.p);
+  p.v = p.p = 0;
+}
+
 inline std::experimental::net::v1::io_context& io_context::service::get_io_context()
 {
   return static_cast<std::experimental::net::v1::io_context&>(context());
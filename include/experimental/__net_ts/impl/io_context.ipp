@@ -100,11 +100,53 @@ bool io_context::stopped() const
   return impl_.stopped();
 }
 
+std::size_t io_context::outstanding_work() const
+{
+  return impl_.outstanding_work();
+}
+
 void io_context::restart()
 {
   impl_.restart();
 }
 
+#if defined(NET_TS_HAS_CHRONO)
+chrono::microseconds io_context::spin_budget() const
+{
+  return chrono::microseconds(impl_.spin_budget());
+}
+
+chrono::steady_clock::time_point io_context::now() const
+{
+  return impl_.cached_now();
+}
+#endif // defined(NET_TS_HAS_CHRONO)
+
+io_context::spin_statistics io_context::get_spin_statistics() const
+{
+  return impl_.get_spin_statistics();
+}
+
+void io_context::inline_completion(bool enable)
+{
+  impl_.set_inline_completion(enable);
+}
+
+bool io_context::inline_completion() const
+{
+  return impl_.inline_completion();
+}
+
+void io_context::inline_completion_depth(std::size_t depth)
+{
+  impl_.set_inline_completion_depth(depth);
+}
+
+std::size_t io_context::inline_completion_depth() const
+{
+  return impl_.inline_completion_depth();
+}
+
 io_context::service::service(std::experimental::net::v1::io_context& owner)
   : execution_context::service(owner)
 {
@@ -0,0 +1,403 @@
+//
+// impl/light_future.hpp
+// ~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_IMPL_LIGHT_FUTURE_HPP
+#define NET_TS_IMPL_LIGHT_FUTURE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <tuple>
+#include <experimental/__net_ts/async_result.hpp>
+#include <experimental/__net_ts/detail/executor_function.hpp>
+#include <experimental/__net_ts/detail/light_future_state.hpp>
+#include <experimental/__net_ts/detail/memory.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+// A function object that passes a completed shared state, as a light_future,
+// to a user-supplied continuation.
+template <typename T, typename Function>
+class light_future_continuation
+{
+public:
+  light_future_continuation(light_future_state<T>* s,
+      NET_TS_MOVE_ARG(Function) f)
+    : function_(NET_TS_MOVE_CAST(Function)(f)),
+      state_(s)
+  {
+  }
+
+  light_future_continuation(light_future_continuation&& other)
+    : function_(NET_TS_MOVE_CAST(Function)(other.function_)),
+      state_(other.state_)
+  {
+    other.state_ = 0;
+  }
+
+  ~light_future_continuation()
+  {
+    if (state_)
+      state_->release();
+  }
+
+  void operator()()
+  {
+    light_future<T> result(state_);
+    state_ = 0;
+    function_(NET_TS_MOVE_CAST(light_future<T>)(result));
+  }
+
+private:
+  Function function_;
+  light_future_state<T>* state_;
+};
+
+// The base class for all completion handlers that create light futures. Each
+// copy of a handler holds a reference to the shared state.
+template <typename T>
+class light_future_creator
+{
+public:
+  typedef light_future<T> future_type;
+
+  light_future_creator(const light_future_creator& other) NET_TS_NOEXCEPT
+    : state_(other.state_)
+  {
+    if (state_)
+      state_->add_producer();
+  }
+
+  light_future_creator(light_future_creator&& other) NET_TS_NOEXCEPT
+    : state_(other.state_)
+  {
+    other.state_ = 0;
+  }
+
+  ~light_future_creator()
+  {
+    if (state_)
+      state_->release_producer();
+  }
+
+  future_type get_future()
+  {
+    state_->add_ref();
+    return future_type(state_);
+  }
+
+protected:
+  light_future_creator()
+    : state_(0)
+  {
+  }
+
+  template <typename Allocator>
+  void create_state(const Allocator& a)
+  {
+    state_ = light_future_state_impl<T, Allocator>::create(a);
+  }
+
+  light_future_state<T>* state_;
+
+private:
+  // Disallow assignment.
+  light_future_creator& operator=(const light_future_creator&) NET_TS_DELETED;
+};
+
+// For completion signature void().
+class light_future_handler_0
+  : public light_future_creator<void>
+{
+public:
+  void operator()()
+  {
+    this->state_->set_value();
+  }
+};
+
+// For completion signature void(error_code).
+class light_future_handler_ec_0
+  : public light_future_creator<void>
+{
+public:
+  void operator()(const std::error_code& ec)
+  {
+    if (ec)
+      this->state_->set_error(ec);
+    else
+      this->state_->set_value();
+  }
+};
+
+// For completion signature void(exception_ptr).
+class light_future_handler_ex_0
+  : public light_future_creator<void>
+{
+public:
+  void operator()(const std::exception_ptr& ex)
+  {
+    if (ex)
+      this->state_->set_exception(ex);
+    else
+      this->state_->set_value();
+  }
+};
+
+// For completion signature void(T).
+template <typename T>
+class light_future_handler_1
+  : public light_future_creator<T>
+{
+public:
+  template <typename Arg>
+  void operator()(NET_TS_MOVE_ARG(Arg) arg)
+  {
+    this->state_->set_value(NET_TS_MOVE_CAST(Arg)(arg));
+  }
+};
+
+// For completion signature void(error_code, T).
+template <typename T>
+class light_future_handler_ec_1
+  : public light_future_creator<T>
+{
+public:
+  template <typename Arg>
+  void operator()(const std::error_code& ec,
+      NET_TS_MOVE_ARG(Arg) arg)
+  {
+    if (ec)
+      this->state_->set_error(ec);
+    else
+      this->state_->set_value(NET_TS_MOVE_CAST(Arg)(arg));
+  }
+};
+
+// For completion signature void(exception_ptr, T).
+template <typename T>
+class light_future_handler_ex_1
+  : public light_future_creator<T>
+{
+public:
+  template <typename Arg>
+  void operator()(const std::exception_ptr& ex,
+      NET_TS_MOVE_ARG(Arg) arg)
+  {
+    if (ex)
+      this->state_->set_exception(ex);
+    else
+      this->state_->set_value(NET_TS_MOVE_CAST(Arg)(arg));
+  }
+};
+
+// For completion signature void(T1, ..., Tn);
+template <typename T>
+class light_future_handler_n
+  : public light_future_creator<T>
+{
+public:
+  template <typename... Args>
+  void operator()(NET_TS_MOVE_ARG(Args)... args)
+  {
+    this->state_->set_value(
+        std::forward_as_tuple(
+          NET_TS_MOVE_CAST(Args)(args)...));
+  }
+};
+
+// For completion signature void(error_code, T1, ..., Tn);
+template <typename T>
+class light_future_handler_ec_n
+  : public light_future_creator<T>
+{
+public:
+  template <typename... Args>
+  void operator()(const std::error_code& ec,
+      NET_TS_MOVE_ARG(Args)... args)
+  {
+    if (ec)
+      this->state_->set_error(ec);
+    else
+    {
+      this->state_->set_value(
+          std::forward_as_tuple(
+            NET_TS_MOVE_CAST(Args)(args)...));
+    }
+  }
+};
+
+// For completion signature void(exception_ptr, T1, ..., Tn);
+template <typename T>
+class light_future_handler_ex_n
+  : public light_future_creator<T>
+{
+public:
+  template <typename... Args>
+  void operator()(const std::exception_ptr& ex,
+      NET_TS_MOVE_ARG(Args)... args)
+  {
+    if (ex)
+      this->state_->set_exception(ex);
+    else
+    {
+      this->state_->set_value(
+          std::forward_as_tuple(
+            NET_TS_MOVE_CAST(Args)(args)...));
+    }
+  }
+};
+
+// Helper template to choose the appropriate concrete light future handler
+// implementation based on the supplied completion signature.
+template <typename> class light_future_handler_selector;
+
+template <>
+class light_future_handler_selector<void()>
+  : public light_future_handler_0 {};
+
+template <>
+class light_future_handler_selector<void(std::error_code)>
+  : public light_future_handler_ec_0 {};
+
+template <>
+class light_future_handler_selector<void(std::exception_ptr)>
+  : public light_future_handler_ex_0 {};
+
+template <typename Arg>
+class light_future_handler_selector<void(Arg)>
+  : public light_future_handler_1<Arg> {};
+
+template <typename Arg>
+class light_future_handler_selector<void(std::error_code, Arg)>
+  : public light_future_handler_ec_1<Arg> {};
+
+template <typename Arg>
+class light_future_handler_selector<void(std::exception_ptr, Arg)>
+  : public light_future_handler_ex_1<Arg> {};
+
+template <typename... Arg>
+class light_future_handler_selector<void(Arg...)>
+  : public light_future_handler_n<std::tuple<Arg...> > {};
+
+template <typename... Arg>
+class light_future_handler_selector<void(std::error_code, Arg...)>
+  : public light_future_handler_ec_n<std::tuple<Arg...> > {};
+
+template <typename... Arg>
+class light_future_handler_selector<void(std::exception_ptr, Arg...)>
+  : public light_future_handler_ex_n<std::tuple<Arg...> > {};
+
+// Completion handlers produced from the use_light_future completion token.
+template <typename Signature, typename Allocator>
+class light_future_handler
+  : public light_future_handler_selector<Signature>
+{
+public:
+  typedef Allocator allocator_type;
+  typedef void result_type;
+
+  light_future_handler(use_light_future_t<Allocator> u)
+    : allocator_(u.get_allocator())
+  {
+    this->create_state(allocator_);
+  }
+
+  allocator_type get_allocator() const NET_TS_NOEXCEPT
+  {
+    return allocator_;
+  }
+
+private:
+  Allocator allocator_;
+};
+
+// Helper base class for async_result specialisation.
+template <typename Signature, typename Allocator>
+class light_future_async_result
+{
+public:
+  typedef light_future_handler<Signature, Allocator> completion_handler_type;
+  typedef typename completion_handler_type::future_type return_type;
+
+  explicit light_future_async_result(completion_handler_type& h)
+    : future_(h.get_future())
+  {
+  }
+
+  return_type get()
+  {
+    return NET_TS_MOVE_CAST(return_type)(future_);
+  }
+
+private:
+  return_type future_;
+};
+
+} // namespace detail
+
+template <typename T> template <typename Function>
+void light_future<T>::then(NET_TS_MOVE_ARG(Function) f)
+{
+  typedef typename decay<Function>::type function_type;
+  typedef detail::light_future_continuation<T, function_type> continuation;
+  typedef typename associated_allocator<function_type>::type allocator_type;
+  typedef detail::executor_function<continuation, allocator_type> func_type;
+
+  // Allocate and construct an operation to wrap the continuation.
+  allocator_type a((get_associated_allocator)(f));
+  typename func_type::ptr p = {
+    detail::addressof(a), func_type::ptr::allocate(a), 0 };
+  continuation c(state_, NET_TS_MOVE_CAST(Function)(f));
+  detail::light_future_state<T>* s = state_;
+  state_ = 0;
+  func_type* func = new (p.v) func_type(
+      NET_TS_MOVE_CAST(continuation)(c), a);
+  p.v = 0;
+
+  s->set_continuation(func);
+}
+
+#if !defined(GENERATING_DOCUMENTATION)
+
+template <typename Allocator, typename Result, typename... Args>
+class async_result<use_light_future_t<Allocator>, Result(Args...)>
+  : public detail::light_future_async_result<
+      void(typename decay<Args>::type...), Allocator>
+{
+public:
+  explicit async_result(
+    typename detail::light_future_async_result<
+      void(typename decay<Args>::type...),
+        Allocator>::completion_handler_type& h)
+    : detail::light_future_async_result<
+        void(typename decay<Args>::type...), Allocator>(h)
+  {
+  }
+};
+
+#endif // !defined(GENERATING_DOCUMENTATION)
+
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_IMPL_LIGHT_FUTURE_HPP
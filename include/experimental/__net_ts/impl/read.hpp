@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <experimental/__net_ts/associated_allocator.hpp>
+#include <experimental/__net_ts/associated_cancellation_slot.hpp>
 #include <experimental/__net_ts/associated_executor.hpp>
 #include <experimental/__net_ts/buffer.hpp>
 #include <experimental/__net_ts/completion_condition.hpp>
@@ -367,6 +368,27 @@ struct associated_executor<
   }
 };
 
+template <typename AsyncReadStream, typename MutableBufferSequence,
+    typename MutableBufferIterator, typename CompletionCondition,
+    typename ReadHandler, typename CancellationSlot>
+struct associated_cancellation_slot<
+    detail::read_op<AsyncReadStream, MutableBufferSequence,
+      MutableBufferIterator, CompletionCondition, ReadHandler>,
+    CancellationSlot>
+{
+  typedef typename associated_cancellation_slot<ReadHandler,
+    CancellationSlot>::type type;
+
+  static type get(
+      const detail::read_op<AsyncReadStream, MutableBufferSequence,
+        MutableBufferIterator, CompletionCondition, ReadHandler>& h,
+      const CancellationSlot& s = CancellationSlot()) NET_TS_NOEXCEPT
+  {
+    return associated_cancellation_slot<ReadHandler,
+        CancellationSlot>::get(h.handler_, s);
+  }
+};
+
 #endif // !defined(GENERATING_DOCUMENTATION)
 
 template <typename AsyncReadStream, typename MutableBufferSequence,
@@ -596,6 +618,26 @@ struct associated_executor<
   }
 };
 
+template <typename AsyncReadStream, typename DynamicBuffer,
+    typename CompletionCondition, typename ReadHandler, typename CancellationSlot>
+struct associated_cancellation_slot<
+    detail::read_dynbuf_op<AsyncReadStream,
+      DynamicBuffer, CompletionCondition, ReadHandler>,
+    CancellationSlot>
+{
+  typedef typename associated_cancellation_slot<ReadHandler,
+    CancellationSlot>::type type;
+
+  static type get(
+      const detail::read_dynbuf_op<AsyncReadStream,
+        DynamicBuffer, CompletionCondition, ReadHandler>& h,
+      const CancellationSlot& s = CancellationSlot()) NET_TS_NOEXCEPT
+  {
+    return associated_cancellation_slot<ReadHandler,
+        CancellationSlot>::get(h.handler_, s);
+  }
+};
+
 #endif // !defined(GENERATING_DOCUMENTATION)
 
 template <typename AsyncReadStream,
@@ -20,6 +20,7 @@
 #include <vector>
 #include <utility>
 #include <experimental/__net_ts/associated_allocator.hpp>
+#include <experimental/__net_ts/associated_cancellation_slot.hpp>
 #include <experimental/__net_ts/associated_executor.hpp>
 #include <experimental/__net_ts/buffer.hpp>
 #include <experimental/__net_ts/buffers_iterator.hpp>
@@ -420,6 +421,26 @@ struct associated_executor<
   }
 };
 
+template <typename AsyncReadStream, typename DynamicBuffer,
+    typename ReadHandler, typename CancellationSlot>
+struct associated_cancellation_slot<
+    detail::read_until_delim_op<AsyncReadStream,
+      DynamicBuffer, ReadHandler>,
+    CancellationSlot>
+{
+  typedef typename associated_cancellation_slot<ReadHandler,
+    CancellationSlot>::type type;
+
+  static type get(
+      const detail::read_until_delim_op<AsyncReadStream,
+        DynamicBuffer, ReadHandler>& h,
+      const CancellationSlot& s = CancellationSlot()) NET_TS_NOEXCEPT
+  {
+    return associated_cancellation_slot<ReadHandler,
+        CancellationSlot>::get(h.handler_, s);
+  }
+};
+
 #endif // !defined(GENERATING_DOCUMENTATION)
 
 template <typename AsyncReadStream,
@@ -673,6 +694,26 @@ struct associated_executor<
   }
 };
 
+template <typename AsyncReadStream, typename DynamicBuffer,
+    typename ReadHandler, typename CancellationSlot>
+struct associated_cancellation_slot<
+    detail::read_until_delim_string_op<AsyncReadStream,
+      DynamicBuffer, ReadHandler>,
+    CancellationSlot>
+{
+  typedef typename associated_cancellation_slot<ReadHandler,
+    CancellationSlot>::type type;
+
+  static type get(
+      const detail::read_until_delim_string_op<AsyncReadStream,
+        DynamicBuffer, ReadHandler>& h,
+      const CancellationSlot& s = CancellationSlot()) NET_TS_NOEXCEPT
+  {
+    return associated_cancellation_slot<ReadHandler,
+        CancellationSlot>::get(h.handler_, s);
+  }
+};
+
 #endif // !defined(GENERATING_DOCUMENTATION)
 
 template <typename AsyncReadStream,
@@ -19,19 +19,26 @@
 # error Do not compile Asio library source with NET_TS_HEADER_ONLY defined
 #endif
 
+#include <experimental/__net_ts/impl/cancellation_signal.ipp>
 #include <experimental/__net_ts/impl/error.ipp>
 #include <experimental/__net_ts/impl/execution_context.ipp>
 #include <experimental/__net_ts/impl/executor.ipp>
 #include <experimental/__net_ts/impl/handler_alloc_hook.ipp>
 #include <experimental/__net_ts/impl/io_context.ipp>
 #include <experimental/__net_ts/impl/system_context.ipp>
+#include <experimental/__net_ts/impl/thread_placement.ipp>
 #include <experimental/__net_ts/impl/thread_pool.ipp>
+#include <experimental/__net_ts/detail/impl/async_event_impl.ipp>
+#include <experimental/__net_ts/detail/impl/async_semaphore_impl.ipp>
+#include <experimental/__net_ts/detail/impl/async_wait_queue.ipp>
 #include <experimental/__net_ts/detail/impl/buffer_sequence_adapter.ipp>
 #include <experimental/__net_ts/detail/impl/descriptor_ops.ipp>
 #include <experimental/__net_ts/detail/impl/dev_poll_reactor.ipp>
+#include <experimental/__net_ts/detail/impl/dns_ops.ipp>
 #include <experimental/__net_ts/detail/impl/epoll_reactor.ipp>
 #include <experimental/__net_ts/detail/impl/eventfd_select_interrupter.ipp>
 #include <experimental/__net_ts/detail/impl/handler_tracking.ipp>
+#include <experimental/__net_ts/detail/impl/idle_tracker_state.ipp>
 #include <experimental/__net_ts/detail/impl/kqueue_reactor.ipp>
 #include <experimental/__net_ts/detail/impl/null_event.ipp>
 #include <experimental/__net_ts/detail/impl/pipe_select_interrupter.ipp>
@@ -16,6 +16,10 @@
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
 #include <experimental/__net_ts/detail/config.hpp>
+#include <cstdio>
+#include <experimental/__net_ts/detail/mutex.hpp>
+#include <experimental/__net_ts/detail/throw_error.hpp>
+#include <experimental/__net_ts/error.hpp>
 #include <experimental/__net_ts/system_context.hpp>
 
 #include <experimental/__net_ts/detail/push_options.hpp>
@@ -25,13 +29,43 @@ namespace experimental {
 namespace net {
 inline namespace v1 {
 
+struct system_context::options_state
+{
+  options_state()
+    : created_(false)
+  {
+  }
+
+  detail::mutex mutex_;
+  options options_;
+  bool created_;
+};
+
 struct system_context::thread_function
 {
   detail::scheduler* scheduler_;
+  const options* options_;
+  std::size_t index_;
 
   void operator()()
   {
+    if (!options_->thread_name.empty())
+    {
+      char index[32];
+      std::sprintf(index, "%lu", static_cast<unsigned long>(index_));
+      set_this_thread_name(options_->thread_name + index);
+    }
+
     std::error_code ec;
+    if (!options_->cpu_sets.empty())
+    {
+      bind_this_thread(options_->cpu_sets[
+          index_ % options_->cpu_sets.size()], ec);
+    }
+
+    if (options_->numa_local_memory)
+      bind_this_thread_memory(this_thread_numa_node(), ec);
+
     scheduler_->run(ec);
   }
 };
@@ -39,11 +73,26 @@ struct system_context::thread_function
 system_context::system_context()
   : scheduler_(use_service<detail::scheduler>(*this))
 {
+  options_state& state = get_options_state();
+  detail::mutex::scoped_lock lock(state.mutex_);
+  options_ = state.options_;
+  state.created_ = true;
+  lock.unlock();
+
   scheduler_.work_started();
 
-  thread_function f = { &scheduler_ };
-  std::size_t num_threads = detail::thread::hardware_concurrency() * 2;
-  threads_.create_threads(f, num_threads ? num_threads : 2);
+  std::size_t num_threads = options_.threads;
+  if (num_threads == 0)
+  {
+    num_threads = detail::thread::hardware_concurrency() * 2;
+    num_threads = num_threads ? num_threads : 2;
+  }
+
+  for (std::size_t i = 0; i < num_threads; ++i)
+  {
+    thread_function f = { &scheduler_, &options_, i };
+    threads_.create_thread(f);
+  }
 }
 
 system_context::~system_context()
@@ -69,6 +118,40 @@ void system_context::join()
   threads_.join();
 }
 
+void system_context::set_options(const options& o)
+{
+  std::error_code ec;
+  set_options(o, ec);
+  std::experimental::net::v1::detail::throw_error(ec, "set_options");
+}
+
+void system_context::set_options(const options& o, std::error_code& ec)
+{
+  options_state& state = get_options_state();
+  detail::mutex::scoped_lock lock(state.mutex_);
+  if (state.created_)
+  {
+    ec = std::experimental::net::v1::error::already_started;
+    return;
+  }
+
+  state.options_ = o;
+  ec = std::error_code();
+}
+
+system_context::options system_context::get_options()
+{
+  options_state& state = get_options_state();
+  detail::mutex::scoped_lock lock(state.mutex_);
+  return state.options_;
+}
+
+system_context::options_state& system_context::get_options_state()
+{
+  static options_state state;
+  return state;
+}
+
 } // inline namespace v1
 } // namespace net
 } // namespace experimental
@@ -0,0 +1,288 @@
+//
+// impl/thread_placement.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_IMPL_THREAD_PLACEMENT_IPP
+#define NET_TS_IMPL_THREAD_PLACEMENT_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <experimental/__net_ts/detail/thread.hpp>
+#include <experimental/__net_ts/detail/throw_error.hpp>
+#include <experimental/__net_ts/error.hpp>
+#include <experimental/__net_ts/thread_placement.hpp>
+
+#if defined(__linux__)
+# include <pthread.h>
+# include <sched.h>
+# include <unistd.h>
+# include <sys/syscall.h>
+#elif defined(__MACH__) && defined(__APPLE__)
+# include <pthread.h>
+#elif defined(NET_TS_WINDOWS) && !defined(NET_TS_WINDOWS_APP)
+# include <experimental/__net_ts/detail/socket_types.hpp>
+#endif
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+#if defined(__linux__)
+// Parse a list such as "0-3,8,10-11" into a set of processors.
+inline void parse_cpu_list(const char* s, cpu_set& cpus)
+{
+  while (*s)
+  {
+    char* end = 0;
+    unsigned long first = std::strtoul(s, &end, 10);
+    if (end == s)
+      break;
+    unsigned long last = first;
+    s = end;
+    if (*s == '-')
+    {
+      last = std::strtoul(s + 1, &end, 10);
+      if (end == s + 1)
+        break;
+      s = end;
+    }
+    for (unsigned long cpu = first; cpu <= last; ++cpu)
+      cpus.add(cpu);
+    if (*s != ',')
+      break;
+    ++s;
+  }
+}
+
+// Read a list from a file in sysfs. Returns false if the file cannot be read.
+inline bool read_cpu_list(const char* path, cpu_set& cpus)
+{
+  std::FILE* f = std::fopen(path, "r");
+  if (!f)
+    return false;
+  char buf[4096];
+  bool ok = std::fgets(buf, sizeof(buf), f) != 0;
+  std::fclose(f);
+  if (ok)
+    parse_cpu_list(buf, cpus);
+  return ok;
+}
+#endif // defined(__linux__)
+
+} // namespace detail
+
+cpu_set cpu_set::available()
+{
+  cpu_set cpus;
+#if defined(__linux__)
+  for (std::size_t size = CPU_SETSIZE; size <= (1u << 16); size *= 2)
+  {
+    cpu_set_t* set = CPU_ALLOC(size);
+    if (!set)
+      break;
+    std::size_t bytes = CPU_ALLOC_SIZE(size);
+    if (::sched_getaffinity(0, bytes, set) == 0)
+    {
+      for (std::size_t cpu = 0; cpu < size; ++cpu)
+        if (CPU_ISSET_S(cpu, bytes, set))
+          cpus.add(cpu);
+      CPU_FREE(set);
+      return cpus;
+    }
+    CPU_FREE(set);
+    if (errno != EINVAL)
+      break;
+  }
+#endif // defined(__linux__)
+
+  // Fall back to assuming that all processors are available.
+  std::size_t n = detail::thread::hardware_concurrency();
+  for (std::size_t cpu = 0; cpu < (n ? n : 1); ++cpu)
+    cpus.add(cpu);
+  return cpus;
+}
+
+cpu_set cpu_set::numa_node(std::size_t node)
+{
+  std::error_code ec;
+  cpu_set cpus = cpu_set::numa_node(node, ec);
+  std::experimental::net::v1::detail::throw_error(ec, "numa_node");
+  return cpus;
+}
+
+cpu_set cpu_set::numa_node(std::size_t node, std::error_code& ec)
+{
+  cpu_set cpus;
+#if defined(__linux__)
+  char path[128];
+  std::sprintf(path, "/sys/devices/system/node/node%lu/cpulist",
+      static_cast<unsigned long>(node));
+  if (detail::read_cpu_list(path, cpus))
+    ec = std::error_code();
+  else if (node == 0)
+  {
+    // Systems without NUMA support have a single node.
+    cpus = cpu_set::available();
+    ec = std::error_code();
+  }
+  else
+    ec = std::experimental::net::v1::error::invalid_argument;
+#else // defined(__linux__)
+  if (node == 0)
+  {
+    cpus = cpu_set::available();
+    ec = std::error_code();
+  }
+  else
+    ec = std::experimental::net::v1::error::invalid_argument;
+#endif // defined(__linux__)
+  return cpus;
+}
+
+void bind_this_thread(const cpu_set& cpus)
+{
+  std::error_code ec;
+  bind_this_thread(cpus, ec);
+  std::experimental::net::v1::detail::throw_error(ec, "bind_this_thread");
+}
+
+void bind_this_thread(const cpu_set& cpus, std::error_code& ec)
+{
+  if (cpus.empty())
+  {
+    ec = std::experimental::net::v1::error::invalid_argument;
+    return;
+  }
+
+#if defined(__linux__)
+  std::size_t size = cpus.limit();
+  cpu_set_t* set = CPU_ALLOC(size);
+  if (!set)
+  {
+    ec = std::experimental::net::v1::error::no_memory;
+    return;
+  }
+  std::size_t bytes = CPU_ALLOC_SIZE(size);
+  CPU_ZERO_S(bytes, set);
+  for (std::size_t cpu = 0; cpu < size; ++cpu)
+    if (cpus.contains(cpu))
+      CPU_SET_S(cpu, bytes, set);
+  int result = ::pthread_setaffinity_np(::pthread_self(), bytes, set);
+  CPU_FREE(set);
+  ec = std::error_code(result,
+      std::experimental::net::v1::error::get_system_category());
+#elif defined(NET_TS_WINDOWS) && !defined(NET_TS_WINDOWS_APP)
+  DWORD_PTR mask = 0;
+  for (std::size_t cpu = 0; cpu < cpus.limit(); ++cpu)
+  {
+    if (cpus.contains(cpu))
+    {
+      if (cpu >= sizeof(DWORD_PTR) * 8)
+      {
+        // Processors outside the first processor group cannot be named.
+        ec = std::experimental::net::v1::error::operation_not_supported;
+        return;
+      }
+      mask |= static_cast<DWORD_PTR>(1) << cpu;
+    }
+  }
+  if (::SetThreadAffinityMask(::GetCurrentThread(), mask) == 0)
+  {
+    DWORD last_error = ::GetLastError();
+    ec = std::error_code(last_error,
+        std::experimental::net::v1::error::get_system_category());
+  }
+  else
+    ec = std::error_code();
+#else
+  ec = std::experimental::net::v1::error::operation_not_supported;
+#endif
+}
+
+void bind_this_thread_memory(std::size_t node)
+{
+  std::error_code ec;
+  bind_this_thread_memory(node, ec);
+  std::experimental::net::v1::detail::throw_error(
+      ec, "bind_this_thread_memory");
+}
+
+void bind_this_thread_memory(std::size_t node, std::error_code& ec)
+{
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+  // Prefer the node, falling back to others when it has no free memory. The
+  // value is MPOL_PREFERRED, from <numaif.h>, which is not part of libc.
+  const int preferred = 1;
+  const std::size_t bits = sizeof(unsigned long) * 8;
+  std::vector<unsigned long> mask(node / bits + 1);
+  mask[node / bits] = 1ul << (node % bits);
+  if (::syscall(SYS_set_mempolicy, preferred, &mask[0],
+        static_cast<unsigned long>(mask.size() * bits + 1)) != 0)
+  {
+    ec = std::error_code(errno,
+        std::experimental::net::v1::error::get_system_category());
+  }
+  else
+    ec = std::error_code();
+#else // defined(__linux__) && defined(SYS_set_mempolicy)
+  (void)node;
+  ec = std::experimental::net::v1::error::operation_not_supported;
+#endif // defined(__linux__) && defined(SYS_set_mempolicy)
+}
+
+std::size_t this_thread_numa_node()
+{
+#if defined(__linux__) && defined(SYS_getcpu)
+  unsigned cpu = 0, node = 0;
+  if (::syscall(SYS_getcpu, &cpu, &node, 0) == 0)
+    return node;
+#endif // defined(__linux__) && defined(SYS_getcpu)
+  return 0;
+}
+
+std::size_t numa_node_count()
+{
+#if defined(__linux__)
+  cpu_set nodes;
+  if (detail::read_cpu_list("/sys/devices/system/node/online", nodes))
+    return nodes.limit() ? nodes.limit() : 1;
+#endif // defined(__linux__)
+  return 1;
+}
+
+void set_this_thread_name(const std::string& name)
+{
+#if defined(__linux__)
+  // Names are limited to 15 characters plus the terminator.
+  ::pthread_setname_np(::pthread_self(), name.substr(0, 15).c_str());
+#elif defined(__MACH__) && defined(__APPLE__)
+  ::pthread_setname_np(name.c_str());
+#else
+  (void)name;
+#endif
+}
+
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_IMPL_THREAD_PLACEMENT_IPP
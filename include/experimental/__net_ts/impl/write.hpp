@@ -16,6 +16,7 @@
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
 #include <experimental/__net_ts/associated_allocator.hpp>
+#include <experimental/__net_ts/associated_cancellation_slot.hpp>
 #include <experimental/__net_ts/associated_executor.hpp>
 #include <experimental/__net_ts/buffer.hpp>
 #include <experimental/__net_ts/completion_condition.hpp>
@@ -351,6 +352,27 @@ struct associated_executor<
   }
 };
 
+template <typename AsyncWriteStream, typename ConstBufferSequence,
+    typename ConstBufferIterator, typename CompletionCondition,
+    typename WriteHandler, typename CancellationSlot>
+struct associated_cancellation_slot<
+    detail::write_op<AsyncWriteStream, ConstBufferSequence,
+      ConstBufferIterator, CompletionCondition, WriteHandler>,
+    CancellationSlot>
+{
+  typedef typename associated_cancellation_slot<WriteHandler,
+    CancellationSlot>::type type;
+
+  static type get(
+      const detail::write_op<AsyncWriteStream, ConstBufferSequence,
+        ConstBufferIterator, CompletionCondition, WriteHandler>& h,
+      const CancellationSlot& s = CancellationSlot()) NET_TS_NOEXCEPT
+  {
+    return associated_cancellation_slot<WriteHandler,
+        CancellationSlot>::get(h.handler_, s);
+  }
+};
+
 #endif // !defined(GENERATING_DOCUMENTATION)
 
 template <typename AsyncWriteStream, typename ConstBufferSequence,
@@ -553,6 +575,26 @@ struct associated_executor<
   }
 };
 
+template <typename AsyncWriteStream, typename DynamicBuffer,
+    typename CompletionCondition, typename WriteHandler, typename CancellationSlot>
+struct associated_cancellation_slot<
+    detail::write_dynbuf_op<AsyncWriteStream,
+      DynamicBuffer, CompletionCondition, WriteHandler>,
+    CancellationSlot>
+{
+  typedef typename associated_cancellation_slot<WriteHandler,
+    CancellationSlot>::type type;
+
+  static type get(
+      const detail::write_dynbuf_op<AsyncWriteStream,
+        DynamicBuffer, CompletionCondition, WriteHandler>& h,
+      const CancellationSlot& s = CancellationSlot()) NET_TS_NOEXCEPT
+  {
+    return associated_cancellation_slot<WriteHandler,
+        CancellationSlot>::get(h.handler_, s);
+  }
+};
+
 #endif // !defined(GENERATING_DOCUMENTATION)
 
 template <typename AsyncWriteStream,
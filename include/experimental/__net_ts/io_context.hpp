@@ -20,7 +20,9 @@
 #include <stdexcept>
 #include <typeinfo>
 #include <experimental/__net_ts/async_result.hpp>
+#include <experimental/__net_ts/detail/injection_ring.hpp>
 #include <experimental/__net_ts/detail/noncopyable.hpp>
+#include <experimental/__net_ts/detail/spin_statistics.hpp>
 #include <experimental/__net_ts/detail/wrapped_handler.hpp>
 #include <system_error>
 #include <experimental/__net_ts/execution_context.hpp>
@@ -177,6 +179,21 @@ namespace detail {
  *   = std::experimental::net::make_work_guard(io_context);
  * ...
  * work.reset(); // Allow run() to exit. @endcode
+ *
+ * @par Posting from dedicated producer threads
+ *
+ * Posting a function object to the io_context locks the io_context's internal
+ * queue. Where a thread that does not run the io_context posts at a high rate,
+ * an io_context::producer object may be used instead. Each producer owns a
+ * bounded queue that is written without locking and that the threads running
+ * the io_context drain.
+ *
+ * @code std::experimental::net::io_context io_context;
+ * ...
+ * // In the feed handler thread:
+ * std::experimental::net::io_context::producer producer(io_context);
+ * for (;;)
+ *   producer.post([m = read_message()]{ process(m); }); @endcode
  */
 class io_context
   : public execution_context
@@ -191,11 +208,29 @@ public:
   class executor_type;
   friend class executor_type;
 
+  class producer;
+  friend class producer;
+
   class service;
 
   /// The type used to count the number of handlers executed by the context.
   typedef std::size_t count_type;
 
+  /// The type used to report how threads running the context waited for work.
+  /**
+   * The structure has the following members, each of type @c std::size_t:
+   *
+   * @li @c spins: The number of times a thread ran out of handlers to execute
+   * and started spinning.
+   *
+   * @li @c spin_hits: The number of spins that found a handler to execute
+   * before the spin budget was used up.
+   *
+   * @li @c parks: The number of times a thread blocked waiting for work. Only
+   * counted while a spin budget is set.
+   */
+  typedef detail::spin_statistics spin_statistics;
+
   /// Constructor.
   NET_TS_DECL io_context();
 
@@ -392,6 +427,18 @@ public:
    */
   NET_TS_DECL bool stopped() const;
 
+  /// Get the amount of unfinished work in the io_context.
+  /**
+   * Unfinished work consists of asynchronous operations that have not yet
+   * completed, handlers that are waiting to run, and outstanding work guards.
+   * When each connection keeps an operation outstanding, the value is a
+   * measure of how many connections the io_context is serving.
+   *
+   * @return The count of unfinished work. The value may be stale by the time
+   * it is used, if other threads are using the io_context.
+   */
+  NET_TS_DECL std::size_t outstanding_work() const;
+
   /// Restart the io_context in preparation for a subsequent run() invocation.
   /**
    * This function must be called prior to any second or later set of
@@ -405,6 +452,120 @@ public:
    */
   NET_TS_DECL void restart();
 
+#if defined(NET_TS_HAS_CHRONO) || defined(GENERATING_DOCUMENTATION)
+  /// Set the time for which a thread spins before blocking.
+  /**
+   * By default, a thread running the io_context that runs out of handlers to
+   * execute blocks until more work is available. Waking a blocked thread
+   * requires a system call, which adds to the latency of handlers posted from
+   * other threads and of I/O completions.
+   *
+   * Setting a non-zero spin budget causes threads in run() and run_one() to
+   * first poll for new handlers, and for I/O readiness without blocking, for
+   * up to the specified duration. This reduces latency at the expense of
+   * additional CPU time. The get_spin_statistics() function may be used to
+   * determine how often the spinning avoids blocking.
+   *
+   * @param budget The time for which a thread spins. A zero duration, the
+   * default, disables spinning.
+   *
+   * @note Spinning is disabled on systems with a single processor, where it
+   * would only delay the thread that is to provide the work, and on platforms
+   * that do not support it. In these cases the budget is recorded but has no
+   * effect.
+   */
+  template <typename Rep, typename Period>
+  void spin_budget(const chrono::duration<Rep, Period>& budget);
+
+  /// Get the time for which a thread spins before blocking.
+  NET_TS_DECL chrono::microseconds spin_budget() const;
+
+  /// Get the time of the steady clock, as cached by the io_context.
+  /**
+   * When called from a thread that is running the io_context, the steady
+   * clock is read at most once between the io_context starting to look for a
+   * handler and it next doing so, and after each time it blocks. The time is
+   * shared by all threads running the io_context. Handlers that set many
+   * timers may use this time as the base for their expiry times, rather than
+   * reading the clock for each timer:
+   *
+   * @code timer.expires_at(io_context.now() + std::chrono::seconds(5));
+   * @endcode
+   *
+   * When called from any other thread, the steady clock is read directly.
+   *
+   * @returns A time that never goes backwards, and that is no later than the
+   * current time of the steady clock.
+   *
+   * @note The time does not advance while a handler runs, and may have been
+   * read by a handler running concurrently on another thread. A timer whose
+   * expiry is based on the cached time may therefore expire early by up to
+   * the time those handlers have taken. Timer queues do not use the cached
+   * time, and always read the clock to decide which timers have expired.
+   *
+   * @note Where atomic operations are not available, the clock is read on
+   * each call.
+   */
+  NET_TS_DECL chrono::steady_clock::time_point now() const;
+#endif // defined(NET_TS_HAS_CHRONO) || defined(GENERATING_DOCUMENTATION)
+
+  /// Get the counts of spins and blocking waits.
+  /**
+   * The counts cover all threads that have run the io_context since it was
+   * constructed.
+   */
+  NET_TS_DECL spin_statistics get_spin_statistics() const;
+
+  /// Set whether operations that complete immediately invoke their handlers
+  /// inline.
+  /**
+   * By default, when an asynchronous operation is able to complete as soon
+   * as it is started, for example because data is already available to be
+   * received, its handler is queued for invocation by a thread running the
+   * io_context. Enabling inline completion causes such a handler to be
+   * invoked before the initiating function returns, provided that the
+   * initiating function is called from a thread running the io_context. This
+   * saves a trip through the handler queue for each operation.
+   *
+   * To bound the use of stack space, inline completions are nested to a depth
+   * of at most inline_completion_depth(). Beyond that depth, handlers are
+   * queued as usual.
+   *
+   * Inline completion may also be enabled for individual sockets using
+   * basic_socket::inline_completion().
+   *
+   * @param enable @c true to enable inline completion for all sockets
+   * associated with the io_context. The default is @c false.
+   *
+   * @note A handler that is invoked inline runs before the initiating
+   * function returns. Code that calls an initiating function must not assume
+   * that state it changes after the call is visible to the handler. Any
+   * exception thrown by the handler propagates out of the initiating function.
+   *
+   * @note This function must not be called while any thread is running the
+   * io_context. On platforms that use I/O completion ports the setting is
+   * recorded but has no effect.
+   */
+  NET_TS_DECL void inline_completion(bool enable);
+
+  /// Get whether operations that complete immediately invoke their handlers
+  /// inline.
+  NET_TS_DECL bool inline_completion() const;
+
+  /// Set the maximum depth of nested inline completions.
+  /**
+   * @param depth The number of inline completions that may be nested on the
+   * stack of a thread. The default is 8. A depth of zero disables inline
+   * completion.
+   *
+   * @note This function must not be called while any thread is running the
+   * io_context.
+   */
+  NET_TS_DECL void inline_completion_depth(std::size_t depth);
+
+  /// Get the maximum depth of nested inline completions.
+  NET_TS_DECL std::size_t inline_completion_depth() const;
+
 private:
   // Helper function to add the implementation.
   NET_TS_DECL impl_type& add_impl(impl_type* impl);
@@ -481,6 +642,32 @@ public:
   template <typename Function, typename Allocator>
   void post(NET_TS_MOVE_ARG(Function) f, const Allocator& a) const;
 
+  /// Request the io_context to invoke each of a sequence of function objects.
+  /**
+   * This function is used to ask the io_context to execute each function
+   * object in the range [first, last). It is equivalent to calling @c post()
+   * for each function object in turn, except that the function objects are
+   * added to the io_context's queue together, and at most one thread is woken
+   * to start executing them. Further threads are woken as needed by the
+   * threads running the io_context.
+   *
+   * None of the function objects will be executed inside @c bulk_post(). If
+   * an exception is thrown while copying a function object, none of the
+   * function objects are scheduled.
+   *
+   * @param first An iterator to the first function object. The executor
+   * will make a copy of each function object as required. The function
+   * signature of the function objects must be: @code void function(); @endcode
+   *
+   * @param last An iterator one past the last function object.
+   *
+   * @param a An allocator that may be used by the executor to allocate the
+   * internal storage needed for function invocation.
+   */
+  template <typename InputIterator, typename Allocator>
+  void bulk_post(InputIterator first, InputIterator last,
+      const Allocator& a) const;
+
   /// Request the io_context to invoke the given function object.
   /**
    * This function is used to ask the io_context to execute the given function
@@ -538,6 +725,91 @@ private:
   io_context& io_context_;
 };
 
+/// Posts function objects to an io_context from a single dedicated thread.
+/**
+ * A producer owns a bounded queue through which one thread, which need not
+ * run the io_context, posts function objects without locking the
+ * io_context's internal queue. The threads running the io_context move the
+ * function objects from the producer's queue to the io_context's queue as
+ * they look for work, and the producer takes the lock only to wake a thread
+ * that is blocked waiting for work, or when its queue is full.
+ *
+ * Function objects posted through a producer are executed in the order in
+ * which they were posted.
+ *
+ * Like an executor_work_guard, a producer keeps the io_context's run()
+ * functions from exiting due to lack of work for as long as it exists.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Unsafe. Only one thread at a time may use a given
+ * producer.
+ */
+class io_context::producer
+  : private detail::noncopyable
+{
+public:
+  /// Register a producer with an io_context.
+  /**
+   * @param io_context The io_context that will execute the posted function
+   * objects.
+   *
+   * @param capacity The number of function objects that may be waiting in the
+   * producer's queue. This is rounded up to a power of two. When the queue is
+   * full, post() moves the queue's contents to the io_context's queue while
+   * holding the lock.
+   */
+  explicit producer(io_context& io_context, std::size_t capacity = 1024);
+
+  /// Destructor.
+  /**
+   * Moves any function objects remaining in the producer's queue to the
+   * io_context's queue, and then informs the io_context that the producer's
+   * work is finished.
+   */
+  ~producer();
+
+  /// Obtain the underlying execution context.
+  io_context& context() const NET_TS_NOEXCEPT;
+
+  /// Get the number of function objects the producer's queue can hold.
+  std::size_t capacity() const NET_TS_NOEXCEPT;
+
+  /// Request the io_context to invoke the given function object.
+  /**
+   * The function object will never be executed inside @c post(). Instead, it
+   * will be scheduled to run on the io_context.
+   *
+   * @param f The function object to be called. The producer will make a copy
+   * of the handler object as required. The function signature of the function
+   * object must be: @code void function(); @endcode
+   */
+  template <typename Function>
+  void post(NET_TS_MOVE_ARG(Function) f);
+
+  /// Request the io_context to invoke the given function object.
+  /**
+   * The function object will never be executed inside @c post(). Instead, it
+   * will be scheduled to run on the io_context.
+   *
+   * @param f The function object to be called. The producer will make a copy
+   * of the handler object as required. The function signature of the function
+   * object must be: @code void function(); @endcode
+   *
+   * @param a An allocator that may be used by the producer to allocate the
+   * internal storage needed for function invocation.
+   */
+  template <typename Function, typename Allocator>
+  void post(NET_TS_MOVE_ARG(Function) f, const Allocator& a);
+
+private:
+  // The underlying io_context.
+  io_context& io_context_;
+
+  // The queue through which function objects are posted.
+  detail::injection_ring ring_;
+};
+
 /// Base class for all io_context services.
 class io_context::service
   : public execution_context::service
@@ -0,0 +1,143 @@
+//
+// io_context_balancer.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_IO_CONTEXT_BALANCER_HPP
+#define NET_TS_IO_CONTEXT_BALANCER_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <vector>
+#include <experimental/__net_ts/io_context.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+
+/// Chooses the least loaded of a set of io_context objects.
+/**
+ * The io_context_balancer class is a function object that selects an
+ * io_context for a new or migrating connection. Load is measured by each
+ * io_context's outstanding_work(). A connection that has just been assigned
+ * does not yet have operations outstanding, so the balancer also counts the
+ * connections it has assigned until they are reflected in the measured load.
+ * Ties are broken in round-robin order.
+ *
+ * A balancer may be passed to basic_socket_acceptor::async_accept_many(), or
+ * called to choose the target of basic_stream_socket::migrate().
+ * async_accept_many() copies its balancer for each batch, so pass it with
+ * @c std::ref to keep the assignment counts from one batch to the next.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Unsafe.
+ *
+ * @par Example
+ * @code
+ * std::experimental::net::io_context_balancer balancer(
+ *     worker_contexts.begin(), worker_contexts.end());
+ * acceptor.async_accept_many(64, std::ref(balancer), accept_handler);
+ * @endcode
+ */
+class io_context_balancer
+{
+public:
+  /// Construct a balancer with no io_context objects.
+  io_context_balancer()
+    : next_(0)
+  {
+  }
+
+  /// Construct a balancer for a range of io_context objects.
+  template <typename Iterator>
+  io_context_balancer(Iterator first, Iterator last)
+    : next_(0)
+  {
+    for (; first != last; ++first)
+      add(*first);
+  }
+
+  /// Add an io_context to the set from which targets are chosen.
+  void add(io_context& ctx)
+  {
+    entry e = { &ctx, ctx.outstanding_work(), 0 };
+    entries_.push_back(e);
+  }
+
+  /// Get the number of io_context objects in the set.
+  std::size_t size() const
+  {
+    return entries_.size();
+  }
+
+  /// Choose the least loaded io_context.
+  /**
+   * The set must not be empty.
+   */
+  io_context& operator()()
+  {
+    std::size_t best = 0;
+    std::size_t best_load = 0;
+    for (std::size_t i = 0; i < entries_.size(); ++i)
+    {
+      std::size_t n = (next_ + i) % entries_.size();
+      std::size_t load = refresh(entries_[n]);
+      if (i == 0 || load < best_load)
+      {
+        best = n;
+        best_load = load;
+      }
+    }
+
+    ++entries_[best].assigned;
+    next_ = (best + 1) % entries_.size();
+    return *entries_[best].ctx;
+  }
+
+private:
+  struct entry
+  {
+    io_context* ctx;
+    std::size_t measured;
+    std::size_t assigned;
+  };
+
+  // Get the load of an io_context, including connections assigned to it that
+  // are not yet reflected in its measured load.
+  static std::size_t refresh(entry& e)
+  {
+    std::size_t measured = e.ctx->outstanding_work();
+    if (measured > e.measured)
+    {
+      std::size_t increase = measured - e.measured;
+      e.assigned -= increase < e.assigned ? increase : e.assigned;
+    }
+    e.measured = measured;
+    return measured + e.assigned;
+  }
+
+  std::vector<entry> entries_;
+  std::size_t next_;
+};
+
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_IO_CONTEXT_BALANCER_HPP
@@ -0,0 +1,278 @@
+//
+// ip/basic_connection_pool.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_IP_BASIC_CONNECTION_POOL_HPP
+#define NET_TS_IP_BASIC_CONNECTION_POOL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+
+#if defined(NET_TS_HAS_CHRONO) && defined(NET_TS_HAS_MOVE) \
+  || defined(GENERATING_DOCUMENTATION)
+
+#include <cstddef>
+#include <experimental/__net_ts/async_result.hpp>
+#include <experimental/__net_ts/basic_stream_socket.hpp>
+#include <experimental/__net_ts/io_context.hpp>
+#include <experimental/__net_ts/detail/chrono.hpp>
+#include <experimental/__net_ts/detail/connection_pool.hpp>
+#include <experimental/__net_ts/detail/connection_pool_op.hpp>
+#include <experimental/__net_ts/detail/memory.hpp>
+#include <experimental/__net_ts/detail/noncopyable.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace ip {
+
+/// Maintains reusable connections to stream-oriented endpoints.
+/**
+ * The basic_connection_pool class template keeps connections to endpoints
+ * open after use, so that later operations on the same endpoint can avoid the
+ * cost of establishing a new connection.
+ *
+ * A connection is obtained by calling async_checkout(). If the pool holds an
+ * idle connection to the endpoint, and the connection is still alive, it is
+ * passed to the handler. Otherwise a new connection is established. Once the
+ * caller has finished with the connection, it should be returned by calling
+ * checkin(). Connections that have been closed, that the peer has closed, or
+ * on which unexpected data is waiting, are discarded rather than reused.
+ *
+ * The number of connections that may be in use, or being established, for
+ * each endpoint is limited by max_in_flight(). Checkout operations that would
+ * exceed the limit wait until a connection is returned. Idle connections are
+ * closed once they have been unused for longer than idle_timeout().
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Safe.
+ *
+ * @par Example
+ * @code std::experimental::net::ip::basic_connection_pool<tcp> pool(io_context);
+ * tcp::endpoint endpoint = ...;
+ *
+ * pool.async_checkout(endpoint,
+ *     [&](std::error_code ec, tcp::socket socket)
+ *     {
+ *       if (!ec)
+ *       {
+ *         // ... use the connection ...
+ *         pool.checkin(endpoint, std::move(socket));
+ *       }
+ *     }); @endcode
+ */
+template <typename Protocol>
+class basic_connection_pool
+  : private std::experimental::net::v1::detail::noncopyable
+{
+public:
+  /// The type of the executor associated with the object.
+  typedef io_context::executor_type executor_type;
+
+  /// The protocol type.
+  typedef Protocol protocol_type;
+
+  /// The endpoint type.
+  typedef typename Protocol::endpoint endpoint_type;
+
+  /// The type of the pooled connections.
+  typedef basic_stream_socket<Protocol> socket_type;
+
+  /// The clock type used for idle timeouts.
+  typedef chrono::steady_clock clock_type;
+
+  /// Constructor.
+  /**
+   * This constructor creates an empty connection pool.
+   *
+   * @param io_context The io_context object that the pool will use to
+   * establish connections.
+   */
+  explicit basic_connection_pool(std::experimental::net::v1::io_context& io_context)
+    : impl_(new impl_type(io_context))
+  {
+  }
+
+  /// Destroys the connection pool.
+  /**
+   * This function closes all idle connections and aborts all outstanding
+   * checkout operations, as if by calling close().
+   */
+  ~basic_connection_pool()
+  {
+    impl_type::close(impl_);
+  }
+
+  /// Get the executor associated with the object.
+  executor_type get_executor() NET_TS_NOEXCEPT
+  {
+    return impl_->get_io_context().get_executor();
+  }
+
+  /// Set the maximum number of idle connections kept for each endpoint.
+  /**
+   * Connections returned once the limit has been reached are closed. The
+   * default limit is 8.
+   */
+  void max_idle(std::size_t n)
+  {
+    impl_->set_max_idle(n);
+  }
+
+  /// Get the maximum number of idle connections kept for each endpoint.
+  std::size_t max_idle() const
+  {
+    return impl_->max_idle();
+  }
+
+  /// Set the maximum number of in-flight connections for each endpoint.
+  /**
+   * A connection is in flight from the start of the checkout operation that
+   * obtains it until it is returned by checkin(). By default there is no
+   * limit.
+   */
+  void max_in_flight(std::size_t n)
+  {
+    impl_->set_max_in_flight(n);
+  }
+
+  /// Get the maximum number of in-flight connections for each endpoint.
+  std::size_t max_in_flight() const
+  {
+    return impl_->max_in_flight();
+  }
+
+  /// Set the time after which an idle connection is closed.
+  /**
+   * The new timeout applies to connections returned after the call. The
+   * default timeout is 60 seconds.
+   */
+  template <typename Rep, typename Period>
+  void idle_timeout(const chrono::duration<Rep, Period>& d)
+  {
+    impl_->set_idle_timeout(
+        chrono::duration_cast<clock_type::duration>(d));
+  }
+
+  /// Get the time after which an idle connection is closed.
+  clock_type::duration idle_timeout() const
+  {
+    return impl_->idle_timeout();
+  }
+
+  /// Get the number of idle connections held by the pool.
+  std::size_t idle_count() const
+  {
+    return impl_->idle_count();
+  }
+
+  /// Get the number of in-flight connections for an endpoint.
+  std::size_t in_flight(const endpoint_type& endpoint) const
+  {
+    return impl_->in_flight(endpoint);
+  }
+
+  /// Start an asynchronous operation to obtain a connection to an endpoint.
+  /**
+   * This function is used to asynchronously obtain a connection, reusing an
+   * idle connection if one is available. The function call always returns
+   * immediately.
+   *
+   * @param endpoint The endpoint to which the connection is required.
+   *
+   * @param handler The handler to be called when the operation completes.
+   * Copies will be made of the handler as required. The function signature
+   * of the handler must be:
+   * @code void handler(
+   *   const std::error_code& error, // Result of operation.
+   *   socket_type socket // On success, the connection.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. Invocation
+   * of the handler will be performed in a manner equivalent to using
+   * std::experimental::net::v1::io_context::post().
+   */
+  template <typename CheckoutHandler>
+  NET_TS_INITFN_RESULT_TYPE(CheckoutHandler,
+      void (std::error_code, socket_type))
+  async_checkout(const endpoint_type& endpoint,
+      NET_TS_MOVE_ARG(CheckoutHandler) handler)
+  {
+    async_completion<CheckoutHandler,
+      void (std::error_code, socket_type)> init(handler);
+
+    typedef std::experimental::net::v1::detail::connection_pool_checkout_op<
+      Protocol, NET_TS_HANDLER_TYPE(CheckoutHandler,
+        void (std::error_code, socket_type))> op;
+    typename op::ptr p = {
+      std::experimental::net::v1::detail::addressof(init.completion_handler),
+      op::ptr::allocate(init.completion_handler), 0 };
+    p.p = new (p.v) op(impl_->get_io_context(), init.completion_handler);
+
+    NET_TS_HANDLER_CREATION((impl_->get_io_context(),
+          *p.p, "connection_pool", impl_.get(), 0, "async_checkout"));
+
+    impl_type::checkout(impl_, endpoint, p.p);
+    p.v = p.p = 0;
+
+    return init.result.get();
+  }
+
+  /// Return a connection to the pool.
+  /**
+   * This function returns a connection that was obtained by async_checkout()
+   * so that it may be reused. If the connection is waited for by another
+   * checkout operation it is passed to that operation. A closed socket may be
+   * passed to indicate that the connection could not be reused.
+   *
+   * @param endpoint The endpoint that was passed to async_checkout().
+   *
+   * @param socket The connection.
+   */
+  void checkin(const endpoint_type& endpoint, socket_type socket)
+  {
+    impl_type::checkin(impl_, endpoint, socket);
+  }
+
+  /// Close all idle connections and abort all pending operations.
+  /**
+   * This function closes the idle connections and causes checkout operations
+   * that are waiting or establishing a connection to finish immediately with
+   * the std::experimental::net::error::operation_aborted error. Connections
+   * that are checked out are unaffected and may still be returned.
+   */
+  void close()
+  {
+    impl_type::close(impl_);
+  }
+
+private:
+  typedef std::experimental::net::v1::detail::connection_pool<Protocol> impl_type;
+  std::experimental::net::v1::detail::shared_ptr<impl_type> impl_;
+};
+
+} // namespace ip
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // defined(NET_TS_HAS_CHRONO) && defined(NET_TS_HAS_MOVE)
+       //   || defined(GENERATING_DOCUMENTATION)
+
+#endif // NET_TS_IP_BASIC_CONNECTION_POOL_HPP
@@ -37,6 +37,10 @@
 # include <experimental/__net_ts/detail/winrt_resolver_service.hpp>
 # define NET_TS_SVC_T \
     std::experimental::net::v1::detail::winrt_resolver_service<InternetProtocol>
+#elif defined(NET_TS_HAS_DNS_RESOLVER)
+# include <experimental/__net_ts/detail/dns_resolver_service.hpp>
+# define NET_TS_SVC_T \
+    std::experimental::net::v1::detail::dns_resolver_service<InternetProtocol>
 #else
 # include <experimental/__net_ts/detail/resolver_service.hpp>
 # define NET_TS_SVC_T \
@@ -154,6 +158,90 @@ public:
     return this->get_service().cancel(this->get_implementation());
   }
 
+  /// Set an option on the resolver.
+  /**
+   * This function is used to set an option that controls how host resolution
+   * is performed. Options apply to all resolvers of the same protocol that
+   * are associated with the io_context.
+   *
+   * @param option The new option value to be set on the resolver.
+   *
+   * @throws std::system_error Thrown on failure.
+   *
+   * @sa std::experimental::net::v1::ip::resolver_base::thread_pool_size @n
+   * std::experimental::net::v1::ip::resolver_base::cache_ttl @n
+   * std::experimental::net::v1::ip::resolver_base::negative_cache_ttl @n
+   * std::experimental::net::v1::ip::resolver_base::cache_max_entries
+   *
+   * @par Example
+   * Caching successful lookups for 30 seconds:
+   * @code
+   * std::experimental::net::ip::tcp::resolver resolver(io_context);
+   * ...
+   * std::experimental::net::ip::tcp::resolver::cache_ttl option(30);
+   * resolver.set_option(option);
+   * @endcode
+   */
+  template <typename ResolverOption>
+  void set_option(const ResolverOption& option)
+  {
+    std::error_code ec;
+    this->get_service().set_option(this->get_implementation(), option, ec);
+    std::experimental::net::v1::detail::throw_error(ec, "set_option");
+  }
+
+  /// Set an option on the resolver.
+  /**
+   * This function is used to set an option that controls how host resolution
+   * is performed. Options apply to all resolvers of the same protocol that
+   * are associated with the io_context.
+   *
+   * @param option The new option value to be set on the resolver.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   */
+  template <typename ResolverOption>
+  NET_TS_SYNC_OP_VOID set_option(const ResolverOption& option,
+      std::error_code& ec)
+  {
+    this->get_service().set_option(this->get_implementation(), option, ec);
+    NET_TS_SYNC_OP_VOID_RETURN(ec);
+  }
+
+  /// Get an option from the resolver.
+  /**
+   * This function is used to get the current value of an option that
+   * controls how host resolution is performed.
+   *
+   * @param option The option value to be obtained from the resolver.
+   *
+   * @throws std::system_error Thrown on failure.
+   */
+  template <typename ResolverOption>
+  void get_option(ResolverOption& option) const
+  {
+    std::error_code ec;
+    this->get_service().get_option(this->get_implementation(), option, ec);
+    std::experimental::net::v1::detail::throw_error(ec, "get_option");
+  }
+
+  /// Get an option from the resolver.
+  /**
+   * This function is used to get the current value of an option that
+   * controls how host resolution is performed.
+   *
+   * @param option The option value to be obtained from the resolver.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   */
+  template <typename ResolverOption>
+  NET_TS_SYNC_OP_VOID get_option(ResolverOption& option,
+      std::error_code& ec) const
+  {
+    this->get_service().get_option(this->get_implementation(), option, ec);
+    NET_TS_SYNC_OP_VOID_RETURN(ec);
+  }
+
   /// Perform forward resolution of a query to a list of entries.
   /**
    * This function is used to resolve host and service names into a list of
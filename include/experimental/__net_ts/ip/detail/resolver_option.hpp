@@ -0,0 +1,96 @@
+//
+// ip/detail/resolver_option.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_IP_DETAIL_RESOLVER_OPTION_HPP
+#define NET_TS_IP_DETAIL_RESOLVER_OPTION_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace ip {
+namespace detail {
+namespace resolver_option {
+
+// The names of the options understood by the resolver service.
+enum name
+{
+  thread_pool_size_name,
+  cache_ttl_name,
+  negative_cache_ttl_name,
+  cache_max_entries_name,
+  name_server_port_name
+};
+
+// Helper template for implementing integer resolver options.
+template <int Name>
+class integer
+{
+public:
+  // Default constructor.
+  integer()
+    : value_(0)
+  {
+  }
+
+  // Construct with a specific option value.
+  explicit integer(int v)
+    : value_(v)
+  {
+  }
+
+  // Set the value of the int option.
+  integer& operator=(int v)
+  {
+    value_ = v;
+    return *this;
+  }
+
+  // Get the current value of the int option.
+  int value() const
+  {
+    return value_;
+  }
+
+  // Get the name of the option.
+  static int name()
+  {
+    return Name;
+  }
+
+  // Get a reference to the option's value.
+  int& data()
+  {
+    return value_;
+  }
+
+private:
+  int value_;
+};
+
+} // namespace resolver_option
+} // namespace detail
+} // namespace ip
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#endif // NET_TS_IP_DETAIL_RESOLVER_OPTION_HPP
@@ -17,6 +17,7 @@
 
 #include <experimental/__net_ts/detail/config.hpp>
 #include <experimental/__net_ts/detail/socket_types.hpp>
+#include <experimental/__net_ts/ip/detail/resolver_option.hpp>
 
 #include <experimental/__net_ts/detail/push_options.hpp>
 
@@ -117,6 +118,82 @@ public:
   }
 #endif
 
+#if defined(GENERATING_DOCUMENTATION)
+  /// Resolver option to set the number of threads used to perform
+  /// asynchronous host resolution.
+  /**
+   * The option applies to all resolvers of the same protocol that are
+   * associated with the io_context. The default is one thread. Increasing the
+   * value adds threads to the pool. Reducing it has no effect on threads that
+   * have already been started.
+   *
+   * @par Examples
+   * Setting the option:
+   * @code
+   * std::experimental::net::ip::tcp::resolver resolver(io_context);
+   * std::experimental::net::ip::tcp::resolver::thread_pool_size option(4);
+   * resolver.set_option(option);
+   * @endcode
+   */
+  typedef implementation_defined thread_pool_size;
+
+  /// Resolver option to set the number of seconds for which successful
+  /// results are cached.
+  /**
+   * The cache is keyed by host name, service name, flags and protocol, and
+   * is shared by all resolvers of the same protocol that are associated with
+   * the io_context. A value of zero, which is the default, disables caching.
+   *
+   * @par Examples
+   * Setting the option:
+   * @code
+   * std::experimental::net::ip::tcp::resolver resolver(io_context);
+   * std::experimental::net::ip::tcp::resolver::cache_ttl option(30);
+   * resolver.set_option(option);
+   * @endcode
+   */
+  typedef implementation_defined cache_ttl;
+
+  /// Resolver option to set the number of seconds for which failed lookups
+  /// are cached.
+  /**
+   * A value of zero, which is the default, disables negative caching.
+   * Cancelled operations are never cached.
+   */
+  typedef implementation_defined negative_cache_ttl;
+
+  /// Resolver option to set the maximum number of cached lookups.
+  /**
+   * When the cache is full, expired entries are discarded. If that frees no
+   * space, the result of a new lookup is not cached.
+   */
+  typedef implementation_defined cache_max_entries;
+
+  /// Resolver option to set the port on which name servers are contacted.
+  /**
+   * This option is only supported when asynchronous resolution is performed
+   * by the built-in DNS client, which is enabled by defining
+   * @c NET_TS_ENABLE_DNS_RESOLVER. The default is port 53.
+   */
+  typedef implementation_defined name_server_port;
+#else
+  typedef std::experimental::net::v1::ip::detail::resolver_option::integer<
+    std::experimental::net::v1::ip::detail::resolver_option::
+      thread_pool_size_name> thread_pool_size;
+  typedef std::experimental::net::v1::ip::detail::resolver_option::integer<
+    std::experimental::net::v1::ip::detail::resolver_option::
+      cache_ttl_name> cache_ttl;
+  typedef std::experimental::net::v1::ip::detail::resolver_option::integer<
+    std::experimental::net::v1::ip::detail::resolver_option::
+      negative_cache_ttl_name> negative_cache_ttl;
+  typedef std::experimental::net::v1::ip::detail::resolver_option::integer<
+    std::experimental::net::v1::ip::detail::resolver_option::
+      cache_max_entries_name> cache_max_entries;
+  typedef std::experimental::net::v1::ip::detail::resolver_option::integer<
+    std::experimental::net::v1::ip::detail::resolver_option::
+      name_server_port_name> name_server_port;
+#endif
+
 protected:
   /// Protected destructor to prevent deletion through this type.
   ~resolver_base()
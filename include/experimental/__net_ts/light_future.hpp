@@ -0,0 +1,315 @@
+//
+// light_future.hpp
+// ~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_LIGHT_FUTURE_HPP
+#define NET_TS_LIGHT_FUTURE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <experimental/__net_ts/detail/light_future_state.hpp>
+
+#if (defined(NET_TS_HAS_STD_ATOMIC) \
+    && defined(NET_TS_HAS_MOVE) \
+    && defined(NET_TS_HAS_VARIADIC_TEMPLATES)) \
+  || defined(GENERATING_DOCUMENTATION)
+
+#include <memory>
+#include <experimental/__net_ts/associated_allocator.hpp>
+#include <experimental/__net_ts/detail/type_traits.hpp>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+namespace detail {
+
+template <typename T, typename Function>
+class light_future_continuation;
+
+template <typename T>
+class light_future_creator;
+
+} // namespace detail
+
+/// A future that receives the result of an asynchronous operation.
+/**
+ * The light_future class template is returned by asynchronous operations
+ * initiated with the std::experimental::net::use_light_future completion
+ * token. Unlike std::future, its shared state is a single object allocated
+ * using the token's allocator, and a blocked thread is woken without a mutex
+ * or condition variable.
+ *
+ * A light_future may be consumed in one of two ways: by calling get(), which
+ * blocks until the operation completes, or by calling then() to register a
+ * continuation, which does not block.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Unsafe.
+ */
+template <typename T>
+class light_future
+{
+public:
+  /// The type of the result.
+  typedef T value_type;
+
+  /// Construct a future without a shared state.
+  light_future() NET_TS_NOEXCEPT
+    : state_(0)
+  {
+  }
+
+  /// Move constructor.
+  light_future(light_future&& other) NET_TS_NOEXCEPT
+    : state_(other.state_)
+  {
+    other.state_ = 0;
+  }
+
+  /// Destructor.
+  ~light_future()
+  {
+    if (state_)
+      state_->release();
+  }
+
+  /// Move assignment.
+  light_future& operator=(light_future&& other) NET_TS_NOEXCEPT
+  {
+    if (this != &other)
+    {
+      if (state_)
+        state_->release();
+      state_ = other.state_;
+      other.state_ = 0;
+    }
+    return *this;
+  }
+
+  /// Determine whether the future has a shared state.
+  bool valid() const NET_TS_NOEXCEPT
+  {
+    return state_ != 0;
+  }
+
+  /// Determine whether the operation has completed.
+  /**
+   * @pre valid() is true.
+   */
+  bool is_ready() const NET_TS_NOEXCEPT
+  {
+    return state_->is_ready();
+  }
+
+  /// Block until the operation has completed.
+  /**
+   * @pre valid() is true.
+   */
+  void wait() const
+  {
+    state_->wait();
+  }
+
+  /// Wait for and obtain the result of the operation.
+  /**
+   * Blocks until the operation has completed and then releases the shared
+   * state.
+   *
+   * @returns The result of the operation.
+   *
+   * @throws std::system_error If the operation completed with an error code.
+   * Any exception with which the operation completed is rethrown.
+   *
+   * @pre valid() is true.
+   */
+  T get()
+  {
+    state_holder h(this);
+    h.state_->wait();
+    h.state_->report_error(0);
+    return h.state_->take_value();
+  }
+
+  /// Wait for and obtain the result of the operation.
+  /**
+   * Blocks until the operation has completed and then releases the shared
+   * state.
+   *
+   * @param ec Set to the error, if any, with which the operation completed.
+   *
+   * @returns The result of the operation, or a value-initialised @c T if the
+   * operation completed with an error code.
+   *
+   * @throws Any exception with which the operation completed is rethrown.
+   *
+   * @pre valid() is true.
+   */
+  T get(std::error_code& ec)
+  {
+    state_holder h(this);
+    h.state_->wait();
+    ec = std::error_code();
+    h.state_->report_error(&ec);
+    if (ec)
+      return T();
+    return h.state_->take_value();
+  }
+
+  /// Register a continuation to receive the result of the operation.
+  /**
+   * The function object is invoked, with the completed future as its argument,
+   * in the thread that completes the operation. If the operation has already
+   * completed, the function object is invoked before then() returns. No
+   * thread is blocked waiting for the result.
+   *
+   * Memory for the continuation is obtained using the function object's
+   * associated allocator.
+   *
+   * @param f The function object to be called. Its signature must be:
+   * @code void f(light_future<T> result); @endcode
+   *
+   * @pre valid() is true. On return, valid() is false.
+   */
+  template <typename Function>
+  void then(NET_TS_MOVE_ARG(Function) f);
+
+private:
+  template <typename, typename> friend class detail::light_future_continuation;
+  template <typename> friend class detail::light_future_creator;
+
+  // Construct a future that takes ownership of a reference to the state.
+  explicit light_future(detail::light_future_state<T>* s) NET_TS_NOEXCEPT
+    : state_(s)
+  {
+  }
+
+  // Helper class to release the shared state when a result is consumed.
+  struct state_holder
+  {
+    explicit state_holder(light_future* f)
+      : state_(f->state_)
+    {
+      f->state_ = 0;
+    }
+
+    ~state_holder()
+    {
+      state_->release();
+    }
+
+    detail::light_future_state<T>* state_;
+  };
+
+  detail::light_future_state<T>* state_;
+};
+
+/// Class used to specify that an asynchronous operation should return a
+/// light_future.
+/**
+ * The use_light_future_t class is used to indicate that an asynchronous
+ * operation should return a light_future object. A use_light_future_t object
+ * may be passed as a handler to an asynchronous operation, typically using
+ * the special value @c std::experimental::net::use_light_future. For example:
+ *
+ * @code std::experimental::net::light_future<std::size_t> my_future
+ *   = my_socket.async_read_some(my_buffer,
+ *       std::experimental::net::use_light_future); @endcode
+ *
+ * The initiating function (async_read_some in the above example) returns a
+ * future that will receive the result of the operation. If the operation
+ * completes with an error_code indicating failure, it is reported by
+ * light_future::get(). If the operation is abandoned without completing, the
+ * future receives the error std::experimental::net::error::operation_aborted.
+ */
+template <typename Allocator = std::allocator<void> >
+class use_light_future_t
+{
+public:
+  /// The allocator type. The allocator is used to allocate the shared state
+  /// and the memory associated with the asynchronous operation.
+  typedef Allocator allocator_type;
+
+  /// Construct using default-constructed allocator.
+  NET_TS_CONSTEXPR use_light_future_t()
+  {
+  }
+
+  /// Construct using specified allocator.
+  explicit use_light_future_t(const Allocator& allocator)
+    : allocator_(allocator)
+  {
+  }
+
+  /// Specify an alternate allocator.
+  template <typename OtherAllocator>
+  use_light_future_t<OtherAllocator> rebind(
+      const OtherAllocator& allocator) const
+  {
+    return use_light_future_t<OtherAllocator>(allocator);
+  }
+
+  /// Obtain allocator.
+  allocator_type get_allocator() const
+  {
+    return allocator_;
+  }
+
+private:
+  // Helper type to ensure that use_light_future can be constexpr
+  // default-constructed even when std::allocator<void> can't be.
+  struct std_allocator_void
+  {
+    NET_TS_CONSTEXPR std_allocator_void()
+    {
+    }
+
+    operator std::allocator<void>() const
+    {
+      return std::allocator<void>();
+    }
+  };
+
+  typename conditional<
+    is_same<std::allocator<void>, Allocator>::value,
+    std_allocator_void, Allocator>::type allocator_;
+};
+
+/// A special value, similar to std::nothrow.
+/**
+ * See the documentation for std::experimental::net::v1::use_light_future_t
+ * for a usage example.
+ */
+#if defined(NET_TS_HAS_CONSTEXPR) || defined(GENERATING_DOCUMENTATION)
+constexpr use_light_future_t<> use_light_future;
+#elif defined(NET_TS_MSVC)
+__declspec(selectany) use_light_future_t<> use_light_future;
+#endif
+
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#include <experimental/__net_ts/impl/light_future.hpp>
+
+#endif // (defined(NET_TS_HAS_STD_ATOMIC)
+       //     && defined(NET_TS_HAS_MOVE)
+       //     && defined(NET_TS_HAS_VARIADIC_TEMPLATES))
+       //   || defined(GENERATING_DOCUMENTATION)
+
+#endif // NET_TS_LIGHT_FUTURE_HPP
@@ -0,0 +1,340 @@
+//
+// periodic_timer.hpp
+// ~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_PERIODIC_TIMER_HPP
+#define NET_TS_PERIODIC_TIMER_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+
+#if defined(NET_TS_HAS_CHRONO) || defined(GENERATING_DOCUMENTATION)
+
+#include <cstddef>
+#include <experimental/__net_ts/basic_io_object.hpp>
+#include <experimental/__net_ts/detail/bind_handler.hpp>
+#include <experimental/__net_ts/detail/chrono.hpp>
+#include <experimental/__net_ts/detail/chrono_time_traits.hpp>
+#include <experimental/__net_ts/detail/periodic_timer_service.hpp>
+#include <experimental/__net_ts/detail/throw_error.hpp>
+#include <experimental/__net_ts/detail/type_traits.hpp>
+#include <experimental/__net_ts/error.hpp>
+#include <experimental/__net_ts/post.hpp>
+#include <experimental/__net_ts/wait_traits.hpp>
+
+#if defined(NET_TS_HAS_MOVE)
+# include <utility>
+#endif // defined(NET_TS_HAS_MOVE)
+
+#define NET_TS_SVC_T \
+    detail::periodic_timer_service< \
+      detail::chrono_time_traits<Clock, WaitTraits> >
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+
+/// Provides a timer that expires repeatedly at a fixed interval.
+/**
+ * The basic_periodic_timer class template calls a handler once per period
+ * until the timer is cancelled. Unlike a basic_waitable_timer on which
+ * async_wait() is called again from each handler, the timer creates a single
+ * operation when the wait is started and puts the same operation back into
+ * the timer queue after each expiry, so an expiry does not allocate memory.
+ *
+ * By default, the next expiry is one period after the handler returns, so the
+ * time taken by the handler delays all later expiries. If drift compensation
+ * is enabled, expiries are instead kept at fixed multiples of the period from
+ * the start of the wait. An expiry that is missed entirely, because a handler
+ * ran for longer than a period, is skipped.
+ *
+ * Most applications will use the std::experimental::net::v1::periodic_timer
+ * typedef.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Unsafe.
+ *
+ * @par Example
+ * @code
+ * void heartbeat(const std::error_code& error)
+ * {
+ *   if (!error)
+ *   {
+ *     // Send a heartbeat.
+ *   }
+ * }
+ *
+ * ...
+ *
+ * std::experimental::net::periodic_timer timer(io_context,
+ *     std::chrono::seconds(1));
+ * timer.async_wait(heartbeat);
+ * @endcode
+ */
+template <typename Clock,
+    typename WaitTraits = std::experimental::net::v1::wait_traits<Clock> >
+class basic_periodic_timer
+  : NET_TS_SVC_ACCESS basic_io_object<NET_TS_SVC_T>
+{
+public:
+  /// The type of the executor associated with the object.
+  typedef io_context::executor_type executor_type;
+
+  /// The clock type.
+  typedef Clock clock_type;
+
+  /// The duration type of the clock.
+  typedef typename clock_type::duration duration;
+
+  /// The time point type of the clock.
+  typedef typename clock_type::time_point time_point;
+
+  /// The wait traits type.
+  typedef WaitTraits traits_type;
+
+  /// Constructor.
+  /**
+   * This constructor creates a timer without setting a period. The period()
+   * function must be called to set a period before the timer can be waited
+   * on.
+   *
+   * @param io_context The io_context object that the timer will use to dispatch
+   * handlers for any asynchronous operations performed on the timer.
+   */
+  explicit basic_periodic_timer(std::experimental::net::v1::io_context& io_context)
+    : basic_io_object<NET_TS_SVC_T>(io_context)
+  {
+  }
+
+  /// Constructor to set the period.
+  /**
+   * @param io_context The io_context object that the timer will use to dispatch
+   * handlers for any asynchronous operations performed on the timer.
+   *
+   * @param period The interval between expiries. Must be positive.
+   *
+   * @throws std::system_error Thrown on failure.
+   */
+  basic_periodic_timer(std::experimental::net::v1::io_context& io_context,
+      const duration& period)
+    : basic_io_object<NET_TS_SVC_T>(io_context)
+  {
+    std::error_code ec;
+    this->get_service().period(this->get_implementation(), period, ec);
+    std::experimental::net::v1::detail::throw_error(ec, "period");
+  }
+
+#if defined(NET_TS_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+  /// Move-construct a basic_periodic_timer from another.
+  /**
+   * This constructor moves a timer, including any periodic wait that is in
+   * progress, from one object to another.
+   *
+   * @param other The other basic_periodic_timer object from which the move
+   * will occur.
+   *
+   * @note Following the move, the moved-from object is in the same state as if
+   * constructed using the @c basic_periodic_timer(io_context&) constructor.
+   */
+  basic_periodic_timer(basic_periodic_timer&& other)
+    : basic_io_object<NET_TS_SVC_T>(std::move(other))
+  {
+  }
+
+  /// Move-assign a basic_periodic_timer from another.
+  /**
+   * This assignment operator moves a timer from one object to another. Cancels
+   * any periodic wait associated with the target object.
+   *
+   * @param other The other basic_periodic_timer object from which the move
+   * will occur.
+   *
+   * @note Following the move, the moved-from object is in the same state as if
+   * constructed using the @c basic_periodic_timer(io_context&) constructor.
+   */
+  basic_periodic_timer& operator=(basic_periodic_timer&& other)
+  {
+    basic_io_object<NET_TS_SVC_T>::operator=(std::move(other));
+    return *this;
+  }
+#endif // defined(NET_TS_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+
+  /// Destroys the timer.
+  /**
+   * This function destroys the timer, cancelling any periodic wait as if by
+   * calling @c cancel.
+   */
+  ~basic_periodic_timer()
+  {
+  }
+
+  /// Get the executor associated with the object.
+  executor_type get_executor() NET_TS_NOEXCEPT
+  {
+    return basic_io_object<NET_TS_SVC_T>::get_executor();
+  }
+
+  /// Cancel the periodic wait.
+  /**
+   * This function stops the periodic wait, if any. The handler is called once
+   * more, with the std::experimental::net::v1::error::operation_aborted error
+   * code, and is then destroyed. The handler is not called again with success
+   * after cancel() returns, even if an expiry has already been queued for
+   * invocation. Cancelling the timer from within the handler is permitted.
+   *
+   * @return The number of periodic waits that were cancelled. That is, either
+   * 0 or 1.
+   *
+   * @throws std::system_error Thrown on failure.
+   */
+  std::size_t cancel()
+  {
+    std::error_code ec;
+    std::size_t s = this->get_service().cancel(this->get_implementation(), ec);
+    std::experimental::net::v1::detail::throw_error(ec, "cancel");
+    return s;
+  }
+
+  /// Get the time of the next expiry.
+  /**
+   * While a periodic wait is in progress, this is the time at which the
+   * handler will next be called. While the handler runs, it is the time of the
+   * expiry being handled.
+   */
+  time_point expiry() const
+  {
+    return this->get_service().expiry(this->get_implementation());
+  }
+
+  /// Get the interval between expiries.
+  duration period() const
+  {
+    return this->get_service().period(this->get_implementation());
+  }
+
+  /// Set the interval between expiries.
+  /**
+   * If a periodic wait is in progress, the new period is used from the next
+   * time the timer is put back into the queue. The next expiry is not changed.
+   *
+   * @param period The interval between expiries. Must be positive.
+   *
+   * @throws std::system_error Thrown on failure.
+   */
+  void period(const duration& period)
+  {
+    std::error_code ec;
+    this->get_service().period(this->get_implementation(), period, ec);
+    std::experimental::net::v1::detail::throw_error(ec, "period");
+  }
+
+  /// Set the interval between expiries.
+  /**
+   * If a periodic wait is in progress, the new period is used from the next
+   * time the timer is put back into the queue. The next expiry is not changed.
+   *
+   * @param period The interval between expiries. Must be positive.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   */
+  void period(const duration& period, std::error_code& ec)
+  {
+    this->get_service().period(this->get_implementation(), period, ec);
+  }
+
+  /// Determine whether drift compensation is enabled.
+  bool compensate_drift() const
+  {
+    return this->get_service().compensate_drift(this->get_implementation());
+  }
+
+  /// Enable or disable drift compensation.
+  /**
+   * When enabled, each expiry is one period after the previous expiry, rather
+   * than one period after the previous handler returned. Disabled by default.
+   */
+  void compensate_drift(bool value)
+  {
+    this->get_service().compensate_drift(this->get_implementation(), value);
+  }
+
+  /// Start a periodic wait on the timer.
+  /**
+   * This function starts calling the handler once per period, beginning one
+   * period from now. It always returns immediately. Any periodic wait that is
+   * already in progress is cancelled.
+   *
+   * The handler is called with a clear error code at each expiry, and then
+   * once with std::experimental::net::v1::error::operation_aborted when the
+   * timer is cancelled or destroyed. A call to the handler always returns
+   * before the next expiry is scheduled, so calls never overlap. If no period
+   * has been set, the handler is called once with
+   * std::experimental::net::v1::error::invalid_argument.
+   *
+   * Memory for the operation is obtained once, using the handler's associated
+   * allocator. Each call to the handler is made through the handler's
+   * associated executor.
+   *
+   * @param handler The handler to be called at each expiry. A copy of the
+   * handler is kept until the final call. The function signature of the
+   * handler must be:
+   * @code void handler(
+   *   const std::error_code& error // Result of operation.
+   * ); @endcode
+   * The handler will not be invoked from within this function.
+   *
+   * @note The handler is called repeatedly, so this function does not accept
+   * completion tokens such as std::experimental::net::v1::use_future.
+   */
+  template <typename WaitHandler>
+  void async_wait(NET_TS_MOVE_ARG(WaitHandler) handler)
+  {
+    typedef typename decay<WaitHandler>::type handler_type;
+    handler_type h(NET_TS_MOVE_CAST(WaitHandler)(handler));
+
+    if (this->period() <= duration::zero())
+    {
+      std::experimental::net::v1::post(this->get_executor(),
+          detail::bind_handler(NET_TS_MOVE_CAST(handler_type)(h),
+            std::error_code(std::experimental::net::v1::error::invalid_argument)));
+      return;
+    }
+
+    this->get_service().async_wait(this->get_implementation(), h);
+  }
+
+private:
+  // Disallow copying and assignment.
+  basic_periodic_timer(const basic_periodic_timer&) NET_TS_DELETED;
+  basic_periodic_timer& operator=(
+      const basic_periodic_timer&) NET_TS_DELETED;
+};
+
+/// Typedef for a periodic timer based on the steady clock.
+typedef basic_periodic_timer<chrono::steady_clock> periodic_timer;
+
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#undef NET_TS_SVC_T
+
+#endif // defined(NET_TS_HAS_CHRONO) || defined(GENERATING_DOCUMENTATION)
+
+#endif // NET_TS_PERIODIC_TIMER_HPP
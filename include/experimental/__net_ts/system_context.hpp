@@ -16,9 +16,14 @@
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
 #include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <string>
+#include <system_error>
+#include <vector>
 #include <experimental/__net_ts/detail/scheduler.hpp>
 #include <experimental/__net_ts/detail/thread_group.hpp>
 #include <experimental/__net_ts/execution_context.hpp>
+#include <experimental/__net_ts/thread_placement.hpp>
 
 #include <experimental/__net_ts/detail/push_options.hpp>
 
@@ -36,6 +41,60 @@ public:
   /// The executor type associated with the context.
   typedef system_executor executor_type;
 
+  /// Options that control the threads in the system thread pool.
+  struct options
+  {
+    /// Construct with the default options.
+    options()
+      : threads(0),
+        numa_local_memory(false)
+    {
+    }
+
+    /// The number of threads. If zero, twice the number of processors is
+    /// used.
+    std::size_t threads;
+
+    /// The prefix used to name the threads. Each thread's name is the prefix
+    /// followed by the thread's index. If empty, the threads are not named.
+    std::string thread_name;
+
+    /// The sets of processors to which the threads are bound. Thread @c i is
+    /// bound to <tt>cpu_sets[i % cpu_sets.size()]</tt>. If empty, the threads
+    /// are not bound.
+    std::vector<cpu_set> cpu_sets;
+
+    /// Whether each thread allocates memory from the NUMA node on which it
+    /// starts running.
+    bool numa_local_memory;
+  };
+
+  /// Set the options used to create the system thread pool.
+  /**
+   * The system thread pool is created when the system_context is first used,
+   * for example by a call to system_executor::post(). This function must be
+   * called before then.
+   *
+   * Failing to bind or name a thread does not prevent the thread from running
+   * the pool's work.
+   *
+   * @throws std::system_error Thrown on failure. Fails with
+   * error::already_started if the system thread pool has already been created.
+   */
+  NET_TS_DECL static void set_options(const options& o);
+
+  /// Set the options used to create the system thread pool.
+  /**
+   * @param o The options.
+   *
+   * @param ec Set to error::already_started if the system thread pool has
+   * already been created.
+   */
+  NET_TS_DECL static void set_options(const options& o, std::error_code& ec);
+
+  /// Get the options used to create the system thread pool.
+  NET_TS_DECL static options get_options();
+
   /// Destructor shuts down all threads in the system thread pool.
   NET_TS_DECL ~system_context();
 
@@ -62,6 +121,13 @@ private:
 
   struct thread_function;
 
+  // The options, shared by all system_context objects.
+  struct options_state;
+  NET_TS_DECL static options_state& get_options_state();
+
+  // The options with which the threads were created.
+  options options_;
+
   // The underlying scheduler.
   detail::scheduler& scheduler_;
 
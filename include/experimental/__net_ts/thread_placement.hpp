@@ -0,0 +1,183 @@
+//
+// thread_placement.hpp
+// ~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef NET_TS_THREAD_PLACEMENT_HPP
+#define NET_TS_THREAD_PLACEMENT_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <experimental/__net_ts/detail/config.hpp>
+#include <cstddef>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <experimental/__net_ts/detail/push_options.hpp>
+
+namespace std {
+namespace experimental {
+namespace net {
+inline namespace v1 {
+
+/// A set of processors on which a thread may run.
+/**
+ * Processors are identified by the numbers the operating system gives them,
+ * starting from zero.
+ *
+ * A thread that runs an io_context may be bound to a set of processors, and
+ * its memory to a NUMA node, before it constructs the io_context and its I/O
+ * objects. The io_context's internal allocations, such as descriptor states,
+ * timer queues and recycled handler memory, are then made by that thread and
+ * are placed on that thread's node.
+ *
+ * @code std::thread t([]{
+ *     std::experimental::net::set_this_thread_name("shard0");
+ *     std::experimental::net::bind_this_thread(
+ *         std::experimental::net::cpu_set::numa_node(0));
+ *     std::experimental::net::bind_this_thread_memory(0);
+ *
+ *     std::experimental::net::io_context io_context(1);
+ *     ...
+ *     io_context.run();
+ *   }); @endcode
+ */
+class cpu_set
+{
+public:
+  /// Construct an empty set.
+  cpu_set()
+  {
+  }
+
+  /// Obtain the set of processors on which the calling process may run.
+  NET_TS_DECL static cpu_set available();
+
+  /// Obtain the set of processors that belong to a NUMA node.
+  NET_TS_DECL static cpu_set numa_node(std::size_t node);
+
+  /// Obtain the set of processors that belong to a NUMA node.
+  NET_TS_DECL static cpu_set numa_node(
+      std::size_t node, std::error_code& ec);
+
+  /// Add a processor to the set.
+  void add(std::size_t cpu)
+  {
+    if (cpu >= cpus_.size())
+      cpus_.resize(cpu + 1);
+    cpus_[cpu] = true;
+  }
+
+  /// Remove a processor from the set.
+  void remove(std::size_t cpu)
+  {
+    if (cpu < cpus_.size())
+      cpus_[cpu] = false;
+  }
+
+  /// Determine whether the set contains a processor.
+  bool contains(std::size_t cpu) const
+  {
+    return cpu < cpus_.size() && cpus_[cpu];
+  }
+
+  /// Get the number of processors in the set.
+  std::size_t count() const
+  {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < cpus_.size(); ++i)
+      n += cpus_[i] ? 1 : 0;
+    return n;
+  }
+
+  /// Determine whether the set is empty.
+  bool empty() const
+  {
+    return count() == 0;
+  }
+
+  /// Get one more than the highest processor number that may be in the set.
+  std::size_t limit() const
+  {
+    return cpus_.size();
+  }
+
+private:
+  std::vector<bool> cpus_;
+};
+
+/// Bind the calling thread to a set of processors.
+/**
+ * @throws std::system_error Thrown on failure. Binding is not supported on
+ * all platforms.
+ */
+NET_TS_DECL void bind_this_thread(const cpu_set& cpus);
+
+/// Bind the calling thread to a set of processors.
+/**
+ * @param cpus The processors on which the thread may run.
+ *
+ * @param ec Set to indicate what error occurred, if any. Set to
+ * error::operation_not_supported on platforms that do not support binding.
+ */
+NET_TS_DECL void bind_this_thread(const cpu_set& cpus, std::error_code& ec);
+
+/// Make the calling thread allocate memory from a NUMA node.
+/**
+ * Memory is allocated from the node while it has memory available, and from
+ * other nodes otherwise.
+ *
+ * @throws std::system_error Thrown on failure.
+ */
+NET_TS_DECL void bind_this_thread_memory(std::size_t node);
+
+/// Make the calling thread allocate memory from a NUMA node.
+/**
+ * @param node The NUMA node from which memory is to be allocated.
+ *
+ * @param ec Set to indicate what error occurred, if any. Set to
+ * error::operation_not_supported on platforms that do not support memory
+ * placement.
+ */
+NET_TS_DECL void bind_this_thread_memory(
+    std::size_t node, std::error_code& ec);
+
+/// Get the NUMA node of the processor on which the calling thread is running.
+/**
+ * @returns The node number, or 0 if it cannot be determined.
+ */
+NET_TS_DECL std::size_t this_thread_numa_node();
+
+/// Get the number of NUMA nodes in the system.
+/**
+ * @returns The number of nodes, or 1 if it cannot be determined.
+ */
+NET_TS_DECL std::size_t numa_node_count();
+
+/// Set the name of the calling thread, as shown by debuggers and profilers.
+/**
+ * Names may be truncated to fit platform limits. Failure to set the name is
+ * ignored.
+ */
+NET_TS_DECL void set_this_thread_name(const std::string& name);
+
+} // inline namespace v1
+} // namespace net
+} // namespace experimental
+} // namespace std
+
+#include <experimental/__net_ts/detail/pop_options.hpp>
+
+#if defined(NET_TS_HEADER_ONLY)
+# include <experimental/__net_ts/impl/thread_placement.ipp>
+#endif // defined(NET_TS_HEADER_ONLY)
+
+#endif // NET_TS_THREAD_PLACEMENT_HPP
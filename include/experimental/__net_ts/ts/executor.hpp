@@ -22,8 +22,12 @@
 #include <experimental/__net_ts/is_executor.hpp>
 #include <experimental/__net_ts/associated_executor.hpp>
 #include <experimental/__net_ts/bind_executor.hpp>
+#include <experimental/__net_ts/cancellation_signal.hpp>
+#include <experimental/__net_ts/associated_cancellation_slot.hpp>
+#include <experimental/__net_ts/bind_cancellation_slot.hpp>
 #include <experimental/__net_ts/executor_work_guard.hpp>
 #include <experimental/__net_ts/system_executor.hpp>
+#include <experimental/__net_ts/thread_placement.hpp>
 #include <experimental/__net_ts/executor.hpp>
 #include <experimental/__net_ts/dispatch.hpp>
 #include <experimental/__net_ts/post.hpp>
@@ -31,5 +35,6 @@
 #include <experimental/__net_ts/strand.hpp>
 #include <experimental/__net_ts/packaged_task.hpp>
 #include <experimental/__net_ts/use_future.hpp>
+#include <experimental/__net_ts/light_future.hpp>
 
 #endif // NET_TS_TS_EXECUTOR_HPP
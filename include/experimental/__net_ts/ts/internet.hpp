@@ -23,6 +23,7 @@
 #include <experimental/__net_ts/ip/address_v6_iterator.hpp>
 #include <experimental/__net_ts/ip/address_v6_range.hpp>
 #include <experimental/__net_ts/ip/bad_address_cast.hpp>
+#include <experimental/__net_ts/ip/basic_connection_pool.hpp>
 #include <experimental/__net_ts/ip/basic_endpoint.hpp>
 #include <experimental/__net_ts/ip/basic_resolver_query.hpp>
 #include <experimental/__net_ts/ip/basic_resolver_entry.hpp>
@@ -16,5 +16,10 @@
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
 #include <experimental/__net_ts/io_context.hpp>
+#include <experimental/__net_ts/io_context_balancer.hpp>
+#include <experimental/__net_ts/async_mutex.hpp>
+#include <experimental/__net_ts/async_semaphore.hpp>
+#include <experimental/__net_ts/async_event.hpp>
+#include <experimental/__net_ts/channel.hpp>
 
 #endif // NET_TS_TS_IO_CONTEXT_HPP
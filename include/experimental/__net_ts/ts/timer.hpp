@@ -21,6 +21,9 @@
 #include <experimental/__net_ts/basic_waitable_timer.hpp>
 #include <experimental/__net_ts/system_timer.hpp>
 #include <experimental/__net_ts/steady_timer.hpp>
+#include <experimental/__net_ts/coarse_steady_timer.hpp>
+#include <experimental/__net_ts/periodic_timer.hpp>
+#include <experimental/__net_ts/idle_tracker.hpp>
 #include <experimental/__net_ts/high_resolution_timer.hpp>
 
 #endif // NET_TS_TS_TIMER_HPP
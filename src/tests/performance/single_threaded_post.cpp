@@ -0,0 +1,130 @@
+//
+// single_threaded_post.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Measures the cost of posting and running handlers, and of waiting on an
+// already expired timer, on an io_context that is run by a single thread. Build it three times to compare the configurations:
+//
+//   c++ -O2 -std=c++11 -I include -pthread single_threaded_post.cpp
+//   c++ -O2 -std=c++11 -I include -pthread -DUSE_UNSAFE_HINT
+//     single_threaded_post.cpp
+//   c++ -O2 -std=c++11 -I include -pthread
+//     -DNET_TS_DISABLE_IO_CONTEXT_THREADS single_threaded_post.cpp
+//
+// Each test is repeated and the fastest run is reported, as the slower runs
+// mostly measure interference from the rest of the system.
+
+#include <experimental/net>
+#include <chrono>
+#include <cstdio>
+
+namespace net = std::experimental::net;
+typedef std::chrono::steady_clock clock_type;
+
+#if defined(USE_UNSAFE_HINT)
+const int concurrency_hint = NET_TS_CONCURRENCY_HINT_UNSAFE;
+const char* configuration = "NET_TS_CONCURRENCY_HINT_UNSAFE";
+#elif defined(NET_TS_DISABLE_IO_CONTEXT_THREADS)
+const int concurrency_hint = 1;
+const char* configuration = "NET_TS_DISABLE_IO_CONTEXT_THREADS";
+#else
+const int concurrency_hint = 1;
+const char* configuration = "concurrency hint 1";
+#endif
+
+const int repetitions = 7;
+
+// Each handler posts the next, so that only one handler is queued at a time.
+struct chain
+{
+  net::io_context* io_context;
+  long* remaining;
+
+  void operator()()
+  {
+    if (--*remaining > 0)
+      net::post(*io_context, *this);
+  }
+};
+
+// Each handler starts the next wait on a timer that has already expired.
+struct timer_chain
+{
+  net::steady_timer* timer;
+  long* remaining;
+
+  void operator()(const std::error_code&)
+  {
+    if (--*remaining > 0)
+      timer->async_wait(*this);
+  }
+};
+
+struct counter
+{
+  long* count;
+  void operator()() { ++*count; }
+};
+
+double chained_posts(long n)
+{
+  net::io_context io_context(concurrency_hint);
+  long remaining = n;
+  net::post(io_context, chain{&io_context, &remaining});
+  clock_type::time_point start = clock_type::now();
+  io_context.run();
+  return std::chrono::duration<double, std::milli>(
+      clock_type::now() - start).count();
+}
+
+double queued_handlers(long n)
+{
+  net::io_context io_context(concurrency_hint);
+  long count = 0;
+  clock_type::time_point start = clock_type::now();
+  for (long i = 0; i < n; ++i)
+    net::post(io_context, counter{&count});
+  io_context.run();
+  return std::chrono::duration<double, std::milli>(
+      clock_type::now() - start).count();
+}
+
+double timer_waits(long n)
+{
+  net::io_context io_context(concurrency_hint);
+  net::steady_timer timer(io_context, net::steady_timer::time_point());
+  long remaining = n;
+  timer.async_wait(timer_chain{&timer, &remaining});
+  clock_type::time_point start = clock_type::now();
+  io_context.run();
+  return std::chrono::duration<double, std::milli>(
+      clock_type::now() - start).count();
+}
+
+template <typename Test>
+void report(const char* name, Test test, long n)
+{
+  double best = test(n);
+  for (int i = 1; i < repetitions; ++i)
+  {
+    double t = test(n);
+    if (t < best)
+      best = t;
+  }
+  std::printf("%-22s %8.1f ms  %6.1f ns/handler\n",
+      name, best, best * 1e6 / n);
+}
+
+int main()
+{
+  std::printf("%s\n", configuration);
+  report("chained posts", chained_posts, 5000000);
+  report("queued handlers", queued_handlers, 2000000);
+  report("timer waits", timer_waits, 100000);
+}
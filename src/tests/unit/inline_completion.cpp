@@ -0,0 +1,90 @@
+//
+// inline_completion.cpp
+// ~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2019 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Checks that a handler invoked inline from an initiating function may throw.
+// The exception must reach the caller of the initiating function, and the
+// operation must be freed exactly once. Build with a memory checker to catch
+// a double free:
+//
+//   c++ -std=c++11 -I include -pthread -fsanitize=address inline_completion.cpp
+
+#include <experimental/net>
+#include <cassert>
+#include <cstdio>
+#include <vector>
+
+namespace net = std::experimental::net;
+using net::ip::tcp;
+
+struct handler_exception {};
+
+int main()
+{
+  net::io_context io_context;
+  io_context.inline_completion(true);
+
+  tcp::acceptor acceptor(io_context,
+      tcp::endpoint(net::ip::address_v4::loopback(), 0));
+  tcp::socket client(io_context);
+  client.connect(acceptor.local_endpoint());
+  tcp::socket server(acceptor.accept());
+
+  const char data[] = "abc";
+  net::write(client, net::buffer(data));
+  tcp::socket second(io_context);
+  second.connect(acceptor.local_endpoint());
+
+  int invoked = 0;
+  int caught = 0;
+  net::post(io_context, [&]
+  {
+    // Data is already waiting, so the receive completes before
+    // async_receive returns.
+    char buf[sizeof(data)];
+    try
+    {
+      server.async_receive(net::buffer(buf),
+          [&](std::error_code ec, std::size_t n)
+          {
+            assert(!ec && n == sizeof(data));
+            ++invoked;
+            throw handler_exception();
+          });
+    }
+    catch (handler_exception&)
+    {
+      ++caught;
+    }
+
+    // A connection is already waiting, so the accept completes before
+    // async_accept returns.
+    try
+    {
+      acceptor.async_accept(
+          [&](std::error_code ec, tcp::socket)
+          {
+            assert(!ec);
+            ++invoked;
+            throw handler_exception();
+          });
+    }
+    catch (handler_exception&)
+    {
+      ++caught;
+    }
+  });
+
+  io_context.run();
+
+  std::printf("invoked %d, caught %d\n", invoked, caught);
+  assert(invoked == 2);
+  assert(caught == 2);
+  return 0;
+}